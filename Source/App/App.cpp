@@ -4,6 +4,8 @@
 #include "../IDGen.h"
 
 #include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_opengl3.h>
 
@@ -14,11 +16,22 @@
 #include "../NodeGraph/NodeGraphCompiler.h"
 #include "../NodeGraph/NodeGraphSerializer.h"
 #include "../NodeGraph/NodeGraphCommands.h"
+#include "../Render/TextureCompression.h"
 
+#include "../Util/BackgroundFileWriter.h"
 #include "../Util/FileDialog.h"
 
 // From IDGen.h
 std::atomic<UniqueID> IDGen::Allocator = 1;
+thread_local UniqueID IDGen::ProvisionalAllocator = 0;
+
+static constexpr double AUTOSAVE_INTERVAL = 30.0; // Seconds
+
+// Document is serialized on the UI thread, once that takes longer than a frame autosave waits for the input to go idle
+// but never longer than the max interval
+static constexpr double AUTOSAVE_FRAME_BUDGET = 1.0 / 60.0; // Seconds
+static constexpr double AUTOSAVE_IDLE_TIME = 2.0; // Seconds
+static constexpr double AUTOSAVE_MAX_INTERVAL = 300.0; // Seconds
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
@@ -98,6 +111,7 @@ App::App()
     m_Executor = Ptr<RenderPipelineExecutor>(new RenderPipelineExecutor{});
     m_Compiler = Ptr<NodeGraphCompiler>(new NodeGraphCompiler{});
     m_Serializer = Ptr<NodeGraphSerializer>(new NodeGraphSerializer{});
+    m_FileWriter = Ptr<BackgroundFileWriter>(new BackgroundFileWriter{});
 	m_ErrorHandler = Ptr<EditorErrorHandler>(new EditorErrorHandler{});
 
 	NewDocument();
@@ -105,6 +119,9 @@ App::App()
 
 App::~App()
 {
+    // Let the last autosave reach the disk
+    m_FileWriter = nullptr;
+
     FileDialog::Destroy();
 
     // Deinit imgui
@@ -126,6 +143,20 @@ inline std::string GetPathWithoutExtension(const std::string path)
     return "";
 }
 
+// Autosave never touches the document itself, it goes to a binary recovery file next to it that loads like any other document
+static std::string GetAutosavePath(const std::string& path)
+{
+	return GetPathWithoutExtension(path) + ".autosave" + NodeGraphSerializer::BINARY_EXTENSION;
+}
+
+static void RemoveAutosave(const std::string& path)
+{
+	const std::string autosavePath = GetAutosavePath(path);
+	std::error_code error;
+	std::filesystem::remove(autosavePath, error);
+	std::filesystem::remove(GetPathWithoutExtension(autosavePath) + ".json", error);
+}
+
 void App::Run()
 {
     // Render loop
@@ -135,6 +166,7 @@ void App::Run()
         glfwPollEvents();
 
 		ProcessRequests();
+		AutosaveDocument();
 
 		ImGui_ImplOpenGL3_NewFrame();
 		ImGui_ImplGlfw_NewFrame();
@@ -174,6 +206,7 @@ void App::RenderMenuBar()
 			if (ImGui::MenuItem("Load...")) LoadDocument();
 			if (ImGui::MenuItem("Save...", "Ctrl + S")) SaveDocument();
 			if (ImGui::MenuItem("Save As...")) SaveAsDocument();
+			if (ImGui::MenuItem("Convert text/binary...")) ConvertDocument();
 			ImGui::EndMenu();
 		}
 
@@ -184,6 +217,7 @@ void App::RenderMenuBar()
 				if(m_Mode == AppMode::Editor) m_Editor->GetCommandExecutor()->UndoCommand();
 				if(m_Mode == AppMode::CustomNode) m_CustomNodeEditor->GetCommandExecutor()->UndoCommand();
 			}
+			if (ImGui::MenuItem("Cook textures")) CookTextures();
 			ImGui::EndMenu();
 		}
 
@@ -277,6 +311,8 @@ void App::RenderFrame()
 
 void App::HandleInputAction(int key, int mods, int action)
 {
+	m_LastInputTime = glfwGetTime();
+
 	// TODO: Use IInputListeners
 	if (action == GLFW_PRESS)
 	{
@@ -361,6 +397,7 @@ void App::NewDocument()
 	
 	m_CurrentLoadedFile = "";
 	m_LastExecutedCommandCount = 0;
+	m_LastAutosavedCommandCount = 0;
 	AddRequest(AppRequest::ChangeModeRequest(AppMode::Editor));
 
 	m_CustomNodeList.clear();
@@ -379,6 +416,9 @@ void App::LoadDocument()
 
 		if (firstID)
 		{
+			// Graphs of custom nodes used by the document are needed for drawing right away
+			NodeGraphSerializer::LoadInstancedCustomNodeGraphs(*loadedNodeGraph);
+
 			m_Editor->Unload();
 
 			m_CustomNodeList.clear();
@@ -393,6 +433,7 @@ void App::LoadDocument()
 			m_NodeGraph = Ptr<NodeGraph>(loadedNodeGraph);
 			m_NodeGraph->RefreshNodes(m_VariablePool);
 			m_LastExecutedCommandCount = 0;
+			m_LastAutosavedCommandCount = 0;
 			AddRequest(AppRequest::ChangeModeRequest(AppMode::Editor));
 		}
 		else
@@ -419,14 +460,18 @@ void App::SaveDocument()
 	if (hasPath)
 	{
 		if (m_CustomNodeEditor) m_CustomNodeEditor->RewriteNode();
-		
+
+		// Autosave still in flight would recreate the recovery file after this save removes it
+		m_FileWriter->Wait();
 		m_Serializer->Serialize(path, *m_NodeGraph, m_VariablePool);
 
 		const std::string jsonDest = GetPathWithoutExtension(path) + ".json";
 		std::filesystem::copy("NodeEditor.json", jsonDest, std::filesystem::copy_options::overwrite_existing);
+		RemoveAutosave(path);
 
 		m_CurrentLoadedFile = path;
 		m_LastExecutedCommandCount = m_Editor->GetCommandExecutor()->GetExecutedCommandCount();
+		m_LastAutosavedCommandCount = m_LastExecutedCommandCount;
 	}
 }
 
@@ -437,13 +482,75 @@ void App::SaveAsDocument()
 	{
 		if (m_CustomNodeEditor) m_CustomNodeEditor->RewriteNode();
 
+		m_FileWriter->Wait();
 		m_Serializer->Serialize(path, *m_NodeGraph, m_VariablePool);
 
 		const std::string jsonDest = GetPathWithoutExtension(path) + ".json";
 		std::filesystem::copy("NodeEditor.json", jsonDest, std::filesystem::copy_options::overwrite_existing);
+		if (!m_CurrentLoadedFile.empty()) RemoveAutosave(m_CurrentLoadedFile);
+		RemoveAutosave(path);
+
 		m_CurrentLoadedFile = path;
 		m_LastExecutedCommandCount = m_Editor->GetCommandExecutor()->GetExecutedCommandCount();
+		m_LastAutosavedCommandCount = m_LastExecutedCommandCount;
+	}
+}
+
+void App::ConvertDocument()
+{
+	std::string path;
+	if (!FileDialog::OpenRenderNodeFile(path)) return;
+
+	// Both files share the node editor config next to them since only the extension differs
+	const std::string basePath = GetPathWithoutExtension(path);
+	const bool isBinary = path.substr(basePath.size()) == NodeGraphSerializer::BINARY_EXTENSION;
+	const std::string convertedPath = basePath + (isBinary ? NodeGraphSerializer::TEXT_EXTENSION : NodeGraphSerializer::BINARY_EXTENSION);
+
+	m_FileWriter->Wait();
+	if (m_Serializer->Convert(path, convertedPath))
+		m_Console.Log("[Convert] " + path + " -> " + convertedPath);
+	else
+		m_Console.Log("[Convert error] Failed to load " + path);
+}
+
+void App::AutosaveDocument()
+{
+	for (const std::string& failedPath : m_FileWriter->TakeFailedPaths())
+		m_Console.Log("[Autosave error] Failed to write " + failedPath);
+
+	// Custom node edits reach the document only when the node is rewritten, so autosave waits for the editor mode
+	if (m_Mode != AppMode::Editor || m_CurrentLoadedFile.empty()) return;
+
+	const double time = glfwGetTime();
+	const ImGuiIO& io = ImGui::GetIO();
+	if (ImGui::IsAnyMouseDown() || io.MouseDelta.x != 0.0f || io.MouseDelta.y != 0.0f) m_LastInputTime = time;
+
+	if (time - m_LastAutosaveTime < AUTOSAVE_INTERVAL) return;
+
+	const bool slowAutosave = m_LastAutosaveDuration > AUTOSAVE_FRAME_BUDGET;
+	if (slowAutosave && time - m_LastInputTime < AUTOSAVE_IDLE_TIME && time - m_LastAutosaveTime < AUTOSAVE_MAX_INTERVAL) return;
+	m_LastAutosaveTime = time;
+
+	// Document stays modified until it is saved, only the recovery file is brought up to date
+	const unsigned executedCommandCount = m_Editor->GetCommandExecutor()->GetExecutedCommandCount();
+	if (executedCommandCount == m_LastAutosavedCommandCount) return;
+
+	// Snapshot is the serialized document, only writing and flushing it is left to the worker
+	const std::string autosavePath = GetAutosavePath(m_CurrentLoadedFile);
+	std::vector<BackgroundFileWriter::File> files;
+	files.push_back({ autosavePath, m_Serializer->SerializeToMemory(autosavePath, *m_NodeGraph, m_VariablePool) });
+	m_LastAutosaveDuration = glfwGetTime() - time;
+
+	std::ifstream nodeEditorConfig{ "NodeEditor.json", std::ios::binary };
+	if (nodeEditorConfig)
+	{
+		std::stringstream nodeEditorConfigData;
+		nodeEditorConfigData << nodeEditorConfig.rdbuf();
+		files.push_back({ GetPathWithoutExtension(autosavePath) + ".json", nodeEditorConfigData.str() });
 	}
+
+	m_FileWriter->Write(std::move(files));
+	m_LastAutosavedCommandCount = executedCommandCount;
 }
 
 void App::CompileAndRun()
@@ -471,6 +578,34 @@ void App::CompileAndRun()
 	}
 }
 
+void App::CookTextures()
+{
+	unsigned cookedCount = 0;
+	const auto fn = [this, &cookedCount](VariableID id, const Variable& variable) {
+		if (variable.Type != VariableType::Texture) return;
+
+		const TextureData& texData = variable.Get<TextureData>();
+		if (texData.Path.empty() || !IsCompressedFormat(texData.Format)) return;
+
+		const std::string cookedPath = TextureCompression::GetCookedPath(texData.Path, texData.Format);
+		if (TextureCompression::IsCookUpToDate(texData.Path, cookedPath)) return;
+
+		std::string errorMessage;
+		if (TextureCompression::CookTexture(texData.Path, cookedPath, texData.Format, errorMessage))
+		{
+			m_Console.Log("[Cook] " + cookedPath);
+			cookedCount++;
+		}
+		else
+		{
+			m_Console.Log("[Cook error] " + errorMessage);
+		}
+	};
+	m_VariablePool.ForEachVariable(fn);
+
+	m_Console.Log("[Cook] Cooked " + std::to_string(cookedCount) + " textures");
+}
+
 std::string App::GetWindowTitle()
 {
 	std::string windowTitle = "Render Nodes";
@@ -19,6 +19,7 @@ class NodeGraphSerializer;
 class NodeGraphCommandExecutor;
 class NodeGraph;
 class CustomEditorNode;
+class BackgroundFileWriter;
 
 struct GLFWwindow;
 
@@ -102,8 +103,11 @@ private:
 	void LoadDocument();
 	void SaveDocument();
 	void SaveAsDocument();
+	void ConvertDocument();
+	void AutosaveDocument();
 
 	void CompileAndRun();
+	void CookTextures();
 
 private:
 	void RenderMenuBar();
@@ -124,6 +128,10 @@ private:
 	// Save/Load
 	std::string m_CurrentLoadedFile = "";
 	unsigned m_LastExecutedCommandCount = 0;
+	unsigned m_LastAutosavedCommandCount = 0;
+	double m_LastAutosaveTime = 0.0;
+	double m_LastAutosaveDuration = 0.0;
+	double m_LastInputTime = 0.0;
 
 	// Input
 	std::vector<IInputListener*> m_InputListeners;
@@ -134,6 +142,7 @@ private:
 	Ptr<NodeGraphCompiler> m_Compiler;
 	Ptr<RenderPipelineExecutor> m_Executor;
 	Ptr<NodeGraphSerializer> m_Serializer;
+	Ptr<BackgroundFileWriter> m_FileWriter;
 
 	Ptr<EditorErrorHandler> m_ErrorHandler;
 	Ptr<RenderPipelineEditor> m_Editor;
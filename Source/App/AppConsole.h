@@ -9,6 +9,8 @@ public:
 	void Log(const std::string& msg);
 
 	void Draw();
+
+	const std::string& GetText() const { return m_TextBuffer; }
 private:
 	std::string m_TextBuffer;
 };
\ No newline at end of file
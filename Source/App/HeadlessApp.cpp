@@ -0,0 +1,45 @@
+#include "App.h"
+
+#include "../Common.h"
+#include "../IDGen.h"
+
+#include "../Editor/EditorErrorHandler.h"
+#include "../Editor/RenderPipelineEditor.h"
+#include "../Execution/RenderPipelineExecutor.h"
+#include "../NodeGraph/NodeGraphCompiler.h"
+#include "../NodeGraph/NodeGraphSerializer.h"
+#include "../Util/BackgroundFileWriter.h"
+
+// App for the headless target, it replaces App.cpp there
+// There is no window, GL context or ImGui frame, only state the graph code reaches through App::Get()
+
+// From IDGen.h
+std::atomic<UniqueID> IDGen::Allocator = 1;
+thread_local UniqueID IDGen::ProvisionalAllocator = 0;
+
+App* App::s_Instance = nullptr;
+
+App::App():
+	m_Width(0),
+	m_Height(0),
+	m_Window(nullptr)
+{
+	m_ErrorHandler = Ptr<EditorErrorHandler>(new EditorErrorHandler{});
+}
+
+App::~App()
+{
+
+}
+
+void App::AddCustomNode(CustomEditorNode* node)
+{
+	m_CustomNodeList.push_back(Ptr<CustomEditorNode>(node));
+}
+
+// There is no editor to open custom nodes in
+void App::OpenCustomNode(const std::string& /*name*/) {}
+
+// Input never comes without a window
+void App::SubscribeToInput(IInputListener* /*listener*/) {}
+void App::UnsubscribeToInput(IInputListener* /*listener*/) {}
@@ -365,12 +365,19 @@ void NewNodeContextMenu::RebuildMenus()
 	EditorWidgets::Menu getMenu{ "Get" };
 	AddIfCompatible<GetMeshEditorNode>(getMenu, "Mesh", &m_NewNode, nodePin);
 	AddIfCompatible<GetCubeMeshEditorNode>(getMenu, "Cube mesh", &m_NewNode, nodePin);
+	AddIfCompatible<GetSkinPaletteEditorNode>(getMenu, "Skin palette", &m_NewNode, nodePin);
+	AddIfCompatible<GetObjectTransformEditorNode>(getMenu, "Object transform", &m_NewNode, nodePin);
 	m_CreationMenu.AddMenu(getMenu);
 
 	EditorWidgets::Menu renderMenu{ "Render" };
 	AddIfCompatible<ClearRenderTargetEditorNode>(renderMenu, "Clear framebuffer", &m_NewNode, nodePin);
 	AddIfCompatible<PresentTextureEditorNode>(renderMenu, "Present texture", &m_NewNode, nodePin);
 	AddIfCompatible<DrawMeshEditorNode>(renderMenu, "Draw mesh", &m_NewNode, nodePin);
+	AddIfCompatible<DispatchComputeEditorNode>(renderMenu, "Dispatch compute", &m_NewNode, nodePin);
+	AddIfCompatible<CullSceneEditorNode>(renderMenu, "Cull scene", &m_NewNode, nodePin);
+	AddIfCompatible<DrawSceneIndirectEditorNode>(renderMenu, "Draw scene indirect", &m_NewNode, nodePin);
+	AddIfCompatible<SetSceneNodeTransformEditorNode>(renderMenu, "Set scene node transform", &m_NewNode, nodePin);
+	AddIfCompatible<AnimateSceneEditorNode>(renderMenu, "Animate scene", &m_NewNode, nodePin);
 	m_CreationMenu.AddMenu(renderMenu);
 
 	if (!m_CustomNodeEditor)
@@ -386,6 +393,7 @@ void NewNodeContextMenu::RebuildMenus()
 	AddIfCompatible<RenderStateEditorNode>(m_CreationMenu, "RenderState", &m_NewNode, nodePin);
 	AddIfCompatible<IfEditorNode>(m_CreationMenu, "If condition", &m_NewNode, nodePin);
 	AddIfCompatible<ForEachSceneObjectEditorNode>(m_CreationMenu, "For each scene object", &m_NewNode, nodePin);
+	AddIfCompatible<ForEachVisibleSceneObjectEditorNode>(m_CreationMenu, "For each visible scene object", &m_NewNode, nodePin);
 	AddIfCompatible<PrintEditorNode>(m_CreationMenu, "Print", &m_NewNode, nodePin);
 
 	const auto& customNodes = *App::Get()->GetCustomNodes();
@@ -78,6 +78,10 @@ namespace EditorWidgets
 			break;
 		case VariableType::Shader:
 			break;
+		case VariableType::Sampler:
+			break;
+		case VariableType::Buffer:
+			break;
 		default:
 			NOT_IMPLEMENTED;
 			break;
@@ -133,6 +137,9 @@ namespace EditorWidgets
 			ImGui::InputInt("Height", &value.Height);
 			ImGui::Checkbox("Framebuffer", &value.Framebuffer);
 			ImGui::Checkbox("Depth stencil", &value.DepthStencil);
+			ComboBox("Format", *reinterpret_cast<uint32_t*>(&value.Format), 0, EnumToInt(TextureFormat::Count) - 1, [](uint32_t index) {
+				return ToString((TextureFormat)index);
+			});
 
 			if (ImGui::Button("Select file..."))
 			{
@@ -148,6 +155,8 @@ namespace EditorWidgets
 		case VariableType::Scene:
 		{
 			auto& value = variable.Get<SceneData>();
+			ImGui::Checkbox("Optimize meshes", &value.OptimizeMeshes);
+			ImGui::Checkbox("GPU driven", &value.GPUDriven);
 			if (ImGui::Button("Select file..."))
 			{
 				std::string path{};
@@ -173,6 +182,22 @@ namespace EditorWidgets
 			}
 			ImGui::Text(value.Path.c_str());
 		} break;
+		case VariableType::Sampler:
+		{
+			auto& value = variable.Get<SamplerData>();
+			ComboBox("Filter", *reinterpret_cast<uint32_t*>(&value.Filter), 0, EnumToInt(SamplerFilter::Count) - 1, [](uint32_t index) {
+				return ToString((SamplerFilter)index);
+			});
+			ComboBox("Wrap", *reinterpret_cast<uint32_t*>(&value.Wrap), 0, EnumToInt(SamplerWrap::Count) - 1, [](uint32_t index) {
+				return ToString((SamplerWrap)index);
+			});
+		} break;
+		case VariableType::Buffer:
+		{
+			auto& value = variable.Get<BufferData>();
+			ImGui::InputScalar("Byte size", ImGuiDataType_U32, &value.ByteSize);
+			ImGui::InputScalar("Stride", ImGuiDataType_U32, &value.Stride);
+		} break;
 		default:
 			NOT_IMPLEMENTED;
 			break;
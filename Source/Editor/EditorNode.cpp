@@ -320,7 +320,7 @@ void BindTableEditorNode::RenderContent()
 {
     ImGui::Text("Binding name");
 
-    if (m_TypeValue == "Texture")
+    if (m_TypeValue == "Texture" || m_TypeValue == "Sampler" || m_TypeValue == "Buffer")
     {
         ImGui::SetNextItemWidth(ImGui::ConstantSize(50.0f));
         ImGui::DragInt("", &m_InputInt, 1, 0, 31);
@@ -333,6 +333,18 @@ void BindTableEditorNode::RenderContent()
     
     ImGui::Dummy({ ImGui::ConstantSize(10.0f), ImGui::ConstantSize(10.0f) });
 
+    PinType pinType = PinType::Texture;
+
+    if (m_TypeValue == "Texture") pinType = PinType::Texture;
+    else if (m_TypeValue == "Sampler") pinType = PinType::Sampler;
+    else if (m_TypeValue == "Buffer") pinType = PinType::Buffer;
+    else if (m_TypeValue == "Float") pinType = PinType::Float;
+    else if (m_TypeValue == "Float2") pinType = PinType::Float2;
+    else if (m_TypeValue == "Float3") pinType = PinType::Float3;
+    else if (m_TypeValue == "Float4") pinType = PinType::Float4;
+    else if (m_TypeValue == "Float4x4") pinType = PinType::Float4x4;
+    else NOT_IMPLEMENTED;
+
     bool canAdd = true;
     if (m_InputName.empty())
     {
@@ -343,7 +355,9 @@ void BindTableEditorNode::RenderContent()
     {
         for (const auto& customPin : GetCustomPins())
         {
-            if (customPin.Label == m_InputName)
+            // Only a sampler can share its name with a texture, it is bound to the same slot
+            const bool textureSamplerPair = (customPin.Type == PinType::Texture && pinType == PinType::Sampler) || (customPin.Type == PinType::Sampler && pinType == PinType::Texture);
+            if (customPin.Label == m_InputName && !textureSamplerPair)
             {
                 canAdd = false;
                 break;
@@ -362,16 +376,6 @@ void BindTableEditorNode::RenderContent()
     EditorNodePin pinToAdd;
     if (ImGui::Button("Add binding"))
     {
-        PinType pinType = PinType::Texture;
-
-        if (m_TypeValue == "Texture") pinType = PinType::Texture;
-        else if (m_TypeValue == "Float") pinType = PinType::Float;
-        else if (m_TypeValue == "Float2") pinType = PinType::Float2;
-        else if (m_TypeValue == "Float3") pinType = PinType::Float3;
-        else if (m_TypeValue == "Float4") pinType = PinType::Float4;
-        else if (m_TypeValue == "Float4x4") pinType = PinType::Float4x4;
-        else NOT_IMPLEMENTED;
-
         AddCustomPin(EditorNodePin::CreateInputPin(m_InputName, pinType));
 
         m_InputInt = 0;
@@ -395,6 +399,7 @@ void GetMeshEditorNode::RenderContent()
     ImGui::Checkbox("Texcoords", &m_TexcoordBit);
     ImGui::Checkbox("Normals", &m_NormalBit);
     ImGui::Checkbox("Tangents", &m_TangentBit);
+    ImGui::Checkbox("Joints and weights", &m_SkinningBit);
 }
 
 void GetCubeMeshEditorNode::RenderContent()
@@ -558,8 +563,17 @@ CustomEditorNode::CustomEditorNode(NodeGraph* parentGraph, const std::string& na
     }
 }
 
+NodeGraph* CustomEditorNode::GetNodeGraph() const
+{
+    if (!m_NodeGraph->ResolveDeferredLoad())
+        App::Get()->GetConsole().Log("Custom node " + m_Name + " is corrupted");
+    return m_NodeGraph.get();
+}
+
 void CustomEditorNode::RegeneratePins()
 {
+    NodeGraph* nodeGraph = GetNodeGraph();
+
     // Detect pins to add
     std::vector<PinEditorNode*> pinsToAdd{};
     const auto fn = [this, &pinsToAdd](EditorNode* node)
@@ -583,13 +597,13 @@ void CustomEditorNode::RegeneratePins()
             }
         }
     };
-    m_NodeGraph->ForEachNode(fn);
+    nodeGraph->ForEachNode(fn);
 
     // Detect pins to delete
     std::vector <PinID> toDelete{};
     for (const auto& pin : GetCustomPins())
 	{
-        if (!m_NodeGraph->ContainsNode(pin.LinkedNode))
+        if (!nodeGraph->ContainsNode(pin.LinkedNode))
         {
             toDelete.push_back(pin.ID);
         }
@@ -617,122 +631,3 @@ void CustomEditorNode::RegeneratePins()
 		AddCustomPin(pinToAdd);
     }
 }
-
-std::vector<EditorNodePin> DeprecatedEditorNode::GetDeprecatedPins(EditorNodeType nodeType)
-{
-	std::vector<EditorNodePin> pins{};
-	switch (nodeType)
-	{
-    case EditorNodeType::Deprecated:
-        break;
-	case EditorNodeType::DEPRECATED_VarFloat:
-		pins.push_back(EditorNodePin::CreateOutputPin("Float", PinType::Float));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-		break;
-	case EditorNodeType::DEPRECATED_VarFloat2:
-		pins.push_back(EditorNodePin::CreateOutputPin("Float2", PinType::Float2));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-		break;
-	case EditorNodeType::DEPRECATED_VarFloat3:
-		pins.push_back(EditorNodePin::CreateOutputPin("Float3", PinType::Float3));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-		break;
-	case EditorNodeType::DEPRECATED_VarFloat4:
-		pins.push_back(EditorNodePin::CreateOutputPin("Float4", PinType::Float4));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-		break;
-	case EditorNodeType::DEPRECATED_VarFloat4x4:
-		pins.push_back(EditorNodePin::CreateOutputPin("Float4x4", PinType::Float4x4));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-		break;
-	case EditorNodeType::DEPRECATED_VarBool:
-		pins.push_back(EditorNodePin::CreateOutputPin("Bool", PinType::Bool));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-		break;
-	case EditorNodeType::DEPRECATED_VarInt:
-		pins.push_back(EditorNodePin::CreateOutputPin("Int", PinType::Int));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-		break;
-	case EditorNodeType::DEPRECATED_GetScene:
-		pins.push_back(EditorNodePin::CreateOutputPin("Scene", PinType::Scene));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-		break;
-	case EditorNodeType::DEPRECATED_GetTexture:
-		pins.push_back(EditorNodePin::CreateOutputPin("Texture", PinType::Texture));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-		break;
-	case EditorNodeType::DEPRECATED_GetShader:
-		pins.push_back(EditorNodePin::CreateOutputPin("Shader", PinType::Shader));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-		break;
-    case EditorNodeType::DEPRECATED_LoadScene:
-        pins.push_back(EditorNodePin::CreateInputPin("", PinType::Execution));
-        pins.push_back(EditorNodePin::CreateOutputPin("", PinType::Execution));
-        pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-        break;
-	case EditorNodeType::DEPRECATED_LoadTexture:
-		pins.push_back(EditorNodePin::CreateInputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateOutputPin("", PinType::Execution));
-        pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-        break;
-	case EditorNodeType::DEPRECATED_LoadShader:
-		pins.push_back(EditorNodePin::CreateInputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateOutputPin("", PinType::Execution));
-        pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-        break;
-    case EditorNodeType::DEPRECATED_AsignBool:
-		pins.push_back(EditorNodePin::CreateInputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateOutputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateInputPin("Value", PinType::Bool));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-        break;
-	case EditorNodeType::DEPRECATED_AsignInt:
-		pins.push_back(EditorNodePin::CreateInputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateOutputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateInputPin("Value", PinType::Int));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-        break;
-	case EditorNodeType::DEPRECATED_AsignFloat:
-		pins.push_back(EditorNodePin::CreateInputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateOutputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateInputPin("Value", PinType::Float));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-        break;
-	case EditorNodeType::DEPRECATED_AsignFloat2:
-		pins.push_back(EditorNodePin::CreateInputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateOutputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateInputPin("Value", PinType::Float2));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-        break;
-	case EditorNodeType::DEPRECATED_AsignFloat3:
-		pins.push_back(EditorNodePin::CreateInputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateOutputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateInputPin("Value", PinType::Float3));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-        break;
-	case EditorNodeType::DEPRECATED_AsignFloat4:
-		pins.push_back(EditorNodePin::CreateInputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateOutputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateInputPin("Value", PinType::Float4));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-        break;
-	case EditorNodeType::DEPRECATED_AsignFloat4x4:
-		pins.push_back(EditorNodePin::CreateInputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateOutputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateInputPin("Value", PinType::Float4x4));
-		pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-        break;
-    case EditorNodeType::DEPRECATED_CreateTexture:
-		pins.push_back(EditorNodePin::CreateInputPin("", PinType::Execution));
-		pins.push_back(EditorNodePin::CreateOutputPin("", PinType::Execution));
-        pins.push_back(EditorNodePin::CreateConstantInputPin("Name", PinType::String));
-        pins.push_back(EditorNodePin::CreateConstantInputPin("Width", PinType::Int));
-        pins.push_back(EditorNodePin::CreateConstantInputPin("Height", PinType::Int));
-        pins.push_back(EditorNodePin::CreateConstantInputPin("Framebuffer", PinType::Bool));
-        pins.push_back(EditorNodePin::CreateConstantInputPin("DepthStencil", PinType::Bool));
-        break;
-	default:
-		NOT_IMPLEMENTED;
-	}
-	return pins;
-}
@@ -92,6 +92,14 @@ enum class EditorNodeType
     Variable,
     AsignVariable,
     Deprecated,
+    DispatchCompute,
+    CullScene,
+    DrawSceneIndirect,
+    ForEachVisibleSceneObject,
+    SetSceneNodeTransform,
+    AnimateScene,
+    GetSkinPalette,
+    GetObjectTransform,
 };
 
 // DO NOT CHANGE ORDER OF VALUES
@@ -119,6 +127,7 @@ enum class PinType
     SceneObject,
     Scene,
     Any,
+    Sampler,
     
     Count
 };
@@ -146,6 +155,7 @@ static const std::string ToString(PinType pinType)
     case PinType::SceneObject: return "SceneObject";
     case PinType::Scene: return "Scene";
     case PinType::Any: return "Any";
+    case PinType::Sampler: return "Sampler";
     default: NOT_IMPLEMENTED;
     }
     return "<unknown>";
@@ -174,6 +184,7 @@ static ImColor GetPinColor(PinType type)
     case PinType::SceneObject: return ImColor(255, 153, 51);
     case PinType::Scene: return ImColor(240, 120, 51);
     case PinType::Any: return ImColor(100, 100, 100);
+    case PinType::Sampler: return ImColor(120, 40, 160);
     default:
         NOT_IMPLEMENTED;
         break;
@@ -196,6 +207,8 @@ inline PinType ToPinType(VariableType variableType)
     case VariableType::Shader:  return PinType::Shader;
     case VariableType::Texture: return PinType::Texture;
     case VariableType::Scene:   return PinType::Scene;
+    case VariableType::Sampler: return PinType::Sampler;
+    case VariableType::Buffer:  return PinType::Buffer;
     default:
         NOT_IMPLEMENTED;
     }
@@ -325,15 +338,11 @@ class DeprecatedEditorNode : public EditorNode
 {
     SERIALIZEABLE_EDITOR_NODE();
 public:
+    // Placeholder for a node type that was removed, it has no pins
     DeprecatedEditorNode(EditorNodeType deprecatedType):
         EditorNode("Deprecated", EditorNodeType::Deprecated),
         m_DeprecatedType(deprecatedType)
-    {
-        for (const auto& pin : GetDeprecatedPins(deprecatedType))
-        {
-            AddPin(pin);
-        }
-    }
+    {}
 
     EditorNode* Clone() const override
     {
@@ -342,7 +351,4 @@ public:
 
 private:
     EditorNodeType m_DeprecatedType;
-
-private:
-    std::vector<EditorNodePin> GetDeprecatedPins(EditorNodeType nodeType);
 };
\ No newline at end of file
@@ -630,6 +630,7 @@ public:
 	bool GetTexcoordBit() const { return m_TexcoordBit; }
 	bool GetNormalBit() const { return m_NormalBit; }
 	bool GetTangentBit() const { return m_TangentBit; }
+	bool GetSkinningBit() const { return m_SkinningBit; }
 
 	EditorNode* Clone() const override
 	{
@@ -638,6 +639,7 @@ public:
 		node->m_TexcoordBit = m_TexcoordBit;
 		node->m_NormalBit = m_NormalBit;
 		node->m_TangentBit = m_TangentBit;
+		node->m_SkinningBit = m_SkinningBit;
 		return node;
 	}
 
@@ -648,6 +650,53 @@ private:
 	unsigned m_SceneObjectPin;
 
 	bool m_PositionBit, m_TexcoordBit, m_NormalBit, m_TangentBit;
+	bool m_SkinningBit = false;
+};
+
+class GetSkinPaletteEditorNode : public EvaluationEditorNode
+{
+	SERIALIZEABLE_EDITOR_NODE();
+
+public:
+	GetSkinPaletteEditorNode():
+		EvaluationEditorNode("Get skin palette", EditorNodeType::GetSkinPalette)
+	{
+		m_SceneObjectPin = AddPin(EditorNodePin::CreateInputPin("Scene object", PinType::SceneObject));
+		AddPin(EditorNodePin::CreateOutputPin("Palette", PinType::Buffer));
+	}
+
+	const EditorNodePin& GetSceneObjectPin() const { return GetPins()[m_SceneObjectPin]; }
+
+	EditorNode* Clone() const override
+	{
+		return new GetSkinPaletteEditorNode();
+	}
+
+private:
+	unsigned m_SceneObjectPin;
+};
+
+class GetObjectTransformEditorNode : public EvaluationEditorNode
+{
+	SERIALIZEABLE_EDITOR_NODE();
+
+public:
+	GetObjectTransformEditorNode():
+		EvaluationEditorNode("Get object transform", EditorNodeType::GetObjectTransform)
+	{
+		m_SceneObjectPin = AddPin(EditorNodePin::CreateInputPin("Scene object", PinType::SceneObject));
+		AddPin(EditorNodePin::CreateOutputPin("Transform", PinType::Float4x4));
+	}
+
+	const EditorNodePin& GetSceneObjectPin() const { return GetPins()[m_SceneObjectPin]; }
+
+	EditorNode* Clone() const override
+	{
+		return new GetObjectTransformEditorNode();
+	}
+
+private:
+	unsigned m_SceneObjectPin;
 };
 
 class GetCubeMeshEditorNode : public EvaluationEditorNode
@@ -675,7 +724,7 @@ class BindTableEditorNode : public EvaluationEditorNode
 public:
 	BindTableEditorNode():
 		EvaluationEditorNode("Bind table", EditorNodeType::BindTable),
-		m_TypeSelection("Bind table type selector " + std::to_string(GetID()), m_TypeValue, { "Texture", "Float", "Float2", "Float3", "Float4", "Float4x4" })
+		m_TypeSelection("Bind table type selector " + std::to_string(GetID()), m_TypeValue, { "Texture", "Sampler", "Buffer", "Float", "Float2", "Float3", "Float4", "Float4x4" })
 
 	{
 		AddPin(EditorNodePin::CreateOutputPin("Table", PinType::BindTable));
@@ -100,7 +100,8 @@ public:
 		return 0;
 	}
 
-	NodeGraph* GetNodeGraph() const { return m_NodeGraph.get(); }
+	// Reads the definition graph if it was deferred when the document was loaded
+	NodeGraph* GetNodeGraph() const;
 
 	void RegeneratePins();
 
@@ -363,6 +364,158 @@ private:
 	unsigned m_RenderStatePin;
 };
 
+class DispatchComputeEditorNode : public ExecutionEditorNode
+{
+	SERIALIZEABLE_EDITOR_NODE();
+public:
+	DispatchComputeEditorNode():
+		ExecutionEditorNode("Dispatch compute", EditorNodeType::DispatchCompute)
+	{
+		m_ShaderPin = AddPin(EditorNodePin::CreateInputPin("Shader", PinType::Shader));
+		m_GroupCountXPin = AddPin(CreateGroupCountPin("Groups X"));
+		m_GroupCountYPin = AddPin(CreateGroupCountPin("Groups Y"));
+		m_GroupCountZPin = AddPin(CreateGroupCountPin("Groups Z"));
+		m_BindTablePin = AddPin(EditorNodePin::CreateInputPin("BindTable", PinType::BindTable));
+	}
+
+	EditorNode* Clone() const override
+	{
+		return new DispatchComputeEditorNode{};
+	}
+
+	const EditorNodePin& GetShaderPin() const { return GetPins()[m_ShaderPin]; }
+	const EditorNodePin& GetGroupCountXPin() const { return GetPins()[m_GroupCountXPin]; }
+	const EditorNodePin& GetGroupCountYPin() const { return GetPins()[m_GroupCountYPin]; }
+	const EditorNodePin& GetGroupCountZPin() const { return GetPins()[m_GroupCountZPin]; }
+	const EditorNodePin& GetBindTablePin() const { return GetPins()[m_BindTablePin]; }
+
+private:
+	static EditorNodePin CreateGroupCountPin(const std::string& label)
+	{
+		EditorNodePin pin = EditorNodePin::CreateConstantInputPin(label, PinType::Int);
+		pin.ConstantValue.I = 1;
+		return pin;
+	}
+
+private:
+	unsigned m_ShaderPin;
+	unsigned m_GroupCountXPin;
+	unsigned m_GroupCountYPin;
+	unsigned m_GroupCountZPin;
+	unsigned m_BindTablePin;
+};
+
+class CullSceneEditorNode : public ExecutionEditorNode
+{
+	SERIALIZEABLE_EDITOR_NODE();
+public:
+	CullSceneEditorNode():
+		ExecutionEditorNode("Cull scene", EditorNodeType::CullScene)
+	{
+		m_ScenePin = AddPin(EditorNodePin::CreateInputPin("Scene", PinType::Scene));
+		m_ViewProjectionPin = AddPin(EditorNodePin::CreateInputPin("ViewProjection", PinType::Float4x4));
+	}
+
+	EditorNode* Clone() const override
+	{
+		return new CullSceneEditorNode{};
+	}
+
+	const EditorNodePin& GetScenePin() const { return GetPins()[m_ScenePin]; }
+	const EditorNodePin& GetViewProjectionPin() const { return GetPins()[m_ViewProjectionPin]; }
+
+private:
+	unsigned m_ScenePin;
+	unsigned m_ViewProjectionPin;
+};
+
+class SetSceneNodeTransformEditorNode : public ExecutionEditorNode
+{
+	SERIALIZEABLE_EDITOR_NODE();
+public:
+	SetSceneNodeTransformEditorNode():
+		ExecutionEditorNode("Set scene node transform", EditorNodeType::SetSceneNodeTransform)
+	{
+		m_ScenePin = AddPin(EditorNodePin::CreateInputPin("Scene", PinType::Scene));
+		m_NodeNamePin = AddPin(EditorNodePin::CreateInputPin("Node name", PinType::String));
+		m_TransformPin = AddPin(EditorNodePin::CreateInputPin("Local transform", PinType::Float4x4));
+	}
+
+	EditorNode* Clone() const override
+	{
+		return new SetSceneNodeTransformEditorNode{};
+	}
+
+	const EditorNodePin& GetScenePin() const { return GetPins()[m_ScenePin]; }
+	const EditorNodePin& GetNodeNamePin() const { return GetPins()[m_NodeNamePin]; }
+	const EditorNodePin& GetTransformPin() const { return GetPins()[m_TransformPin]; }
+
+private:
+	unsigned m_ScenePin;
+	unsigned m_NodeNamePin;
+	unsigned m_TransformPin;
+};
+
+class AnimateSceneEditorNode : public ExecutionEditorNode
+{
+	SERIALIZEABLE_EDITOR_NODE();
+public:
+	AnimateSceneEditorNode():
+		ExecutionEditorNode("Animate scene", EditorNodeType::AnimateScene)
+	{
+		m_ScenePin = AddPin(EditorNodePin::CreateInputPin("Scene", PinType::Scene));
+		m_AnimationPin = AddPin(EditorNodePin::CreateConstantInputPin("Animation", PinType::Int));
+		m_TimePin = AddPin(EditorNodePin::CreateInputPin("Time", PinType::Float));
+	}
+
+	EditorNode* Clone() const override
+	{
+		return new AnimateSceneEditorNode{};
+	}
+
+	const EditorNodePin& GetScenePin() const { return GetPins()[m_ScenePin]; }
+	const EditorNodePin& GetAnimationPin() const { return GetPins()[m_AnimationPin]; }
+	const EditorNodePin& GetTimePin() const { return GetPins()[m_TimePin]; }
+
+private:
+	unsigned m_ScenePin;
+	unsigned m_AnimationPin;
+	unsigned m_TimePin;
+};
+
+class DrawSceneIndirectEditorNode : public ExecutionEditorNode
+{
+	SERIALIZEABLE_EDITOR_NODE();
+public:
+	DrawSceneIndirectEditorNode():
+		ExecutionEditorNode("Draw scene indirect", EditorNodeType::DrawSceneIndirect)
+	{
+		m_FramebufferPin = AddPin(EditorNodePin::CreateInputPin("Framebuffer", PinType::Texture));
+		m_ShaderPin = AddPin(EditorNodePin::CreateInputPin("Shader", PinType::Shader));
+		m_ScenePin = AddPin(EditorNodePin::CreateInputPin("Scene", PinType::Scene));
+		m_BindTablePin = AddPin(EditorNodePin::CreateInputPin("BindTable", PinType::BindTable));
+		m_RenderStatePin = AddPin(EditorNodePin::CreateInputPin("RenderState", PinType::RenderState));
+	}
+
+	EditorNode* Clone() const override
+	{
+		return new DrawSceneIndirectEditorNode{};
+	}
+
+	const EditorNodePin& GetFrameBufferPin() const { return GetPins()[m_FramebufferPin]; }
+	const EditorNodePin& GetShaderPin() const { return GetPins()[m_ShaderPin]; }
+	const EditorNodePin& GetScenePin() const { return GetPins()[m_ScenePin]; }
+	const EditorNodePin& GetBindTablePin() const { return GetPins()[m_BindTablePin]; }
+	const EditorNodePin& GetRenderStatePin() const { return GetPins()[m_RenderStatePin]; }
+
+private:
+	unsigned m_FramebufferPin;
+	unsigned m_ShaderPin;
+	unsigned m_ScenePin;
+	unsigned m_BindTablePin;
+	unsigned m_RenderStatePin;
+};
+
 class ForEachSceneObjectEditorNode : public ExecutionEditorNode
 {
 	SERIALIZEABLE_EDITOR_NODE();
@@ -388,4 +541,34 @@ private:
 	unsigned m_SceneObjectPin;
 	unsigned m_LoopPin;
 	unsigned m_ScenePin;
+};
+
+class ForEachVisibleSceneObjectEditorNode : public ExecutionEditorNode
+{
+	SERIALIZEABLE_EDITOR_NODE();
+public:
+	ForEachVisibleSceneObjectEditorNode():
+		ExecutionEditorNode("For each visible scene object", EditorNodeType::ForEachVisibleSceneObject)
+	{
+		m_LoopPin = AddPin(EditorNodePin::CreateOutputPin("Loop", PinType::Execution));
+		m_ScenePin = AddPin(EditorNodePin::CreateInputPin("Scene", PinType::Scene));
+		m_ViewProjectionPin = AddPin(EditorNodePin::CreateInputPin("ViewProjection", PinType::Float4x4));
+		m_SceneObjectPin = AddPin(EditorNodePin::CreateOutputPin("Scene object[*]", PinType::SceneObject));
+	}
+
+	EditorNode* Clone() const override
+	{
+		return new ForEachVisibleSceneObjectEditorNode{};
+	}
+
+	const EditorNodePin& GetLoopPin() const { return GetPins()[m_LoopPin]; }
+	const EditorNodePin& GetScenePin() const { return GetPins()[m_ScenePin]; }
+	const EditorNodePin& GetViewProjectionPin() const { return GetPins()[m_ViewProjectionPin]; }
+	const EditorNodePin& GetSceneObjectPin() const { return GetPins()[m_SceneObjectPin]; }
+
+private:
+	unsigned m_SceneObjectPin;
+	unsigned m_LoopPin;
+	unsigned m_ScenePin;
+	unsigned m_ViewProjectionPin;
 };
\ No newline at end of file
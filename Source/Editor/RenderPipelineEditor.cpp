@@ -122,9 +122,8 @@ void RenderPipelineEditor::LoadNodePositions()
     const auto fn = [&nodePositions](EditorNode* node)
     {
         const NodeID nodeID = node->GetID();
-        ImVec2 nodePosition{0.0f, 0.0f};
-        try { nodePosition = nodePositions.at(nodeID); } catch (const std::out_of_range&) {}
-        ImNode::SetNodePosition(nodeID, nodePosition);
+        const auto it = nodePositions.find(nodeID);
+        ImNode::SetNodePosition(nodeID, it != nodePositions.end() ? it->second : ImVec2{0.0f, 0.0f});
     };
     m_NodeGraph->ForEachNode(fn);
 
@@ -141,7 +140,8 @@ void RenderPipelineEditor::SaveNodePositions()
 
     ImNode::SetCurrentEditor(m_EditorContext);
 
-    std::unordered_map<NodeID, ImVec2> nodePositions;
+    IDMap<ImVec2> nodePositions;
+    nodePositions.reserve(m_NodeGraph->GetNodeCount());
 
     const auto fn = [&nodePositions](EditorNode* node)
     {
@@ -149,7 +149,7 @@ void RenderPipelineEditor::SaveNodePositions()
         nodePositions[nodeID] = ImNode::GetNodePosition(nodeID);
     };
     m_NodeGraph->ForEachNode(fn);
-    m_NodeGraph->SetNodePositions(nodePositions);
+    m_NodeGraph->SetNodePositions(std::move(nodePositions));
 
     ImNode::SetCurrentEditor(nullptr);
 }
@@ -166,8 +166,8 @@ void RenderPipelineEditor::UpdateEditor()
         {
             if (startPinID && endPinID)
             {
-                auto startPin = m_NodeGraph->GetPinByID(startPinID.Get());
-                auto endPin = m_NodeGraph->GetPinByID(endPinID.Get());
+                auto startPin = m_NodeGraph->GetPinByID((PinID) startPinID.Get());
+                auto endPin = m_NodeGraph->GetPinByID((PinID) endPinID.Get());
 
                 // Make sure start is always output pin
                 if (startPin.IsInput)
@@ -192,7 +192,7 @@ void RenderPipelineEditor::UpdateEditor()
         {
             if (ImNode::AcceptNewItem())
             {
-                m_NewNodeMenu->Open(pin.Get());
+                m_NewNodeMenu->Open((PinID) pin.Get());
             }
         }
     }
@@ -204,21 +204,21 @@ void RenderPipelineEditor::UpdateEditor()
         {
             if (ImNode::AcceptDeletedItem())
             {
-                m_CommandExecutor->ExecuteCommand(new RemoveLinkNodeGraphCommand{ link.Get() });
+                m_CommandExecutor->ExecuteCommand(new RemoveLinkNodeGraphCommand{ (LinkID) link.Get() });
             }
         }
     }
     ImNode::EndDelete();
 
-    if (ImNode::ShowNodeContextMenu(&node)) m_NodeMenu->Open(node.Get());
-    else if (ImNode::ShowPinContextMenu(&pin)) m_PinMenu->Open(pin.Get());
-    else if (ImNode::ShowLinkContextMenu(&link)) m_LinkMenu->Open(link.Get());
+    if (ImNode::ShowNodeContextMenu(&node)) m_NodeMenu->Open((NodeID) node.Get());
+    else if (ImNode::ShowPinContextMenu(&pin)) m_PinMenu->Open((PinID) pin.Get());
+    else if (ImNode::ShowLinkContextMenu(&link)) m_LinkMenu->Open((LinkID) link.Get());
     else if (ImNode::ShowBackgroundContextMenu()) m_NewNodeMenu->Open(0);
 
     const ImNode::NodeId doubleClickedNode = ImNode::GetDoubleClickedNode();
     if (doubleClickedNode)
     {
-        const NodeID nodeID = doubleClickedNode.Get();
+        const NodeID nodeID = (NodeID) doubleClickedNode.Get();
         EditorNode* editorNode = m_NodeGraph->GetNodeByID(nodeID);
         if (editorNode->GetType() == EditorNodeType::Custom)
         {
@@ -8,6 +8,7 @@
 #include "../Render/Texture.h"
 #include "../Render/Shader.h"
 #include "../Render/Buffer.h"
+#include "../Render/Sampler.h"
 #include "ExecutorScene.h"
 #include "../NodeGraph/VariablePool.h"
 
@@ -35,22 +36,32 @@ struct ExecutorRenderResources
 	std::unordered_map<VariableID, Ptr<Mesh>> Meshes;
 	std::unordered_map<VariableID, Ptr<Shader>> Shaders;
 	std::unordered_map<VariableID, Ptr<Scene>> Scenes;
+	std::unordered_map<VariableID, Ptr<Sampler>> Samplers;
+
+	// Render targets that live only within a frame share storage from this pool
+	std::vector<Ptr<Texture>> TransientTexturePool;
+	std::unordered_map<VariableID, Texture*> TransientTextures;
 
 	template<typename T, ExecutorStaticResource staticResource>  T GetStaticResource();
 	template<> Mesh* GetStaticResource<Mesh*, ExecutorStaticResource::CubeMesh>() { return Meshes[VariablePool::ID_CubeMesh].get(); }
 
 	template<typename T> T GetResource(VariableID id);
-	template<> Texture* GetResource(VariableID id) { return Textures[id].get(); }
+	template<> Texture* GetResource(VariableID id)
+	{
+		const auto it = TransientTextures.find(id);
+		return it != TransientTextures.end() ? it->second : Textures[id].get();
+	}
 	template<> Buffer* GetResource(VariableID id) { return Buffers[id].get(); }
 	template<> Mesh* GetResource(VariableID id) { return Meshes[id].get(); }
 	template<> Shader* GetResource(VariableID id) { return Shaders[id].get(); }
 	template<> Scene* GetResource(VariableID id) { return Scenes[id].get(); }
+	template<> Sampler* GetResource(VariableID id) { return Samplers[id].get(); }
 };
 
 struct ExecutorIterators
 {
 	using IteratorType = std::variant<
-		SceneObject*
+		SceneObject
 	>;
 
 	std::unordered_map<PinID, IteratorType> Data{};
@@ -73,6 +84,14 @@ struct ExecutorInputState
 
 class ExecutorNode;
 
+// Frame local render target, uses are execution steps of the OnUpdate path
+struct TransientTextureLifetime
+{
+	VariableID Texture = 0;
+	unsigned FirstUse = 0;
+	unsigned LastUse = 0;
+};
+
 struct ExecuteContext
 {
 	Texture* RenderTarget = nullptr;
@@ -81,7 +100,7 @@ struct ExecuteContext
 	ExecutorRenderResources RenderResources;
 	ExecutorInputState InputState;
 	
-	std::unordered_map<ExecutorNode*, NodeID> EditorLinks;
+	std::vector<TransientTextureLifetime> TransientTextures;
 	
 	bool Failure = false;
 	NodeID FailedNode = 0;
@@ -98,5 +117,13 @@ struct CompiledPipeline
 
 	VariablePool VariablePool;
 
-	std::unordered_map<ExecutorNode*, NodeID> EditorLinks;
+	// Render targets whose content doesn't have to survive between frames
+	std::vector<TransientTextureLifetime> TransientTextures;
+};
+
+// Executor and value nodes created so far, the difference around a compile is the size of the compiled pipeline
+struct CompiledNodeCounters
+{
+	static inline unsigned ExecutorNodes = 0;
+	static inline unsigned ValueNodes = 0;
 };
@@ -69,9 +69,102 @@ namespace
 			GL_CALL(glEnableVertexAttribArray(nextAttribArray++));
 		}
 
+		if (vertexBits.Skinning)
+		{
+			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, mesh->Joints->Handle));
+			GL_CALL(glVertexAttribIPointer(nextAttribArray, 4, GL_UNSIGNED_SHORT, 0, (void*)0));
+			GL_CALL(glEnableVertexAttribArray(nextAttribArray++));
+
+			GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, mesh->Weights->Handle));
+			GL_CALL(glVertexAttribPointer(nextAttribArray, 4, GL_FLOAT, GL_FALSE, 0, (void*)0));
+			GL_CALL(glEnableVertexAttribArray(nextAttribArray++));
+		}
+
 		return vao;
 	}
 
+	// Fixed layout so one shader can be used for every object of the scene
+	unsigned CreateSceneVAO(SceneDrawData* drawData)
+	{
+		unsigned vao;
+		GL_CALL(glGenVertexArrays(1, &vao));
+		GL_CALL(glBindVertexArray(vao));
+
+		GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, drawData->Geometry.Positions->Handle));
+		GL_CALL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0));
+		GL_CALL(glEnableVertexAttribArray(0));
+
+		GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, drawData->Geometry.Texcoords->Handle));
+		GL_CALL(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, (void*)0));
+		GL_CALL(glEnableVertexAttribArray(1));
+
+		GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, drawData->Geometry.Normals->Handle));
+		GL_CALL(glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, (void*)0));
+		GL_CALL(glEnableVertexAttribArray(2));
+
+		GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, drawData->Geometry.Tangents->Handle));
+		GL_CALL(glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, 0, (void*)0));
+		GL_CALL(glEnableVertexAttribArray(3));
+
+		GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, drawData->ObjectIndices->Handle));
+		GL_CALL(glVertexAttribIPointer(SceneDrawData::ObjectIndexAttribute, 1, GL_UNSIGNED_INT, 0, (void*)0));
+		GL_CALL(glVertexAttribDivisor(SceneDrawData::ObjectIndexAttribute, 1));
+		GL_CALL(glEnableVertexAttribArray(SceneDrawData::ObjectIndexAttribute));
+
+		GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawData->Geometry.Indices->Handle));
+
+		GL_CALL(glBindVertexArray(0));
+		GL_CALL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+		GL_CALL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+
+		return vao;
+	}
+
+	static constexpr unsigned CullingGroupSize = 64;
+
+	const char* CullingShaderSource = R"(
+// #start COMPUTE
+layout(local_size_x = 64) in;
+
+struct DrawCommand
+{
+	uint Count;
+	uint InstanceCount;
+	uint FirstIndex;
+	uint BaseVertex;
+	uint BaseInstance;
+};
+
+struct ObjectData
+{
+	mat4 ModelTransform;
+	vec4 BoundingSphere;
+};
+
+layout(std430, binding = 0) readonly buffer Objects { ObjectData objects[]; };
+layout(std430, binding = 1) readonly buffer DrawCommands { DrawCommand drawCommands[]; };
+layout(std430, binding = 2) writeonly buffer VisibleDrawCommands { DrawCommand visibleDrawCommands[]; };
+layout(std430, binding = 3) buffer VisibleCount { uint visibleCount; };
+
+uniform vec4 FrustumPlanes[6];
+uniform uint ObjectCount;
+
+void main()
+{
+	uint objectIndex = gl_GlobalInvocationID.x;
+	if (objectIndex >= ObjectCount) return;
+
+	vec4 sphere = objects[objectIndex].BoundingSphere;
+	for (int i = 0; i < 6; i++)
+	{
+		if (dot(FrustumPlanes[i].xyz, sphere.xyz) + FrustumPlanes[i].w < -sphere.w) return;
+	}
+
+	uint visibleIndex = atomicAdd(visibleCount, 1);
+	visibleDrawCommands[visibleIndex] = drawCommands[objectIndex];
+}
+)";
+
 	bool GetUniformIndex(Shader* shader, const std::string& name, unsigned& uniformIndex)
 	{
 		uniformIndex = glGetUniformLocation(shader->Handle, name.c_str());
@@ -102,6 +195,38 @@ namespace
 			}
 		}
 
+		for (const auto& binding : bindTable->Samplers)
+		{
+			Sampler* sampler = binding.Value.get() ? binding.Value->GetValue(context) : (Sampler*) nullptr;
+			if (!sampler) continue;
+
+			int textureSlot = std::stoi(binding.Name);
+			if (textureSlot >= 0 && textureSlot < 32)
+			{
+				GL_CALL(glBindSampler(textureSlot, sampler->Handle));
+			}
+			else
+			{
+				Warning("TableBind", "Invalid sampler binding " + binding.Name + ". Valid bindings are in range [0,31]");
+			}
+		}
+
+		for (const auto& binding : bindTable->Buffers)
+		{
+			Buffer* buffer = binding.Value.get() ? binding.Value->GetValue(context) : (Buffer*) nullptr;
+			if (!buffer) continue;
+
+			int bufferSlot = std::stoi(binding.Name);
+			if (bufferSlot >= 0 && bufferSlot < 32)
+			{
+				GL_CALL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bufferSlot, buffer->Handle));
+			}
+			else
+			{
+				Warning("TableBind", "Invalid buffer binding " + binding.Name + ". Valid bindings are in range [0,31]");
+			}
+		}
+
 		for (const auto& binding : bindTable->Floats)
 		{
 			const float value = binding.Value.get() ? binding.Value->GetValue(context) : 0.0f;
@@ -192,6 +317,26 @@ namespace
 				GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
 			}
 		}
+
+		for (unsigned i = 0; i < bindTable->Samplers.size(); i++)
+		{
+			const auto& binding = bindTable->Samplers[i];
+			int textureSlot = std::stoi(binding.Name);
+			if (textureSlot >= 0 && textureSlot < 32)
+			{
+				GL_CALL(glBindSampler(textureSlot, 0));
+			}
+		}
+
+		for (unsigned i = 0; i < bindTable->Buffers.size(); i++)
+		{
+			const auto& binding = bindTable->Buffers[i];
+			int bufferSlot = std::stoi(binding.Name);
+			if (bufferSlot >= 0 && bufferSlot < 32)
+			{
+				GL_CALL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bufferSlot, 0));
+			}
+		}
 	}
 
 	void RenderStateBind(const RenderState& renderState)
@@ -303,6 +448,20 @@ void DrawMeshExecutorNode::Execute(ExecuteContext& context)
 		return;
 	}
 
+	if (shader->IsCompute)
+	{
+		Failure("DrawMeshExecutorNode", "Compute shader can't be used for drawing, use dispatch compute node");
+		context.Failure = true;
+		return;
+	}
+
+	if (m_MeshNode->GetExtraInfo().MeshVertexBits.Skinning && (!mesh->Joints || !mesh->Weights))
+	{
+		Failure("DrawMeshExecutorNode", "Mesh isn't skinned, disable joints and weights on get mesh node");
+		context.Failure = true;
+		return;
+	}
+
 	if (!m_VAO) m_VAO = CreateVAO(mesh, m_MeshNode->GetExtraInfo());
 
 	// Framebuffer
@@ -326,7 +485,7 @@ void DrawMeshExecutorNode::Execute(ExecuteContext& context)
 	if (m_BindTable) bindTable = m_BindTable->GetValue(context);
 	TableBind(context, shader, bindTable);
 
-	GL_CALL(glDrawElements(GL_TRIANGLES, mesh->NumPrimitives, GL_UNSIGNED_INT, 0));
+	GL_CALL(glDrawElements(GL_TRIANGLES, mesh->NumPrimitives, GetGLIndexFormat(mesh->IndexType), 0));
 
 	// ~Bindings
 	TableUnbind(shader, bindTable);
@@ -342,12 +501,301 @@ void DrawMeshExecutorNode::Execute(ExecuteContext& context)
 	GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, 0));
 }
 
+void DispatchComputeExecutorNode::Execute(ExecuteContext& context)
+{
+	if (!m_ShaderNode || !m_GroupCountX || !m_GroupCountY || !m_GroupCountZ)
+	{
+		Failure("DispatchComputeExecutorNode", "Missing inputs");
+		context.Failure = true;
+		return;
+	}
+
+	Shader* shader = m_ShaderNode->GetValue(context);
+	if (!shader)
+	{
+		Failure("DispatchComputeExecutorNode", "Invalid inputs");
+		context.Failure = true;
+		return;
+	}
+
+	if (!shader->IsCompute)
+	{
+		Failure("DispatchComputeExecutorNode", "Input shader isn't a compute shader");
+		context.Failure = true;
+		return;
+	}
+
+	const int groupCountX = m_GroupCountX->GetValue(context);
+	const int groupCountY = m_GroupCountY->GetValue(context);
+	const int groupCountZ = m_GroupCountZ->GetValue(context);
+	if (groupCountX <= 0 || groupCountY <= 0 || groupCountZ <= 0)
+	{
+		Warning("DispatchComputeExecutorNode", "Group count is zero or negative, dispatch skipped");
+		return;
+	}
+
+	// Shader
+	GL_CALL(glUseProgram(shader->Handle));
+
+	// Bindings
+	BindTable* bindTable = nullptr;
+	if (m_BindTable) bindTable = m_BindTable->GetValue(context);
+	TableBind(context, shader, bindTable);
+
+	GL_CALL(glDispatchCompute((unsigned)groupCountX, (unsigned)groupCountY, (unsigned)groupCountZ));
+
+	// Make compute writes visible to everything that can consume a buffer or an image after this node
+	GL_CALL(glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT));
+
+	// ~Bindings
+	TableUnbind(shader, bindTable);
+
+	// ~Shader
+	GL_CALL(glUseProgram(0));
+}
+
+void CullSceneExecutorNode::Execute(ExecuteContext& context)
+{
+	if (!m_SceneNode || !m_ViewProjectionNode)
+	{
+		Failure("CullSceneExecutorNode", "Missing inputs");
+		context.Failure = true;
+		return;
+	}
+
+	Scene* scene = m_SceneNode->GetValue(context);
+	if (!scene)
+	{
+		Failure("CullSceneExecutorNode", "Invalid inputs");
+		context.Failure = true;
+		return;
+	}
+
+	scene->UpdateTransforms();
+
+	SceneDrawData* drawData = scene->DrawData.get();
+	if (!drawData)
+	{
+		Failure("CullSceneExecutorNode", "Scene isn't loaded as GPU driven");
+		context.Failure = true;
+		return;
+	}
+
+	if (!m_CullingShader)
+	{
+		m_CullingShader = Shader::CompileSource(CullingShaderSource);
+		if (!m_CullingShader)
+		{
+			Failure("CullSceneExecutorNode", "Failed to compile culling shader");
+			context.Failure = true;
+			return;
+		}
+	}
+
+	if (drawData->NumObjects == 0) return;
+
+	const Frustum frustum = Bounds::ExtractFrustum(m_ViewProjectionNode->GetValue(context));
+
+	// Commands behind the visible ones must not draw anything
+	const uint32_t zero = 0;
+	GL_CALL(glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawData->VisibleDrawCommands->Handle));
+	GL_CALL(glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero));
+	GL_CALL(glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawData->VisibleCount->Handle));
+	GL_CALL(glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero));
+	GL_CALL(glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0));
+
+	const unsigned shader = m_CullingShader->Handle;
+	GL_CALL(glUseProgram(shader));
+	GL_CALL(glUniform4fv(glGetUniformLocation(shader, "FrustumPlanes"), 6, glm::value_ptr(frustum.Planes[0])));
+	GL_CALL(glUniform1ui(glGetUniformLocation(shader, "ObjectCount"), drawData->NumObjects));
+
+	GL_CALL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, drawData->Objects->Handle));
+	GL_CALL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, drawData->DrawCommands->Handle));
+	GL_CALL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, drawData->VisibleDrawCommands->Handle));
+	GL_CALL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, drawData->VisibleCount->Handle));
+
+	GL_CALL(glDispatchCompute((drawData->NumObjects + CullingGroupSize - 1) / CullingGroupSize, 1, 1));
+	GL_CALL(glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT));
+
+	for (unsigned i = 0; i < 4; i++)
+	{
+		GL_CALL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, 0));
+	}
+	GL_CALL(glUseProgram(0));
+}
+
+DrawSceneIndirectExecutorNode::~DrawSceneIndirectExecutorNode()
+{
+	if (m_VAO) GL_CALL(glDeleteVertexArrays(1, &m_VAO));
+}
+
+void DrawSceneIndirectExecutorNode::Execute(ExecuteContext& context)
+{
+	if (!m_FramebufferNode || !m_ShaderNode || !m_SceneNode)
+	{
+		Failure("DrawSceneIndirectExecutorNode", "Missing inputs");
+		context.Failure = true;
+		return;
+	}
+
+	Texture* framebuffer = m_FramebufferNode->GetValue(context);
+	Shader* shader = m_ShaderNode->GetValue(context);
+	Scene* scene = m_SceneNode->GetValue(context);
+
+	if (!framebuffer || !shader || !scene)
+	{
+		Failure("DrawSceneIndirectExecutorNode", "Invalid inputs");
+		context.Failure = true;
+		return;
+	}
+
+	if ((framebuffer->Flags & TF_Framebuffer) == 0)
+	{
+		Failure("DrawSceneIndirectExecutorNode", "Input framebuffer texture isn't created with framebuffer flag");
+		context.Failure = true;
+		return;
+	}
+
+	if (shader->IsCompute)
+	{
+		Failure("DrawSceneIndirectExecutorNode", "Compute shader can't be used for drawing, use dispatch compute node");
+		context.Failure = true;
+		return;
+	}
+
+	scene->UpdateTransforms();
+
+	SceneDrawData* drawData = scene->DrawData.get();
+	if (!drawData)
+	{
+		Failure("DrawSceneIndirectExecutorNode", "Scene isn't loaded as GPU driven");
+		context.Failure = true;
+		return;
+	}
+
+	if (drawData->NumObjects == 0) return;
+
+	if (m_VAODrawData != drawData)
+	{
+		if (m_VAO) GL_CALL(glDeleteVertexArrays(1, &m_VAO));
+		m_VAO = CreateSceneVAO(drawData);
+		m_VAODrawData = drawData;
+	}
+
+	// Framebuffer
+	GL_CALL(glViewport(0, 0, framebuffer->Width, framebuffer->Height));
+	GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->FrameBufferHandle));
+
+	// Render state
+	RenderState renderState;
+	if (m_RenderState) renderState = m_RenderState->GetValue(context);
+	RenderStateBind(renderState);
+
+	// Shader
+	GL_CALL(glUseProgram(shader->Handle));
+
+	// Scene
+	GL_CALL(glBindVertexArray(m_VAO));
+	GL_CALL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SceneDrawData::ObjectsBinding, drawData->Objects->Handle));
+	GL_CALL(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawData->VisibleDrawCommands->Handle));
+
+	// Bindings
+	BindTable* bindTable = nullptr;
+	if (m_BindTable) bindTable = m_BindTable->GetValue(context);
+	TableBind(context, shader, bindTable);
+
+	GL_CALL(glMultiDrawElementsIndirect(GL_TRIANGLES, GetGLIndexFormat(drawData->Geometry.IndexType), (void*)0, drawData->NumObjects, 0));
+
+	// ~Bindings
+	TableUnbind(shader, bindTable);
+
+	// ~Scene
+	GL_CALL(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0));
+	GL_CALL(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SceneDrawData::ObjectsBinding, 0));
+	GL_CALL(glBindVertexArray(0));
+
+	// ~Shader
+	GL_CALL(glUseProgram(0));
+
+	// ~Framebuffer
+	GL_CALL(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+void SetSceneNodeTransformExecutorNode::Execute(ExecuteContext& context)
+{
+	Scene* scene = m_SceneNode->GetValue(context);
+	if (!scene)
+	{
+		Failure("SetSceneNodeTransformExecutorNode", "Invalid inputs");
+		context.Failure = true;
+		return;
+	}
+
+	const std::string nodeName = m_NodeNameNode->GetValue(context);
+	const uint32_t node = scene->FindNode(nodeName);
+	if (node == Scene::InvalidNode)
+	{
+		Warning("SetSceneNodeTransformExecutorNode", "Scene has no node named " + nodeName);
+		return;
+	}
+
+	// World transforms are recomputed by the next pass that reads them or at the end of the frame
+	scene->SetNodeLocalTransform(node, m_TransformNode->GetValue(context));
+}
+
+void AnimateSceneExecutorNode::Execute(ExecuteContext& context)
+{
+	Scene* scene = m_SceneNode->GetValue(context);
+	if (!scene)
+	{
+		Failure("AnimateSceneExecutorNode", "Invalid inputs");
+		context.Failure = true;
+		return;
+	}
+
+	const int animation = m_AnimationNode->GetValue(context);
+	if (animation < 0 || animation >= (int)scene->Animations.size())
+	{
+		Warning("AnimateSceneExecutorNode", "Scene has no animation with index " + std::to_string(animation));
+		return;
+	}
+
+	scene->Animations[animation].Apply(m_TimeNode->GetValue(context), *scene);
+}
+
 void ForEachSceneObjectExecutorNode::Execute(ExecuteContext& context)
 {
 	Scene* scene = m_SceneNode->GetValue(context);
-	for (SceneObject& sceneObject : scene->SceneObjects)
+	auto& iterator = context.Iterators.Data[m_IteratorPin];
+	const uint32_t objectCount = scene->GetObjectCount();
+	for (uint32_t objectIndex = 0; objectIndex < objectCount; objectIndex++)
+	{
+		iterator = SceneObject{ scene, objectIndex };
+		m_LoopExecutorNode->ExecuteNodePath(context);
+	}
+}
+
+void ForEachVisibleSceneObjectExecutorNode::Execute(ExecuteContext& context)
+{
+	Scene* scene = m_SceneNode->GetValue(context);
+	if (!scene)
+	{
+		Failure("ForEachVisibleSceneObjectExecutorNode", "Invalid inputs");
+		context.Failure = true;
+		return;
+	}
+
+	scene->UpdateTransforms();
+
+	const Frustum frustum = Bounds::ExtractFrustum(m_ViewProjectionNode->GetValue(context));
+
+	m_VisibleObjects.clear();
+	scene->BVH.Query(frustum, m_VisibleObjects);
+
+	auto& iterator = context.Iterators.Data[m_IteratorPin];
+	for (const uint32_t objectIndex : m_VisibleObjects)
 	{
-		context.Iterators.Data[m_IteratorPin] = &sceneObject;
+		iterator = SceneObject{ scene, objectIndex };
 		m_LoopExecutorNode->ExecuteNodePath(context);
 	}
 }
@@ -9,6 +9,7 @@
 class ExecutorNode
 {
 public:
+	ExecutorNode() { CompiledNodeCounters::ExecutorNodes++; }
 	virtual ~ExecutorNode() {}
 
 	virtual void Execute(ExecuteContext& context) = 0;
@@ -26,13 +27,18 @@ public:
 
 			if (context.Failure)
 			{
-				context.FailedNode = context.EditorLinks.count(currentNode) > 0 ? context.EditorLinks[currentNode] : 0;
+				context.FailedNode = currentNode->m_EditorNode;
 				break;
 			}
 			currentNode = currentNode->GetNextNode();
 		}
 	}
 
+	void SetEditorNode(NodeID editorNode)
+	{
+		m_EditorNode = editorNode;
+	}
+
 	void SetNextNode(ExecutorNode* node)
 	{
 		m_NextNode = Ptr<ExecutorNode>(node);
@@ -45,6 +51,9 @@ public:
 
 private:
 	Ptr<ExecutorNode> m_NextNode;
+
+	// Editor node this was compiled from, reported when execution fails
+	NodeID m_EditorNode = 0;
 };
 
 class EmptyExecutorNode : public ExecutorNode
@@ -195,6 +204,94 @@ private:
 	Ptr<RenderStateValueNode> m_RenderState;
 };
 
+class DispatchComputeExecutorNode : public ExecutorNode
+{
+public:
+	DispatchComputeExecutorNode(ShaderValueNode* shaderNode, IntValueNode* groupCountX, IntValueNode* groupCountY, IntValueNode* groupCountZ, BindTableValueNode* bindTable):
+		m_ShaderNode(shaderNode),
+		m_GroupCountX(groupCountX),
+		m_GroupCountY(groupCountY),
+		m_GroupCountZ(groupCountZ),
+		m_BindTable(bindTable) {}
+
+	void Execute(ExecuteContext& context) override;
+private:
+	Ptr<ShaderValueNode> m_ShaderNode;
+	Ptr<IntValueNode> m_GroupCountX;
+	Ptr<IntValueNode> m_GroupCountY;
+	Ptr<IntValueNode> m_GroupCountZ;
+	Ptr<BindTableValueNode> m_BindTable;
+};
+
+class CullSceneExecutorNode : public ExecutorNode
+{
+public:
+	CullSceneExecutorNode(SceneValueNode* sceneNode, Float4x4ValueNode* viewProjectionNode):
+		m_SceneNode(sceneNode),
+		m_ViewProjectionNode(viewProjectionNode) {}
+
+	void Execute(ExecuteContext& context) override;
+private:
+	Ptr<Shader> m_CullingShader;
+
+	Ptr<SceneValueNode> m_SceneNode;
+	Ptr<Float4x4ValueNode> m_ViewProjectionNode;
+};
+
+class DrawSceneIndirectExecutorNode : public ExecutorNode
+{
+public:
+	DrawSceneIndirectExecutorNode(TextureValueNode* framebufferNode, ShaderValueNode* shaderNode, SceneValueNode* sceneNode, BindTableValueNode* bindTable, RenderStateValueNode* renderState):
+		m_FramebufferNode(framebufferNode),
+		m_ShaderNode(shaderNode),
+		m_SceneNode(sceneNode),
+		m_BindTable(bindTable),
+		m_RenderState(renderState) {}
+
+	~DrawSceneIndirectExecutorNode();
+
+	void Execute(ExecuteContext& context) override;
+private:
+	unsigned m_VAO = 0;
+	SceneDrawData* m_VAODrawData = nullptr;
+
+	Ptr<TextureValueNode> m_FramebufferNode;
+	Ptr<ShaderValueNode> m_ShaderNode;
+	Ptr<SceneValueNode> m_SceneNode;
+	Ptr<BindTableValueNode> m_BindTable;
+	Ptr<RenderStateValueNode> m_RenderState;
+};
+
+class SetSceneNodeTransformExecutorNode : public ExecutorNode
+{
+public:
+	SetSceneNodeTransformExecutorNode(SceneValueNode* sceneNode, StringValueNode* nodeNameNode, Float4x4ValueNode* transformNode):
+		m_SceneNode(sceneNode),
+		m_NodeNameNode(nodeNameNode),
+		m_TransformNode(transformNode) {}
+
+	void Execute(ExecuteContext& context) override;
+private:
+	Ptr<SceneValueNode> m_SceneNode;
+	Ptr<StringValueNode> m_NodeNameNode;
+	Ptr<Float4x4ValueNode> m_TransformNode;
+};
+
+class AnimateSceneExecutorNode : public ExecutorNode
+{
+public:
+	AnimateSceneExecutorNode(SceneValueNode* sceneNode, IntValueNode* animationNode, FloatValueNode* timeNode):
+		m_SceneNode(sceneNode),
+		m_AnimationNode(animationNode),
+		m_TimeNode(timeNode) {}
+
+	void Execute(ExecuteContext& context) override;
+private:
+	Ptr<SceneValueNode> m_SceneNode;
+	Ptr<IntValueNode> m_AnimationNode;
+	Ptr<FloatValueNode> m_TimeNode;
+};
+
 class ForEachSceneObjectExecutorNode : public ExecutorNode
 {
 public:
@@ -210,4 +307,25 @@ private:
 	PinID m_IteratorPin;
 	Ptr<SceneValueNode> m_SceneNode;
 	Ptr<ExecutorNode> m_LoopExecutorNode;
+};
+
+class ForEachVisibleSceneObjectExecutorNode : public ExecutorNode
+{
+public:
+	ForEachVisibleSceneObjectExecutorNode(SceneValueNode* sceneNode, Float4x4ValueNode* viewProjectionNode, PinID iteratorPin, ExecutorNode* loopExecutorNode) :
+		m_IteratorPin(iteratorPin),
+		m_SceneNode(sceneNode),
+		m_ViewProjectionNode(viewProjectionNode),
+		m_LoopExecutorNode(loopExecutorNode)
+	{ }
+
+	void Execute(ExecuteContext& context) override;
+
+private:
+	PinID m_IteratorPin;
+	Ptr<SceneValueNode> m_SceneNode;
+	Ptr<Float4x4ValueNode> m_ViewProjectionNode;
+	Ptr<ExecutorNode> m_LoopExecutorNode;
+
+	std::vector<uint32_t> m_VisibleObjects;
 };
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "ExecutorScene.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <execution>
+#include <xmmintrin.h>
+
+namespace
+{
+	// world = parent * local with parent columns already in registers, they are loaded once per run of siblings
+	void MultiplyTransform(const __m128 parentColumns[4], const Float4x4& local, Float4x4& world)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			const float* localColumn = &local[column][0];
+			__m128 result = _mm_mul_ps(parentColumns[0], _mm_set1_ps(localColumn[0]));
+			result = _mm_add_ps(result, _mm_mul_ps(parentColumns[1], _mm_set1_ps(localColumn[1])));
+			result = _mm_add_ps(result, _mm_mul_ps(parentColumns[2], _mm_set1_ps(localColumn[2])));
+			result = _mm_add_ps(result, _mm_mul_ps(parentColumns[3], _mm_set1_ps(localColumn[3])));
+			_mm_storeu_ps(&world[column][0], result);
+		}
+	}
+
+	void UpdatePalette(Skin& skin, const std::vector<Float4x4>& nodeWorldTransforms)
+	{
+		for (size_t i = 0; i < skin.JointNodes.size(); i++)
+			skin.PaletteData[i] = glm::transpose(nodeWorldTransforms[skin.JointNodes[i]] * skin.InverseBindMatrices[i]);
+	}
+
+	SceneObjectGPUData GetObjectGPUData(const Scene& scene, uint32_t objectIndex)
+	{
+		const BoundingSphere& worldBounds = scene.WorldBounds[objectIndex];
+
+		SceneObjectGPUData data;
+		data.ModelTransform = glm::transpose(scene.Transforms[objectIndex]);
+		data.BoundingSphere = Float4{ worldBounds.Center, worldBounds.Radius };
+		return data;
+	}
+}
+
+uint32_t Scene::AddNode(const std::string& name, uint32_t parent, const Float4x4& localTransform)
+{
+	ASSERT(parent == InvalidNode || parent < NodeParents.size());
+
+	const uint32_t node = (uint32_t)NodeParents.size();
+	NodeParents.push_back(parent);
+	NodeLocalTransforms.push_back(localTransform);
+	NodeWorldTransforms.push_back(parent == InvalidNode ? localTransform : NodeWorldTransforms[parent] * localTransform);
+	NodeDirty.push_back(0);
+
+	if (!name.empty()) NodeNames.emplace(name, node);
+
+	return node;
+}
+
+uint32_t Scene::FindNode(const std::string& name) const
+{
+	const auto it = NodeNames.find(name);
+	return it != NodeNames.end() ? it->second : InvalidNode;
+}
+
+void Scene::SetNodeLocalTransform(uint32_t node, const Float4x4& localTransform)
+{
+	NodeLocalTransforms[node] = localTransform;
+	NodeDirty[node] = 1;
+	HasDirtyNodes = true;
+}
+
+uint32_t Scene::AddSkin(const std::vector<uint32_t>& jointNodes, const std::vector<Float4x4>& inverseBindMatrices)
+{
+	ASSERT(!jointNodes.empty() && jointNodes.size() == inverseBindMatrices.size());
+
+	Skin skin{};
+	skin.JointNodes = jointNodes;
+	skin.InverseBindMatrices = inverseBindMatrices;
+	skin.PaletteData.resize(jointNodes.size());
+	UpdatePalette(skin, NodeWorldTransforms);
+
+	const unsigned paletteSize = (unsigned)(skin.PaletteData.size() * sizeof(Float4x4));
+	skin.Palette = Buffer::Create(BufferType::Storage, paletteSize, sizeof(Float4x4), BF_None, skin.PaletteData.data());
+
+	Skins.push_back(std::move(skin));
+	return (uint32_t)Skins.size() - 1;
+}
+
+SceneObjectHandle Scene::AddObject(uint32_t node, uint32_t meshIndex, uint32_t materialIndex, uint32_t skinIndex)
+{
+	const uint32_t objectIndex = GetObjectCount();
+	const SceneObjectHandle handle = (SceneObjectHandle)HandleToIndex.size();
+
+	NodeIndices.push_back(node);
+	Transforms.push_back(NodeWorldTransforms[node]);
+	MeshIndices.push_back(meshIndex);
+	MaterialIndices.push_back(materialIndex);
+	SkinIndices.push_back(skinIndex);
+	Handles.push_back(handle);
+	HandleToIndex.push_back(objectIndex);
+	WorldBounds.push_back(ComputeWorldBounds(objectIndex));
+
+	return handle;
+}
+
+BoundingSphere Scene::ComputeWorldBounds(uint32_t objectIndex) const
+{
+	const BoundingSphere& meshBounds = Meshes[MeshIndices[objectIndex]].Bounds;
+	const uint32_t skinIndex = SkinIndices[objectIndex];
+	if (skinIndex == InvalidSkin) return Bounds::TransformBoundingSphere(meshBounds, Transforms[objectIndex]);
+
+	const Skin& skin = Skins[skinIndex];
+	Float3 jointsMin{ FLT_MAX };
+	Float3 jointsMax{ -FLT_MAX };
+	for (const uint32_t joint : skin.JointNodes)
+	{
+		const Float3 jointPosition{ NodeWorldTransforms[joint][3] };
+		jointsMin = glm::min(jointsMin, jointPosition);
+		jointsMax = glm::max(jointsMax, jointPosition);
+	}
+
+	BoundingSphere bounds;
+	bounds.Center = (jointsMin + jointsMax) * 0.5f;
+	bounds.Radius = glm::length(jointsMax - bounds.Center) + 2.0f * meshBounds.Radius;
+	return bounds;
+}
+
+void Scene::UpdateTransforms()
+{
+	if (!HasDirtyNodes) return;
+	HasDirtyNodes = false;
+
+	// Siblings are contiguous so the sweep goes run by run, dirty flags are pushed down as it goes
+	const uint32_t nodeCount = (uint32_t)NodeParents.size();
+	uint32_t node = 0;
+	while (node < nodeCount)
+	{
+		const uint32_t parent = NodeParents[node];
+		uint32_t runEnd = node + 1;
+		while (runEnd < nodeCount && NodeParents[runEnd] == parent) runEnd++;
+
+		if (parent == InvalidNode)
+		{
+			for (; node < runEnd; node++)
+			{
+				if (NodeDirty[node]) NodeWorldTransforms[node] = NodeLocalTransforms[node];
+			}
+			continue;
+		}
+
+		const bool parentDirty = NodeDirty[parent] != 0;
+		const Float4x4& parentTransform = NodeWorldTransforms[parent];
+		const __m128 parentColumns[4] = {
+			_mm_loadu_ps(&parentTransform[0][0]),
+			_mm_loadu_ps(&parentTransform[1][0]),
+			_mm_loadu_ps(&parentTransform[2][0]),
+			_mm_loadu_ps(&parentTransform[3][0]),
+		};
+
+		for (; node < runEnd; node++)
+		{
+			if (!parentDirty && !NodeDirty[node]) continue;
+
+			NodeDirty[node] = 1;
+			MultiplyTransform(parentColumns, NodeLocalTransforms[node], NodeWorldTransforms[node]);
+		}
+	}
+
+	// Palettes are independent so they are computed on worker threads, uploads stay on this thread
+	std::for_each(std::execution::par, Skins.begin(), Skins.end(), [this](Skin& skin) {
+		skin.Dirty = std::any_of(skin.JointNodes.begin(), skin.JointNodes.end(), [this](uint32_t joint) { return NodeDirty[joint] != 0; });
+		if (skin.Dirty) UpdatePalette(skin, NodeWorldTransforms);
+	});
+	for (Skin& skin : Skins)
+	{
+		if (skin.Dirty) skin.Palette->Upload(skin.PaletteData.data(), (unsigned)(skin.PaletteData.size() * sizeof(Float4x4)));
+	}
+
+	uint32_t firstDirtyObject = GetObjectCount();
+	uint32_t lastDirtyObject = 0;
+	for (uint32_t i = 0; i < GetObjectCount(); i++)
+	{
+		const uint32_t objectNode = NodeIndices[i];
+		const uint32_t skinIndex = SkinIndices[i];
+		const bool skinDirty = skinIndex != InvalidSkin && Skins[skinIndex].Dirty;
+		if (!NodeDirty[objectNode] && !skinDirty) continue;
+
+		Transforms[i] = NodeWorldTransforms[objectNode];
+		WorldBounds[i] = ComputeWorldBounds(i);
+		firstDirtyObject = std::min(firstDirtyObject, i);
+		lastDirtyObject = std::max(lastDirtyObject, i);
+	}
+
+	std::fill(NodeDirty.begin(), NodeDirty.end(), (uint8_t)0);
+
+	if (firstDirtyObject > lastDirtyObject) return;
+
+	BVH.Refit(WorldBounds);
+
+	if (DrawData)
+	{
+		std::vector<SceneObjectGPUData> objects(lastDirtyObject - firstDirtyObject + 1);
+		for (uint32_t i = firstDirtyObject; i <= lastDirtyObject; i++)
+			objects[i - firstDirtyObject] = GetObjectGPUData(*this, i);
+
+		DrawData->Objects->Upload(objects.data(), (unsigned)(objects.size() * sizeof(SceneObjectGPUData)), firstDirtyObject * sizeof(SceneObjectGPUData));
+	}
+}
+
+Ptr<SceneDrawData> SceneDrawData::Create(Mesh&& geometry, const Scene& scene)
+{
+	const uint32_t objectCount = scene.GetObjectCount();
+
+	SceneDrawData* drawData = new SceneDrawData{};
+	drawData->NumObjects = objectCount;
+	drawData->Geometry = std::move(geometry);
+
+	std::vector<uint32_t> objectIndices(objectCount);
+	std::vector<SceneObjectGPUData> objects(objectCount);
+	std::vector<DrawIndirectCommand> drawCommands(objectCount);
+	for (uint32_t i = 0; i < objectCount; i++)
+	{
+		const Mesh& mesh = scene.Meshes[scene.MeshIndices[i]];
+
+		objectIndices[i] = i;
+		objects[i] = GetObjectGPUData(scene, i);
+
+		DrawIndirectCommand& command = drawCommands[i];
+		command.Count = mesh.NumPrimitives;
+		command.InstanceCount = 1;
+		command.FirstIndex = mesh.FirstIndex;
+		command.BaseVertex = mesh.BaseVertex;
+		command.BaseInstance = i;
+	}
+
+	const unsigned numObjects = drawData->NumObjects;
+	drawData->ObjectIndices = Buffer::Create(BufferType::Vertex, numObjects * sizeof(uint32_t), sizeof(uint32_t), BF_None, objectIndices.data());
+	drawData->Objects = Buffer::Create(BufferType::Storage, numObjects * sizeof(SceneObjectGPUData), sizeof(SceneObjectGPUData), BF_None, objects.data());
+	drawData->DrawCommands = Buffer::Create(BufferType::Storage, numObjects * sizeof(DrawIndirectCommand), sizeof(DrawIndirectCommand), BF_None, drawCommands.data());
+	drawData->VisibleDrawCommands = Buffer::Create(BufferType::Storage, numObjects * sizeof(DrawIndirectCommand), sizeof(DrawIndirectCommand), BF_None, drawCommands.data());
+	drawData->VisibleCount = Buffer::Create(BufferType::Storage, sizeof(uint32_t), sizeof(uint32_t), BF_None);
+
+	return Ptr<SceneDrawData>{drawData};
+}
@@ -1,32 +1,167 @@
 #pragma once
 
 #include <vector>
+#include <string>
+#include <unordered_map>
 
 #include "../Common.h"
+#include "../Render/Bounds.h"
+#include "../Render/Buffer.h"
+#include "SceneAnimation.h"
+#include "SceneBVH.h"
 
-struct Buffer;
 struct Texture;
 
 struct Mesh
 {
 	unsigned NumPrimitives = 0;
+	IndexFormat IndexType = IndexFormat::Uint32;
 	Ptr<Buffer> Positions;
 	Ptr<Buffer> Texcoords;
 	Ptr<Buffer> Normals;
 	Ptr<Buffer> Tangents;
 	Ptr<Buffer> Indices;
+
+	// Only for skinned meshes
+	Ptr<Buffer> Joints;
+	Ptr<Buffer> Weights;
+
+	// Local space bounds
+	BoundingSphere Bounds;
+
+	// Offsets into SceneDrawData::Geometry
+	unsigned FirstIndex = 0;
+	unsigned BaseVertex = 0;
 };
 
+struct Material
+{
+	Ptr<Texture> Albedo;
+};
+
+// Joint matrices (joint world * inverse bind) are in storage buffer so skinned vertices end up in world space
+struct Skin
+{
+	std::vector<uint32_t> JointNodes;
+	std::vector<Float4x4> InverseBindMatrices;
+
+	// Transposed like other transforms given to shaders
+	std::vector<Float4x4> PaletteData;
+	Ptr<Buffer> Palette;
+
+	bool Dirty = false;
+};
+
+struct Scene;
+
+// Stays valid for the lifetime of the scene, unlike object index that follows column order
+using SceneObjectHandle = uint32_t;
+
+// Lightweight view of one object, the data lives in Scene columns at Index
 struct SceneObject
+{
+	Scene* Owner = nullptr;
+	uint32_t Index = 0;
+};
+
+// Matches GL DrawElementsIndirectCommand layout
+struct DrawIndirectCommand
+{
+	uint32_t Count;
+	uint32_t InstanceCount;
+	uint32_t FirstIndex;
+	uint32_t BaseVertex;
+	uint32_t BaseInstance;
+};
+
+// Per object data read by shaders, transform is transposed like transforms bound through bind tables
+struct SceneObjectGPUData
 {
 	Float4x4 ModelTransform;
+	Float4 BoundingSphere;
+};
 
-	Mesh MeshData;
+// Scene geometry merged into shared buffers so visible objects can be culled and drawn on the GPU with one indirect draw
+struct SceneDrawData
+{
+	// Binding of the Objects storage buffer while drawing indirect
+	static constexpr unsigned ObjectsBinding = 0;
 
-	Ptr<Texture> Albedo;
+	// Vertex attribute with the object index, instance rate attribute so it follows draw command base instance
+	static constexpr unsigned ObjectIndexAttribute = 4;
+
+	static Ptr<SceneDrawData> Create(Mesh&& geometry, const Scene& scene);
+
+	unsigned NumObjects = 0;
+
+	Mesh Geometry;
+
+	Ptr<Buffer> ObjectIndices;
+	Ptr<Buffer> Objects;
+	Ptr<Buffer> DrawCommands;
+
+	// Written by culling, visible commands are compacted at the front and the rest are zero
+	Ptr<Buffer> VisibleDrawCommands;
+	Ptr<Buffer> VisibleCount;
 };
 
+// Scene objects are stored as columns so passes over one attribute (culling, transforms) touch only that data
 struct Scene
 {
-	std::vector<SceneObject> SceneObjects;
+	static constexpr uint32_t InvalidNode = ~0u;
+	static constexpr uint32_t InvalidSkin = ~0u;
+
+	uint32_t GetObjectCount() const { return (uint32_t)Transforms.size(); }
+	uint32_t GetObjectIndex(SceneObjectHandle handle) const { return HandleToIndex[handle]; }
+
+	// Parent must be added before its children, siblings must be added one after another
+	uint32_t AddNode(const std::string& name, uint32_t parent, const Float4x4& localTransform);
+	uint32_t FindNode(const std::string& name) const;
+	void SetNodeLocalTransform(uint32_t node, const Float4x4& localTransform);
+
+	uint32_t AddSkin(const std::vector<uint32_t>& jointNodes, const std::vector<Float4x4>& inverseBindMatrices);
+	SceneObjectHandle AddObject(uint32_t node, uint32_t meshIndex, uint32_t materialIndex, uint32_t skinIndex = InvalidSkin);
+
+	// Recomputes world transforms of dirty subtrees in one sweep over the nodes and refreshes object columns, BVH and draw data
+	// Executor runs it for every scene at the end of each frame, it is cheap when nothing changed so passes and nodes
+	// reading transforms also call it first to see changes made earlier in the same frame
+	void UpdateTransforms();
+
+	// Skinned objects are bounded by their joints, grown by the bind pose mesh size since vertices can be away from joints
+	BoundingSphere ComputeWorldBounds(uint32_t objectIndex) const;
+
+	Mesh& GetMesh(uint32_t objectIndex) { return Meshes[MeshIndices[objectIndex]]; }
+	Material& GetMaterial(uint32_t objectIndex) { return Materials[MaterialIndices[objectIndex]]; }
+
+	// Node columns, nodes are breadth first so one linear sweep visits parents before children
+	std::vector<uint32_t> NodeParents;
+	std::vector<Float4x4> NodeLocalTransforms;
+	std::vector<Float4x4> NodeWorldTransforms;
+	std::vector<uint8_t> NodeDirty;
+	std::unordered_map<std::string, uint32_t> NodeNames;
+	bool HasDirtyNodes = false;
+
+	// Object columns
+	std::vector<uint32_t> NodeIndices;
+	std::vector<Float4x4> Transforms;
+	std::vector<BoundingSphere> WorldBounds;
+	std::vector<uint32_t> MeshIndices;
+	std::vector<uint32_t> MaterialIndices;
+	std::vector<uint32_t> SkinIndices;
+	std::vector<SceneObjectHandle> Handles;
+
+	std::vector<uint32_t> HandleToIndex;
+
+	// Shared between objects
+	std::vector<Mesh> Meshes;
+	std::vector<Material> Materials;
+	std::vector<Skin> Skins;
+
+	std::vector<SceneAnimation> Animations;
+
+	// Built over world space bounds of scene objects
+	SceneBVH BVH;
+
+	// Only created for GPU driven scenes
+	Ptr<SceneDrawData> DrawData;
 };
\ No newline at end of file
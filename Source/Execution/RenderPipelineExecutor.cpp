@@ -3,11 +3,14 @@
 #include "../App/App.h"
 #include "../Editor/EditorErrorHandler.h"
 #include "../Render/SceneLoading.h"
+#include "../Render/ShaderPreprocessor.h"
 #include "ExecutorNode.h"
 
+#include <algorithm>
+
 void InitStaticResources(ExecuteContext& context)
 {
-	std::vector<GLuint> cubeIndices{
+	std::vector<GLushort> cubeIndices{
 		//Top
 		2, 6, 7,
 		2, 3, 7,
@@ -47,24 +50,89 @@ void InitStaticResources(ExecuteContext& context)
 
 	Mesh* cubeMesh = new Mesh{};
 	cubeMesh->Positions = Buffer::Create(BufferType::Vertex, cubeVertices.size() * sizeof(float), sizeof(float), BF_None, cubeVertices.data());
-	cubeMesh->Indices = Buffer::Create(BufferType::Index, cubeIndices.size() * sizeof(unsigned), sizeof(unsigned), BF_None, cubeIndices.data());
+	cubeMesh->Indices = Buffer::Create(BufferType::Index, cubeIndices.size() * sizeof(GLushort), sizeof(GLushort), BF_None, cubeIndices.data());
 	cubeMesh->NumPrimitives = cubeIndices.size();
+	cubeMesh->IndexType = IndexFormat::Uint16;
 
 	context.RenderResources.Meshes[VariablePool::ID_CubeMesh] = Ptr<Mesh>(cubeMesh);
 }
 
+// Assigns physical textures to transient render targets
+// Targets with same description share a texture when their lifetimes don't overlap
+void InitTransientTextures(ExecuteContext& context)
+{
+	struct PooledTexture
+	{
+		Texture* Storage;
+		unsigned LastUse;
+	};
+
+	std::vector<TransientTextureLifetime> sortedLifetimes = context.TransientTextures;
+	std::sort(sortedLifetimes.begin(), sortedLifetimes.end(), [](const TransientTextureLifetime& a, const TransientTextureLifetime& b) {
+		return a.FirstUse < b.FirstUse;
+	});
+
+	std::vector<PooledTexture> pool;
+	for (const TransientTextureLifetime& lifetime : sortedLifetimes)
+	{
+		const TextureData& texData = context.VariablePool.GetRef(lifetime.Texture).Get<TextureData>();
+
+		unsigned int flags = TF_Framebuffer;
+		if (texData.DepthStencil) flags |= TF_DepthStencil;
+
+		const auto it = std::find_if(pool.begin(), pool.end(), [&](const PooledTexture& pooled) {
+			return pooled.LastUse < lifetime.FirstUse &&
+				pooled.Storage->Width == (unsigned)texData.Width &&
+				pooled.Storage->Height == (unsigned)texData.Height &&
+				pooled.Storage->Flags == flags;
+		});
+
+		Texture* texture = nullptr;
+		if (it != pool.end())
+		{
+			texture = it->Storage;
+			it->LastUse = lifetime.LastUse;
+		}
+		else
+		{
+			context.RenderResources.TransientTexturePool.push_back(Texture::Create(texData.Width, texData.Height, flags));
+			texture = context.RenderResources.TransientTexturePool.back().get();
+			pool.push_back(PooledTexture{ texture, lifetime.LastUse });
+		}
+		context.RenderResources.TransientTextures[lifetime.Texture] = texture;
+	}
+
+	if (!sortedLifetimes.empty())
+	{
+		App::Get()->GetConsole().Log("[TransientTextures] " + std::to_string(sortedLifetimes.size()) + " render targets share " + std::to_string(pool.size()) + " textures");
+	}
+}
+
 void InitRenderResources(ExecuteContext& context)
 {
+	std::unordered_set<VariableID> transientTextureIDs;
+	for (const TransientTextureLifetime& lifetime : context.TransientTextures)
+		transientTextureIDs.insert(lifetime.Texture);
+
 	std::vector<std::string> errorMessages;
 	SceneLoading::Loader loader{};
-	const auto fn = [&context, &loader, &errorMessages](VariableID id, const Variable& variable) {
+	ShaderPreprocessor shaderPreprocessor{};
+	const auto fn = [&context, &loader, &shaderPreprocessor, &errorMessages, &transientTextureIDs](VariableID id, const Variable& variable) {
 		switch (variable.Type)
 		{
 		case VariableType::Texture:
 		{
+			if (transientTextureIDs.count(id)) return;
+
 			const TextureData& texData = variable.Get<TextureData>();
 			if (texData.Path.empty())
 			{
+				if (IsCompressedFormat(texData.Format))
+				{
+					errorMessages.push_back("Failed to create texture under variable " + variable.Name + " (compressed format requires a file)");
+					return;
+				}
+
 				unsigned int flags = TF_None;
 				if (texData.Framebuffer) flags |= TF_Framebuffer;
 				if (texData.DepthStencil) flags |= TF_DepthStencil;
@@ -72,7 +140,7 @@ void InitRenderResources(ExecuteContext& context)
 			}
 			else
 			{
-				context.RenderResources.Textures[id] = loader.LoadTexture(texData.Path);
+				context.RenderResources.Textures[id] = loader.LoadCookedTexture(texData.Path, texData.Format);
 			}
 		} break;
 		case VariableType::Scene:
@@ -83,27 +151,97 @@ void InitRenderResources(ExecuteContext& context)
 				errorMessages.push_back("Failed to load scene under variable " + variable.Name + " (empty path)");
 				return;
 			}
-			const auto& loadedScene = loader.Load(sceneData.Path);
+			const auto& loadedScene = loader.Load(sceneData.Path, sceneData.OptimizeMeshes, sceneData.GPUDriven);
 			if (loadedScene)
 			{
 				Scene* scene = new Scene{};
-				for (auto& loadedObject : loadedScene->Objects)
-				{
-					auto& objectMesh = loadedObject.Mesh;
 
-					SceneObject sceneObject;
-					sceneObject.Albedo = std::move(loadedObject.Material.Albedo);
-					sceneObject.ModelTransform = loadedObject.ModelTransform;
+				scene->Meshes.resize(loadedScene->Meshes.size());
+				for (size_t i = 0; i < loadedScene->Meshes.size(); i++)
+				{
+					auto& objectMesh = loadedScene->Meshes[i];
 
-					Mesh& mesh = sceneObject.MeshData;
+					Mesh& mesh = scene->Meshes[i];
 					mesh.NumPrimitives = objectMesh.PrimitiveCount;
+					mesh.IndexType = objectMesh.IndexType;
 					mesh.Positions = std::move(objectMesh.Positions);
 					mesh.Texcoords = std::move(objectMesh.Texcoords);
 					mesh.Normals = std::move(objectMesh.Normals);
 					mesh.Tangents = std::move(objectMesh.Tangents);
 					mesh.Indices = std::move(objectMesh.Indices);
+					mesh.Joints = std::move(objectMesh.Joints);
+					mesh.Weights = std::move(objectMesh.Weights);
+					mesh.Bounds = objectMesh.Bounds;
+					mesh.FirstIndex = objectMesh.FirstIndex;
+					mesh.BaseVertex = objectMesh.BaseVertex;
+				}
+
+				scene->Materials.resize(loadedScene->Materials.size());
+				for (size_t i = 0; i < loadedScene->Materials.size(); i++)
+					scene->Materials[i].Albedo = std::move(loadedScene->Materials[i].Albedo);
 
-					scene->SceneObjects.push_back(std::move(sceneObject));
+				const size_t nodeCount = loadedScene->Nodes.size();
+				scene->NodeParents.reserve(nodeCount);
+				scene->NodeLocalTransforms.reserve(nodeCount);
+				scene->NodeWorldTransforms.reserve(nodeCount);
+				scene->NodeDirty.reserve(nodeCount);
+				for (const auto& loadedNode : loadedScene->Nodes)
+				{
+					const uint32_t parent = loadedNode.Parent == SceneLoading::InvalidNode ? Scene::InvalidNode : loadedNode.Parent;
+					scene->AddNode(loadedNode.Name, parent, loadedNode.LocalTransform);
+				}
+
+				for (const auto& loadedSkin : loadedScene->Skins)
+					scene->AddSkin(loadedSkin.Joints, loadedSkin.InverseBindMatrices);
+
+				const size_t objectCount = loadedScene->Objects.size();
+				scene->NodeIndices.reserve(objectCount);
+				scene->Transforms.reserve(objectCount);
+				scene->WorldBounds.reserve(objectCount);
+				scene->MeshIndices.reserve(objectCount);
+				scene->MaterialIndices.reserve(objectCount);
+				scene->SkinIndices.reserve(objectCount);
+				scene->Handles.reserve(objectCount);
+				scene->HandleToIndex.reserve(objectCount);
+				for (const auto& loadedObject : loadedScene->Objects)
+				{
+					const uint32_t skin = loadedObject.SkinIndex == SceneLoading::InvalidSkin ? Scene::InvalidSkin : loadedObject.SkinIndex;
+					scene->AddObject(loadedObject.NodeIndex, loadedObject.MeshIndex, loadedObject.MaterialIndex, skin);
+				}
+
+				scene->BVH.Build(scene->WorldBounds);
+
+				for (const auto& loadedAnimation : loadedScene->Animations)
+				{
+					SceneAnimation animation{ loadedAnimation.Name };
+					std::unordered_map<uint32_t, uint32_t> nodeTargets;
+					for (const auto& channel : loadedAnimation.Channels)
+					{
+						auto targetIt = nodeTargets.find(channel.Node);
+						if (targetIt == nodeTargets.end())
+						{
+							const auto& node = loadedScene->Nodes[channel.Node];
+							targetIt = nodeTargets.emplace(channel.Node, animation.AddTarget(channel.Node, node.Translation, node.Rotation, node.Scale)).first;
+						}
+						animation.AddChannel(targetIt->second, channel.Path, channel.Interpolation, channel.Times, channel.Values);
+					}
+					scene->Animations.push_back(std::move(animation));
+				}
+
+				if (sceneData.GPUDriven)
+				{
+					auto& loadedGeometry = loadedScene->Geometry;
+
+					Mesh geometry;
+					geometry.NumPrimitives = loadedGeometry.PrimitiveCount;
+					geometry.IndexType = loadedGeometry.IndexType;
+					geometry.Positions = std::move(loadedGeometry.Positions);
+					geometry.Texcoords = std::move(loadedGeometry.Texcoords);
+					geometry.Normals = std::move(loadedGeometry.Normals);
+					geometry.Tangents = std::move(loadedGeometry.Tangents);
+					geometry.Indices = std::move(loadedGeometry.Indices);
+
+					scene->DrawData = SceneDrawData::Create(std::move(geometry), *scene);
 				}
 				context.RenderResources.Scenes[id] = Ptr<Scene>(scene);
 			}
@@ -116,12 +254,29 @@ void InitRenderResources(ExecuteContext& context)
 				errorMessages.push_back("Failed to load shader under variable " + variable.Name + " (empty path)");
 				return;
 			}
-			context.RenderResources.Shaders[id] = Shader::Compile(shaderData.Path);
+			context.RenderResources.Shaders[id] = Shader::Compile(shaderData.Path, shaderPreprocessor);
+		} break;
+		case VariableType::Sampler:
+		{
+			const SamplerData& samplerData = variable.Get<SamplerData>();
+			context.RenderResources.Samplers[id] = Sampler::Create(samplerData.Filter, samplerData.Wrap);
+		} break;
+		case VariableType::Buffer:
+		{
+			const BufferData& bufferData = variable.Get<BufferData>();
+			if (bufferData.ByteSize == 0)
+			{
+				errorMessages.push_back("Failed to create buffer under variable " + variable.Name + " (zero size)");
+				return;
+			}
+			context.RenderResources.Buffers[id] = Buffer::Create(BufferType::Storage, bufferData.ByteSize, bufferData.Stride, BF_None);
 		} break;
 		}
 	};
 	context.VariablePool.ForEachVariable(fn);
 
+	InitTransientTextures(context);
+
 	if (!errorMessages.empty())
 	{
 		for (const std::string& errorMessage : errorMessages)
@@ -149,10 +304,11 @@ void RenderPipelineExecutor::OnStart()
 {
 	// Init context
 	m_Context = ExecuteContext{};
-	m_Context.EditorLinks = m_Pipeline.EditorLinks;
 	m_Context.VariablePool = m_Pipeline.VariablePool;
+	m_Context.TransientTextures = m_Pipeline.TransientTextures;
 	InitStaticResources(m_Context);
 	InitRenderResources(m_Context);
+	WatchShaders();
 
 	// Clear console
 	App::Get()->GetConsole().Clear();
@@ -165,6 +321,8 @@ void RenderPipelineExecutor::OnStart()
 
 void RenderPipelineExecutor::OnUpdate(float dt)
 {
+	ReloadChangedShaders(dt);
+
 	const std::string dtVar = "DT";
 	m_Context.VariablePool.GetRefOrCreate(VariablePool::ID_DT, VariableType::Float, dtVar).Get<float>() = dt;
 	
@@ -185,6 +343,12 @@ void RenderPipelineExecutor::OnUpdate(float dt)
 
 	m_Pipeline.OnUpdateNode->ExecuteNodePath(m_Context);
 
+	// Scenes changed this frame are swept even if nothing read them, so input nodes of the next frame see current transforms
+	for (auto& it : m_Context.RenderResources.Scenes)
+	{
+		if (it.second) it.second->UpdateTransforms();
+	}
+
 	m_Context.InputState.PressedKeys.clear();
 	m_Context.InputState.ReleasedKeys.clear();
 
@@ -213,6 +377,77 @@ void RenderPipelineExecutor::HandleKeyReleased(int key, int mods)
 	m_Context.InputState.ReleasedKeys.insert(inputHash);
 }
 
+void RenderPipelineExecutor::WatchShaders()
+{
+	m_ShaderWatcher.Clear();
+	m_ShaderWatchTimer = 0.0f;
+	for (const auto& it : m_Context.RenderResources.Shaders)
+	{
+		// Includes of a shader that failed to compile aren't known, its source is watched to compile it again once fixed
+		if (!it.second)
+		{
+			m_ShaderWatcher.Watch(m_Context.VariablePool.GetRef(it.first).Get<ShaderData>().Path);
+			continue;
+		}
+
+		for (const std::string& dependency : it.second->Dependencies)
+			m_ShaderWatcher.Watch(dependency);
+	}
+}
+
+void RenderPipelineExecutor::ReloadChangedShaders(float dt)
+{
+	static constexpr float PollInterval = 0.5f;
+
+	m_ShaderWatchTimer += dt;
+	if (m_ShaderWatchTimer < PollInterval) return;
+	m_ShaderWatchTimer = 0.0f;
+
+	const std::vector<std::string> changedFiles = m_ShaderWatcher.PollChanges();
+	if (changedFiles.empty()) return;
+
+	for (auto& it : m_Context.RenderResources.Shaders)
+	{
+		Shader* shader = it.second.get();
+		if (!shader)
+		{
+			const std::string& path = m_Context.VariablePool.GetRef(it.first).Get<ShaderData>().Path;
+			if (std::find(changedFiles.begin(), changedFiles.end(), path) == changedFiles.end()) continue;
+
+			it.second = Shader::Compile(path);
+			if (it.second)
+			{
+				App::Get()->GetConsole().Log("[Shader hot reload] Compiled " + path);
+				for (const std::string& dependency : it.second->Dependencies)
+					m_ShaderWatcher.Watch(dependency);
+			}
+			else
+			{
+				App::Get()->GetConsole().Log("[Shader hot reload] Failed to compile " + path);
+			}
+			continue;
+		}
+
+		const bool affected = std::any_of(shader->Dependencies.begin(), shader->Dependencies.end(), [&changedFiles](const std::string& dependency) {
+			return std::find(changedFiles.begin(), changedFiles.end(), dependency) != changedFiles.end();
+		});
+		if (!affected) continue;
+
+		if (shader->Reload())
+		{
+			App::Get()->GetConsole().Log("[Shader hot reload] Reloaded " + shader->Path);
+
+			// Includes could change with the reload
+			for (const std::string& dependency : shader->Dependencies)
+				m_ShaderWatcher.Watch(dependency);
+		}
+		else
+		{
+			App::Get()->GetConsole().Log("[Shader hot reload] Failed to reload " + shader->Path + ", keeping previous version");
+		}
+	}
+}
+
 void RenderPipelineExecutor::SetCompiledPipeline(CompiledPipeline pipeline)
 {
 	delete m_Pipeline.OnStartNode;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../Common.h"
+#include "../Util/FileWatcher.h"
 #include "ExecuteContext.h"
 
 class RenderPipelineExecutor
@@ -18,7 +19,13 @@ public:
 private:
     void HandleErrors();
 
+    void WatchShaders();
+    void ReloadChangedShaders(float dt);
+
 private:
     ExecuteContext m_Context;
     CompiledPipeline m_Pipeline;
+
+    FileWatcher m_ShaderWatcher;
+    float m_ShaderWatchTimer = 0.0f;
 };
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "SceneAnimation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <xmmintrin.h>
+
+#include "ExecutorScene.h"
+
+namespace
+{
+	// Linear rotation channels waiting to be interpolated four at a time
+	struct RotationBatch
+	{
+		static constexpr uint32_t Size = 4;
+
+		const Float4* From[Size];
+		const Float4* To[Size];
+		float Factors[Size];
+		Float4* Outputs[Size];
+		uint32_t Count = 0;
+	};
+
+	void InterpolateRotations(RotationBatch& batch)
+	{
+		if (batch.Count == 0) return;
+
+		for (uint32_t i = batch.Count; i < RotationBatch::Size; i++)
+		{
+			batch.From[i] = batch.From[0];
+			batch.To[i] = batch.To[0];
+			batch.Factors[i] = 0.0f;
+		}
+
+		__m128 fromX = _mm_loadu_ps(&batch.From[0]->x);
+		__m128 fromY = _mm_loadu_ps(&batch.From[1]->x);
+		__m128 fromZ = _mm_loadu_ps(&batch.From[2]->x);
+		__m128 fromW = _mm_loadu_ps(&batch.From[3]->x);
+		_MM_TRANSPOSE4_PS(fromX, fromY, fromZ, fromW);
+
+		__m128 toX = _mm_loadu_ps(&batch.To[0]->x);
+		__m128 toY = _mm_loadu_ps(&batch.To[1]->x);
+		__m128 toZ = _mm_loadu_ps(&batch.To[2]->x);
+		__m128 toW = _mm_loadu_ps(&batch.To[3]->x);
+		_MM_TRANSPOSE4_PS(toX, toY, toZ, toW);
+
+		// Take the shorter arc
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		__m128 cosAngle = _mm_mul_ps(fromX, toX);
+		cosAngle = _mm_add_ps(cosAngle, _mm_mul_ps(fromY, toY));
+		cosAngle = _mm_add_ps(cosAngle, _mm_mul_ps(fromZ, toZ));
+		cosAngle = _mm_add_ps(cosAngle, _mm_mul_ps(fromW, toW));
+		const __m128 sign = _mm_and_ps(cosAngle, signMask);
+		toX = _mm_xor_ps(toX, sign);
+		toY = _mm_xor_ps(toY, sign);
+		toZ = _mm_xor_ps(toZ, sign);
+		toW = _mm_xor_ps(toW, sign);
+		const __m128 d = _mm_andnot_ps(signMask, cosAngle);
+
+		// Normalized lerp with the factor corrected towards constant angular speed (zeux, "Approximating slerp")
+		// Angle error stays below 0.002 radians over the whole range
+		const __m128 t = _mm_loadu_ps(batch.Factors);
+		__m128 a = _mm_sub_ps(_mm_set1_ps(3.55645f), _mm_mul_ps(d, _mm_set1_ps(1.43519f)));
+		a = _mm_add_ps(_mm_set1_ps(-3.2452f), _mm_mul_ps(d, a));
+		a = _mm_add_ps(_mm_set1_ps(1.0904f), _mm_mul_ps(d, a));
+		__m128 b = _mm_add_ps(_mm_set1_ps(-1.06021f), _mm_mul_ps(d, _mm_set1_ps(0.215638f)));
+		b = _mm_add_ps(_mm_set1_ps(0.848013f), _mm_mul_ps(d, b));
+		const __m128 centered = _mm_sub_ps(t, _mm_set1_ps(0.5f));
+		const __m128 k = _mm_add_ps(_mm_mul_ps(a, _mm_mul_ps(centered, centered)), b);
+		const __m128 correction = _mm_mul_ps(_mm_mul_ps(t, centered), _mm_mul_ps(_mm_sub_ps(t, _mm_set1_ps(1.0f)), k));
+		const __m128 factor = _mm_add_ps(t, correction);
+
+		__m128 resultX = _mm_add_ps(fromX, _mm_mul_ps(_mm_sub_ps(toX, fromX), factor));
+		__m128 resultY = _mm_add_ps(fromY, _mm_mul_ps(_mm_sub_ps(toY, fromY), factor));
+		__m128 resultZ = _mm_add_ps(fromZ, _mm_mul_ps(_mm_sub_ps(toZ, fromZ), factor));
+		__m128 resultW = _mm_add_ps(fromW, _mm_mul_ps(_mm_sub_ps(toW, fromW), factor));
+
+		__m128 lengthSquared = _mm_mul_ps(resultX, resultX);
+		lengthSquared = _mm_add_ps(lengthSquared, _mm_mul_ps(resultY, resultY));
+		lengthSquared = _mm_add_ps(lengthSquared, _mm_mul_ps(resultZ, resultZ));
+		lengthSquared = _mm_add_ps(lengthSquared, _mm_mul_ps(resultW, resultW));
+		const __m128 inverseLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquared));
+		resultX = _mm_mul_ps(resultX, inverseLength);
+		resultY = _mm_mul_ps(resultY, inverseLength);
+		resultZ = _mm_mul_ps(resultZ, inverseLength);
+		resultW = _mm_mul_ps(resultW, inverseLength);
+
+		_MM_TRANSPOSE4_PS(resultX, resultY, resultZ, resultW);
+		const __m128 results[RotationBatch::Size] = { resultX, resultY, resultZ, resultW };
+		for (uint32_t i = 0; i < batch.Count; i++)
+			_mm_storeu_ps(&batch.Outputs[i]->x, results[i]);
+
+		batch.Count = 0;
+	}
+
+	Float4 Lerp(const Float4& from, const Float4& to, float factor)
+	{
+		const __m128 a = _mm_loadu_ps(&from.x);
+		const __m128 b = _mm_loadu_ps(&to.x);
+		Float4 result;
+		_mm_storeu_ps(&result.x, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(factor))));
+		return result;
+	}
+
+	Float4x4 ComposeTransform(const Float4& translation, const Float4& rotation, const Float4& scale)
+	{
+		const float x = rotation.x;
+		const float y = rotation.y;
+		const float z = rotation.z;
+		const float w = rotation.w;
+
+		Float4x4 transform;
+		transform[0] = Float4{ 1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + z * w), 2.0f * (x * z - y * w), 0.0f } * scale.x;
+		transform[1] = Float4{ 2.0f * (x * y - z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + x * w), 0.0f } * scale.y;
+		transform[2] = Float4{ 2.0f * (x * z + y * w), 2.0f * (y * z - x * w), 1.0f - 2.0f * (x * x + y * y), 0.0f } * scale.z;
+		transform[3] = Float4{ translation.x, translation.y, translation.z, 1.0f };
+		return transform;
+	}
+}
+
+uint32_t SceneAnimation::AddTarget(uint32_t node, const Float3& translation, const Float4& rotation, const Float3& scale)
+{
+	const uint32_t target = (uint32_t)m_TargetNodes.size();
+	m_TargetNodes.push_back(node);
+	m_Translations.push_back(Float4{ translation, 0.0f });
+	m_Rotations.push_back(rotation);
+	m_Scales.push_back(Float4{ scale, 0.0f });
+	return target;
+}
+
+void SceneAnimation::AddChannel(uint32_t target, AnimationPath path, AnimationInterpolation interpolation, const std::vector<float>& times, const std::vector<Float4>& values)
+{
+	ASSERT(target < m_TargetNodes.size());
+	ASSERT(!times.empty());
+	ASSERT(values.size() == times.size() * (interpolation == AnimationInterpolation::CubicSpline ? 3 : 1));
+
+	Channel channel{};
+	channel.Target = target;
+	channel.Path = path;
+	channel.Interpolation = interpolation;
+	channel.FirstKey = (uint32_t)m_KeyTimes.size();
+	channel.KeyCount = (uint32_t)times.size();
+	channel.FirstValue = (uint32_t)m_KeyValues.size();
+	m_Channels.push_back(channel);
+	m_LastKeys.push_back(0);
+
+	m_KeyTimes.insert(m_KeyTimes.end(), times.begin(), times.end());
+	m_KeyValues.insert(m_KeyValues.end(), values.begin(), values.end());
+
+	m_Duration = std::max(m_Duration, times.back());
+}
+
+void SceneAnimation::Apply(float time, Scene& scene)
+{
+	if (m_Duration > 0.0f)
+	{
+		time = std::fmod(time, m_Duration);
+		if (time < 0.0f) time += m_Duration;
+	}
+
+	RotationBatch rotationBatch{};
+	for (uint32_t channelIndex = 0; channelIndex < (uint32_t)m_Channels.size(); channelIndex++)
+	{
+		const Channel& channel = m_Channels[channelIndex];
+		const float* times = &m_KeyTimes[channel.FirstKey];
+		const Float4* values = &m_KeyValues[channel.FirstValue];
+		Float4& output = GetTargetProperty(channel);
+
+		const uint32_t key = FindKey(channelIndex, time);
+		const uint32_t nextKey = std::min(key + 1, channel.KeyCount - 1);
+		const float keyDuration = times[nextKey] - times[key];
+		const float factor = keyDuration > 0.0f ? std::clamp((time - times[key]) / keyDuration, 0.0f, 1.0f) : 0.0f;
+
+		switch (channel.Interpolation)
+		{
+		case AnimationInterpolation::Step:
+			output = values[key];
+			break;
+		case AnimationInterpolation::Linear:
+			if (channel.Path == AnimationPath::Rotation)
+			{
+				const uint32_t index = rotationBatch.Count++;
+				rotationBatch.From[index] = &values[key];
+				rotationBatch.To[index] = &values[nextKey];
+				rotationBatch.Factors[index] = factor;
+				rotationBatch.Outputs[index] = &output;
+				if (rotationBatch.Count == RotationBatch::Size) InterpolateRotations(rotationBatch);
+			}
+			else
+			{
+				output = Lerp(values[key], values[nextKey], factor);
+			}
+			break;
+		case AnimationInterpolation::CubicSpline:
+		{
+			// Hermite spline, key values are (in tangent, value, out tangent)
+			const float t = factor;
+			const float t2 = t * t;
+			const float t3 = t2 * t;
+			const Float4& from = values[3 * key + 1];
+			const Float4& fromTangent = values[3 * key + 2];
+			const Float4& to = values[3 * nextKey + 1];
+			const Float4& toTangent = values[3 * nextKey];
+			output = (2.0f * t3 - 3.0f * t2 + 1.0f) * from + (t3 - 2.0f * t2 + t) * keyDuration * fromTangent + (-2.0f * t3 + 3.0f * t2) * to + (t3 - t2) * keyDuration * toTangent;
+			if (channel.Path == AnimationPath::Rotation) output = glm::normalize(output);
+		} break;
+		default:
+			NOT_IMPLEMENTED;
+		}
+	}
+	InterpolateRotations(rotationBatch);
+
+	for (uint32_t target = 0; target < (uint32_t)m_TargetNodes.size(); target++)
+		scene.SetNodeLocalTransform(m_TargetNodes[target], ComposeTransform(m_Translations[target], m_Rotations[target], m_Scales[target]));
+}
+
+uint32_t SceneAnimation::FindKey(uint32_t channelIndex, float time)
+{
+	const Channel& channel = m_Channels[channelIndex];
+	const float* times = &m_KeyTimes[channel.FirstKey];
+	uint32_t& lastKey = m_LastKeys[channelIndex];
+
+	// Sequential playback stays on the same key or moves to the next one
+	if (times[lastKey] <= time)
+	{
+		if (lastKey + 1 >= channel.KeyCount || time < times[lastKey + 1]) return lastKey;
+		if (lastKey + 2 >= channel.KeyCount || time < times[lastKey + 2]) return ++lastKey;
+	}
+
+	const float* nextKeyTime = std::upper_bound(times, times + channel.KeyCount, time);
+	lastKey = nextKeyTime == times ? 0 : (uint32_t)(nextKeyTime - times) - 1;
+	return lastKey;
+}
+
+Float4& SceneAnimation::GetTargetProperty(const Channel& channel)
+{
+	switch (channel.Path)
+	{
+	case AnimationPath::Translation: return m_Translations[channel.Target];
+	case AnimationPath::Rotation: return m_Rotations[channel.Target];
+	case AnimationPath::Scale: return m_Scales[channel.Target];
+	default: NOT_IMPLEMENTED;
+	}
+	return m_Translations[channel.Target];
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../Common.h"
+#include "../Render/Animation.h"
+
+struct Scene;
+
+// Keyframe animation of scene node transforms
+// Keys of all channels are packed in shared arrays, node poses are kept per target so channels only overwrite the property they animate
+class SceneAnimation
+{
+	struct Channel
+	{
+		uint32_t Target;
+		AnimationPath Path;
+		AnimationInterpolation Interpolation;
+		uint32_t FirstKey;
+		uint32_t KeyCount;
+		uint32_t FirstValue;
+	};
+
+public:
+	SceneAnimation(const std::string& name):
+		m_Name(name) {}
+
+	// Rotation is xyzw quaternion like glTF
+	uint32_t AddTarget(uint32_t node, const Float3& translation, const Float4& rotation, const Float3& scale);
+
+	// Cubic spline channels have three values per key (in tangent, value, out tangent)
+	void AddChannel(uint32_t target, AnimationPath path, AnimationInterpolation interpolation, const std::vector<float>& times, const std::vector<Float4>& values);
+
+	// Samples all channels at time wrapped to animation duration and sets local transforms of target nodes
+	void Apply(float time, Scene& scene);
+
+	const std::string& GetName() const { return m_Name; }
+	float GetDuration() const { return m_Duration; }
+	uint32_t GetChannelCount() const { return (uint32_t)m_Channels.size(); }
+
+private:
+	// Key k such that time is in [time(k), time(k + 1)), starts from the key found last time so sequential playback is O(1)
+	uint32_t FindKey(uint32_t channelIndex, float time);
+
+	Float4& GetTargetProperty(const Channel& channel);
+
+private:
+	std::string m_Name;
+	float m_Duration = 0.0f;
+
+	std::vector<Channel> m_Channels;
+	std::vector<uint32_t> m_LastKeys;
+	std::vector<float> m_KeyTimes;
+	std::vector<Float4> m_KeyValues;
+
+	// Target pose columns
+	std::vector<uint32_t> m_TargetNodes;
+	std::vector<Float4> m_Translations;
+	std::vector<Float4> m_Rotations;
+	std::vector<Float4> m_Scales;
+};
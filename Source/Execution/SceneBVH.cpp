@@ -0,0 +1,223 @@
+#include "SceneBVH.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <xmmintrin.h>
+
+namespace
+{
+	static constexpr uint32_t BatchSize = 4;
+	static constexpr uint32_t MaxDepth = 64;
+
+	enum class PlaneTestResult
+	{
+		Outside,
+		Intersecting,
+		Inside,
+	};
+
+	PlaneTestResult TestBox(const Frustum& frustum, const Float3& center, const Float3& extent)
+	{
+		PlaneTestResult result = PlaneTestResult::Inside;
+		for (const Float4& plane : frustum.Planes)
+		{
+			const Float3 normal{ plane };
+			const float distance = glm::dot(normal, center) + plane.w;
+			const float radius = glm::dot(glm::abs(normal), extent);
+			if (distance < -radius) return PlaneTestResult::Outside;
+			if (distance < radius) result = PlaneTestResult::Intersecting;
+		}
+		return result;
+	}
+}
+
+void SceneBVH::Build(const std::vector<BoundingSphere>& objectBounds)
+{
+	m_ObjectCount = (uint32_t)objectBounds.size();
+	m_Nodes.clear();
+	m_CenterX.clear();
+	m_CenterY.clear();
+	m_CenterZ.clear();
+	m_Radius.clear();
+	m_ObjectIndices.clear();
+
+	if (objectBounds.empty()) return;
+
+	std::vector<uint32_t> objects(objectBounds.size());
+	for (uint32_t i = 0; i < (uint32_t)objects.size(); i++) objects[i] = i;
+
+	m_Nodes.reserve(2 * objects.size() / MaxLeafSize + 1);
+	BuildNode(objects, 0, (uint32_t)objects.size(), objectBounds);
+}
+
+uint32_t SceneBVH::BuildNode(std::vector<uint32_t>& objects, uint32_t begin, uint32_t end, const std::vector<BoundingSphere>& objectBounds)
+{
+	Float3 boundsMin{ FLT_MAX };
+	Float3 boundsMax{ -FLT_MAX };
+	Float3 centroidMin{ FLT_MAX };
+	Float3 centroidMax{ -FLT_MAX };
+	for (uint32_t i = begin; i < end; i++)
+	{
+		const BoundingSphere& sphere = objectBounds[objects[i]];
+		boundsMin = glm::min(boundsMin, sphere.Center - sphere.Radius);
+		boundsMax = glm::max(boundsMax, sphere.Center + sphere.Radius);
+		centroidMin = glm::min(centroidMin, sphere.Center);
+		centroidMax = glm::max(centroidMax, sphere.Center);
+	}
+
+	const uint32_t nodeIndex = (uint32_t)m_Nodes.size();
+	m_Nodes.push_back(Node{ (boundsMin + boundsMax) * 0.5f, 0, (boundsMax - boundsMin) * 0.5f, 0 });
+
+	const uint32_t count = end - begin;
+	if (count <= MaxLeafSize)
+	{
+		const uint32_t firstIndex = (uint32_t)m_ObjectIndices.size();
+		const uint32_t paddedCount = (count + BatchSize - 1) / BatchSize * BatchSize;
+		for (uint32_t i = 0; i < paddedCount; i++)
+		{
+			const bool padding = i >= count;
+			const BoundingSphere& sphere = objectBounds[objects[padding ? begin : begin + i]];
+			m_CenterX.push_back(sphere.Center.x);
+			m_CenterY.push_back(sphere.Center.y);
+			m_CenterZ.push_back(sphere.Center.z);
+			m_Radius.push_back(padding ? -FLT_MAX : sphere.Radius);
+			m_ObjectIndices.push_back(padding ? ~0u : objects[begin + i]);
+		}
+
+		m_Nodes[nodeIndex].FirstIndex = firstIndex;
+		m_Nodes[nodeIndex].Count = count;
+		return nodeIndex;
+	}
+
+	// Median split on the longest centroid axis
+	const Float3 centroidExtent = centroidMax - centroidMin;
+	int axis = 0;
+	if (centroidExtent.y > centroidExtent[axis]) axis = 1;
+	if (centroidExtent.z > centroidExtent[axis]) axis = 2;
+
+	const uint32_t middle = begin + count / 2;
+	std::nth_element(objects.begin() + begin, objects.begin() + middle, objects.begin() + end, [&objectBounds, axis](uint32_t a, uint32_t b) {
+		return objectBounds[a].Center[axis] < objectBounds[b].Center[axis];
+	});
+
+	BuildNode(objects, begin, middle, objectBounds);
+	const uint32_t rightChild = BuildNode(objects, middle, end, objectBounds);
+	m_Nodes[nodeIndex].FirstIndex = rightChild;
+	return nodeIndex;
+}
+
+void SceneBVH::Refit(const std::vector<BoundingSphere>& objectBounds)
+{
+	ASSERT(objectBounds.size() == m_ObjectCount);
+
+	// Children always come after their parent so a reverse sweep finishes both children before the parent
+	for (uint32_t nodeIndex = (uint32_t)m_Nodes.size(); nodeIndex-- > 0;)
+	{
+		Node& node = m_Nodes[nodeIndex];
+
+		Float3 boundsMin{ FLT_MAX };
+		Float3 boundsMax{ -FLT_MAX };
+		if (node.Count == 0)
+		{
+			for (const uint32_t childIndex : { nodeIndex + 1, node.FirstIndex })
+			{
+				const Node& child = m_Nodes[childIndex];
+				boundsMin = glm::min(boundsMin, child.Center - child.Extent);
+				boundsMax = glm::max(boundsMax, child.Center + child.Extent);
+			}
+		}
+		else
+		{
+			for (uint32_t i = node.FirstIndex; i < node.FirstIndex + node.Count; i++)
+			{
+				const BoundingSphere& sphere = objectBounds[m_ObjectIndices[i]];
+				m_CenterX[i] = sphere.Center.x;
+				m_CenterY[i] = sphere.Center.y;
+				m_CenterZ[i] = sphere.Center.z;
+				m_Radius[i] = sphere.Radius;
+				boundsMin = glm::min(boundsMin, sphere.Center - sphere.Radius);
+				boundsMax = glm::max(boundsMax, sphere.Center + sphere.Radius);
+			}
+		}
+
+		node.Center = (boundsMin + boundsMax) * 0.5f;
+		node.Extent = (boundsMax - boundsMin) * 0.5f;
+	}
+}
+
+void SceneBVH::Query(const Frustum& frustum, std::vector<uint32_t>& visibleObjects) const
+{
+	if (m_Nodes.empty()) return;
+
+	__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+	for (int i = 0; i < 6; i++)
+	{
+		planeX[i] = _mm_set1_ps(frustum.Planes[i].x);
+		planeY[i] = _mm_set1_ps(frustum.Planes[i].y);
+		planeZ[i] = _mm_set1_ps(frustum.Planes[i].z);
+		planeW[i] = _mm_set1_ps(frustum.Planes[i].w);
+	}
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+
+	struct StackEntry
+	{
+		uint32_t NodeIndex;
+		bool Inside;
+	};
+	StackEntry stack[MaxDepth];
+	uint32_t stackSize = 0;
+	stack[stackSize++] = { 0, false };
+
+	while (stackSize > 0)
+	{
+		const StackEntry entry = stack[--stackSize];
+		const Node& node = m_Nodes[entry.NodeIndex];
+
+		bool inside = entry.Inside;
+		if (!inside)
+		{
+			const PlaneTestResult result = TestBox(frustum, node.Center, node.Extent);
+			if (result == PlaneTestResult::Outside) continue;
+			inside = result == PlaneTestResult::Inside;
+		}
+
+		if (node.Count == 0)
+		{
+			stack[stackSize++] = { node.FirstIndex, inside };
+			stack[stackSize++] = { entry.NodeIndex + 1, inside };
+			continue;
+		}
+
+		if (inside)
+		{
+			visibleObjects.insert(visibleObjects.end(), m_ObjectIndices.begin() + node.FirstIndex, m_ObjectIndices.begin() + node.FirstIndex + node.Count);
+			continue;
+		}
+
+		for (uint32_t batch = node.FirstIndex; batch < node.FirstIndex + node.Count; batch += BatchSize)
+		{
+			const __m128 centerX = _mm_loadu_ps(&m_CenterX[batch]);
+			const __m128 centerY = _mm_loadu_ps(&m_CenterY[batch]);
+			const __m128 centerZ = _mm_loadu_ps(&m_CenterZ[batch]);
+			const __m128 negativeRadius = _mm_xor_ps(_mm_loadu_ps(&m_Radius[batch]), signMask);
+
+			__m128 outside = _mm_setzero_ps();
+			for (int i = 0; i < 6; i++)
+			{
+				__m128 distance = _mm_add_ps(_mm_mul_ps(planeX[i], centerX), planeW[i]);
+				distance = _mm_add_ps(_mm_mul_ps(planeY[i], centerY), distance);
+				distance = _mm_add_ps(_mm_mul_ps(planeZ[i], centerZ), distance);
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negativeRadius));
+			}
+
+			unsigned visibleMask = ~(unsigned)_mm_movemask_ps(outside) & 0xF;
+			while (visibleMask)
+			{
+				unsigned bit = 0;
+				while (!(visibleMask & (1u << bit))) bit++;
+				visibleMask &= visibleMask - 1;
+				visibleObjects.push_back(m_ObjectIndices[batch + bit]);
+			}
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+#include "../Common.h"
+#include "../Render/Bounds.h"
+
+// Bounding volume hierarchy over scene object bounds for CPU frustum culling
+// Nodes hold axis aligned boxes, leaves keep object spheres in SoA layout so they are tested four at a time
+class SceneBVH
+{
+	static constexpr uint32_t MaxLeafSize = 8;
+
+	// Interior node has Count == 0, its children are at node index + 1 and at FirstIndex
+	// Leaf objects are at [FirstIndex, FirstIndex + Count) of the leaf arrays
+	struct Node
+	{
+		Float3 Center;
+		uint32_t FirstIndex;
+		Float3 Extent;
+		uint32_t Count;
+	};
+
+public:
+	void Build(const std::vector<BoundingSphere>& objectBounds);
+
+	// Updates bounds for moved objects keeping the tree layout, linear in node count but tree quality degrades with large motion
+	void Refit(const std::vector<BoundingSphere>& objectBounds);
+
+	// Appends indices of objects whose bounding sphere intersects the frustum
+	void Query(const Frustum& frustum, std::vector<uint32_t>& visibleObjects) const;
+
+	uint32_t GetObjectCount() const { return m_ObjectCount; }
+
+private:
+	uint32_t BuildNode(std::vector<uint32_t>& objects, uint32_t begin, uint32_t end, const std::vector<BoundingSphere>& objectBounds);
+
+private:
+	uint32_t m_ObjectCount = 0;
+	std::vector<Node> m_Nodes;
+
+	// Leaf arrays, every leaf starts at multiple of 4 and is padded with spheres that are never visible
+	std::vector<float> m_CenterX;
+	std::vector<float> m_CenterY;
+	std::vector<float> m_CenterZ;
+	std::vector<float> m_Radius;
+	std::vector<uint32_t> m_ObjectIndices;
+};
@@ -14,6 +14,7 @@ struct ValueNodeExtraInfo
 		bool Texcoord : 1;
 		bool Normal : 1;
 		bool Tangent : 1;
+		bool Skinning : 1; // Joints and weights
 	} MeshVertexBits;
 };
 
@@ -21,9 +22,9 @@ template<typename T>
 class ValueNode
 {
 public:
-	ValueNode() = default;
+	ValueNode() { CompiledNodeCounters::ValueNodes++; }
 	ValueNode(const ValueNodeExtraInfo& extraInfo):
-		m_ExtraInfo(extraInfo) {}
+		m_ExtraInfo(extraInfo) { CompiledNodeCounters::ValueNodes++; }
 
 	virtual T GetValue(ExecuteContext& context) const = 0;
 	const ValueNodeExtraInfo& GetExtraInfo() const { return m_ExtraInfo; }
@@ -44,8 +45,9 @@ using TextureValueNode = ValueNode<Texture*>;
 using MeshValueNode = ValueNode<Mesh*>;
 using BufferValueNode = ValueNode<Buffer*>;
 using ShaderValueNode = ValueNode<Shader*>;
-using SceneObjectValueNode = ValueNode<SceneObject*>;
+using SceneObjectValueNode = ValueNode<SceneObject>;
 using SceneValueNode = ValueNode<Scene*>;
+using SamplerValueNode = ValueNode<Sampler*>;
 
 struct BindTable
 {
@@ -56,6 +58,8 @@ struct BindTable
 		Ptr<ValueNode<T>> Value;
 	};
 	std::vector<Binding<Texture*>> Textures;
+	std::vector<Binding<Sampler*>> Samplers;
+	std::vector<Binding<Buffer*>> Buffers;
 	std::vector<Binding<float>> Floats;
 	std::vector<Binding<Float2>> Float2s;
 	std::vector<Binding<Float3>> Float3s;
@@ -475,6 +479,49 @@ private:
 	Ptr<FloatValueNode> m_ZFarNode;
 };
 
+class GetSkinPaletteValueNode : public BufferValueNode
+{
+public:
+	GetSkinPaletteValueNode(SceneObjectValueNode* sceneObjectNode):
+		m_SceneObjectNode(sceneObjectNode)
+	{}
+
+	Buffer* GetValue(ExecuteContext& context) const override
+	{
+		const SceneObject sceneObject = m_SceneObjectNode->GetValue(context);
+		if (!sceneObject.Owner) return nullptr;
+
+		const uint32_t skin = sceneObject.Owner->SkinIndices[sceneObject.Index];
+		if (skin == Scene::InvalidSkin) return nullptr;
+
+		return sceneObject.Owner->Skins[skin].Palette.get();
+	}
+
+private:
+	Ptr<SceneObjectValueNode> m_SceneObjectNode;
+};
+
+// World transform of the object, nodes moved earlier in the frame are swept first
+class GetObjectTransformValueNode : public Float4x4ValueNode
+{
+public:
+	GetObjectTransformValueNode(SceneObjectValueNode* sceneObjectNode):
+		m_SceneObjectNode(sceneObjectNode)
+	{}
+
+	Float4x4 GetValue(ExecuteContext& context) const override
+	{
+		const SceneObject sceneObject = m_SceneObjectNode->GetValue(context);
+		if (!sceneObject.Owner) return glm::identity<Float4x4>();
+
+		sceneObject.Owner->UpdateTransforms();
+		return sceneObject.Owner->Transforms[sceneObject.Index];
+	}
+
+private:
+	Ptr<SceneObjectValueNode> m_SceneObjectNode;
+};
+
 class GetMeshValueNode : public MeshValueNode
 {
 public:
@@ -485,8 +532,9 @@ public:
 
 	Mesh* GetValue(ExecuteContext& context) const override
 	{
-		SceneObject* sceneObject = m_SceneObjectNode->GetValue(context);
-		return &sceneObject->MeshData;
+		const SceneObject sceneObject = m_SceneObjectNode->GetValue(context);
+		if (!sceneObject.Owner) return nullptr;
+		return &sceneObject.Owner->GetMesh(sceneObject.Index);
 	}
 
 private:
@@ -0,0 +1,815 @@
+#include "HeadlessBenchmarks.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "App/App.h"
+#include "Execution/ExecutorScene.h"
+#include "Execution/SceneAnimation.h"
+#include "Execution/SceneBVH.h"
+#include "NodeGraph/NodeGraph.h"
+#include "NodeGraph/NodeGraphSerializer.h"
+#include "Render/ShaderPreprocessor.h"
+#include "Util/MappedFile.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double GetElapsedMilliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void PrintRange(const std::string& label, const std::vector<double>& values, const std::string& unit)
+{
+	const auto [minValue, maxValue] = std::minmax_element(values.begin(), values.end());
+	std::cout << "  " << std::left << std::setw(48) << label << std::right << *minValue << " - " << *maxValue << " " << unit << std::endl;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Text load
+//
+// Generates a 100k node .rn document and reads it the old way and the new way
+// The old read path is gone from the serializer, so its per line work is reproduced here: std::getline, name and value
+// copied out one char at a time, numbers validated and converted with std::stoi and std::stof
+// Same tokenizing over the mapped file with string views and std::from_chars is timed next to it, then a full Deserialize
+// Links are left out, NodeGraph::AddLink scans all links of the graph and would hide the parser
+
+static constexpr unsigned TEXT_LOAD_NODE_COUNT = 100000;
+static constexpr unsigned TEXT_LOAD_RUNS = 3;
+static constexpr const char* TEXT_LOAD_PATH = "BenchmarkTextLoad.rn";
+
+// Value nodes with random contents, plain constructors leave them all zero or identity which makes the text unusually short
+class RandomFloat4EditorNode : public Float4EditorNode
+{
+public:
+	RandomFloat4EditorNode(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> distribution{ -1000.0f, 1000.0f };
+		for (unsigned i = 0; i < 4; i++) m_Values[i] = distribution(random);
+	}
+};
+
+class RandomFloat4x4EditorNode : public Float4x4EditorNode
+{
+public:
+	RandomFloat4x4EditorNode(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+		for (unsigned i = 0; i < 4; i++)
+			for (unsigned j = 0; j < 4; j++)
+				m_Values[i][j] = distribution(random);
+	}
+};
+
+static void GenerateTextDocument(const std::string& path, unsigned nodeCount)
+{
+	std::mt19937 random{ 1 };
+	std::uniform_real_distribution<float> distribution{ -5000.0f, 5000.0f };
+
+	Ptr<NodeGraph> nodeGraph{ NodeGraph::CreateDefaultNodeGraph() };
+	IDMap<ImVec2> nodePositions;
+	for (unsigned i = 0; i < nodeCount; i++)
+	{
+		EditorNode* node = nullptr;
+		switch (i % 4)
+		{
+		case 0: node = new RandomFloat4EditorNode{ random }; break;
+		case 1: node = new RandomFloat4x4EditorNode{ random }; break;
+		case 2: node = new Float4BinaryOperatorEditorNode{}; break;
+		case 3: node = new Float4x4PerspectiveTransformEditorNode{}; break;
+		}
+
+		for (EditorNodePin pin : node->GetPins())
+		{
+			if (!pin.HasConstantValue) continue;
+			pin.ConstantValue.F = distribution(random);
+			node->UpdatePin(pin);
+		}
+
+		nodeGraph->AddNode(node);
+		nodePositions[node->GetID()] = ImVec2{ distribution(random), distribution(random) };
+	}
+	nodeGraph->SetNodePositions(std::move(nodePositions));
+
+	NodeGraphSerializer serializer;
+	serializer.Serialize(path, *nodeGraph, VariablePool{});
+}
+
+static bool IsIntString(const std::string& str)
+{
+	if (str.empty()) return false;
+	for (size_t i = str[0] == '-' ? 1 : 0; i < str.size(); i++)
+	{
+		if (!std::isdigit(str[i])) return false;
+	}
+	return true;
+}
+
+static bool IsFloatString(const std::string& str)
+{
+	if (str.empty()) return false;
+	unsigned numDots = 0;
+	for (size_t i = str[0] == '-' ? 1 : 0; i < str.size(); i++)
+	{
+		if (str[i] == '.' && ++numDots == 1) continue;
+		if (!std::isdigit(str[i])) return false;
+	}
+	return true;
+}
+
+// Returns a sum of the read values so the reads can't be optimized away
+static double ReadWithLineStream(const std::string& path)
+{
+	std::ifstream input{ path };
+	double sum = 0.0;
+
+	std::string line;
+	while (std::getline(input, line))
+	{
+		std::string attrName;
+		size_t it = 0;
+		while (it < line.size() && line[it] != ' ')
+			attrName += line[it++];
+
+		// Skip " : "
+		it += 3;
+
+		std::string value;
+		while (it < line.size())
+			value += line[it++];
+
+		if (IsIntString(value)) sum += std::stoi(value);
+		else if (IsFloatString(value)) sum += std::stof(value);
+		else sum += value.size() + attrName.size();
+	}
+	return sum;
+}
+
+static double ReadWithMappedFile(const std::string& path)
+{
+	MappedFile file;
+	if (!file.Open(path)) return 0.0;
+
+	const char* cursor = static_cast<const char*>(file.GetData());
+	const char* end = cursor + file.GetSize();
+	double sum = 0.0;
+	while (cursor < end)
+	{
+		const char* lineEnd = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+		if (!lineEnd) lineEnd = end;
+		const std::string_view line{ cursor, (size_t)(lineEnd - cursor) };
+		cursor = lineEnd == end ? end : lineEnd + 1;
+
+		const size_t separatorPosition = line.find(" : ");
+		if (separatorPosition == std::string_view::npos) continue;
+
+		const std::string_view attrName = line.substr(0, separatorPosition);
+		const std::string_view value = line.substr(separatorPosition + 3);
+		const char* valueEnd = value.data() + value.size();
+
+		int intValue = 0;
+		float floatValue = 0.0f;
+		if (std::from_chars(value.data(), valueEnd, intValue).ptr == valueEnd) sum += intValue;
+		else if (std::from_chars(value.data(), valueEnd, floatValue).ptr == valueEnd) sum += floatValue;
+		else sum += value.size() + attrName.size();
+	}
+	return sum;
+}
+
+static bool ReadWithSerializer(const std::string& path)
+{
+	CustomNodeList customNodeList;
+	NodeGraph nodeGraph;
+	VariablePool variablePool;
+
+	NodeGraphSerializer serializer;
+	std::vector<CustomEditorNode*> customNodes;
+	const UniqueID firstID = serializer.Deserialize(path, nodeGraph, variablePool, customNodes);
+	for (CustomEditorNode* customNode : customNodes) customNodeList.push_back(Ptr<CustomEditorNode>(customNode));
+	return firstID != 0;
+}
+
+static void RunTextLoad()
+{
+	GenerateTextDocument(TEXT_LOAD_PATH, TEXT_LOAD_NODE_COUNT);
+	const double fileMB = std::filesystem::file_size(TEXT_LOAD_PATH) / (1024.0 * 1024.0);
+	std::cout << "  " << TEXT_LOAD_NODE_COUNT << " nodes, " << fileMB << " MB, " << TEXT_LOAD_RUNS << " runs" << std::endl;
+
+	std::vector<double> lineStreamTimes;
+	std::vector<double> mappedFileTimes;
+	std::vector<double> serializerTimes;
+	for (unsigned run = 0; run < TEXT_LOAD_RUNS; run++)
+	{
+		Clock::time_point start = Clock::now();
+		volatile double sum = ReadWithLineStream(TEXT_LOAD_PATH);
+		lineStreamTimes.push_back(GetElapsedMilliseconds(start));
+
+		start = Clock::now();
+		sum = ReadWithMappedFile(TEXT_LOAD_PATH);
+		mappedFileTimes.push_back(GetElapsedMilliseconds(start));
+		(void)sum;
+
+		start = Clock::now();
+		if (!ReadWithSerializer(TEXT_LOAD_PATH))
+		{
+			std::cout << "  [Load error] " << TEXT_LOAD_PATH << std::endl;
+			return;
+		}
+		serializerTimes.push_back(GetElapsedMilliseconds(start));
+	}
+
+	const auto toThroughput = [fileMB](std::vector<double> times) {
+		for (double& time : times) time = fileMB / (time / 1000.0);
+		return times;
+	};
+	PrintRange("old line stream, tokenizing only", lineStreamTimes, "ms");
+	PrintRange("old line stream, tokenizing only", toThroughput(lineStreamTimes), "MB/s");
+	PrintRange("mapped file, tokenizing only", mappedFileTimes, "ms");
+	PrintRange("mapped file, tokenizing only", toThroughput(mappedFileTimes), "MB/s");
+	PrintRange("mapped file, full Deserialize", serializerTimes, "ms");
+	PrintRange("mapped file, full Deserialize", toThroughput(serializerTimes), "MB/s");
+
+	std::filesystem::remove(TEXT_LOAD_PATH);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Culling
+//
+// Generates a city of 100k objects and culls it from a few cameras, BVH query against testing every sphere one by one
+
+static constexpr unsigned CULLING_OBJECT_COUNT = 100000;
+static constexpr unsigned CULLING_QUERIES = 50;
+
+struct CullingCamera
+{
+	const char* Name;
+	Float3 Eye;
+	Float3 Center;
+	Float3 Up;
+};
+
+// Buildings on a square grid of blocks with streets between them
+static std::vector<BoundingSphere> GenerateCity(unsigned objectCount)
+{
+	static constexpr float BlockSize = 20.0f;
+
+	std::mt19937 random{ 1 };
+	std::uniform_real_distribution<float> heightDistribution{ 4.0f, 60.0f };
+	std::uniform_real_distribution<float> offsetDistribution{ -3.0f, 3.0f };
+
+	const unsigned gridSize = (unsigned)std::ceil(std::sqrt((float)objectCount));
+	std::vector<BoundingSphere> bounds;
+	bounds.reserve(objectCount);
+	for (unsigned i = 0; i < objectCount; i++)
+	{
+		const float height = heightDistribution(random);
+		BoundingSphere sphere;
+		sphere.Center = Float3{ (i % gridSize) * BlockSize + offsetDistribution(random), height * 0.5f, (i / gridSize) * BlockSize + offsetDistribution(random) };
+		sphere.Radius = glm::length(Float3{ 6.0f, height * 0.5f, 6.0f });
+		bounds.push_back(sphere);
+	}
+	return bounds;
+}
+
+static void CullBruteForce(const Frustum& frustum, const std::vector<BoundingSphere>& bounds, std::vector<uint32_t>& visibleObjects)
+{
+	for (uint32_t i = 0; i < (uint32_t)bounds.size(); i++)
+	{
+		const BoundingSphere& sphere = bounds[i];
+		bool visible = true;
+		for (const Float4& plane : frustum.Planes)
+		{
+			if (glm::dot(Float3{ plane }, sphere.Center) + plane.w < -sphere.Radius)
+			{
+				visible = false;
+				break;
+			}
+		}
+		if (visible) visibleObjects.push_back(i);
+	}
+}
+
+static void RunCulling()
+{
+	const std::vector<BoundingSphere> bounds = GenerateCity(CULLING_OBJECT_COUNT);
+	const float citySize = std::sqrt((float)CULLING_OBJECT_COUNT) * 20.0f;
+	const Float3 cityCenter{ citySize * 0.5f, 0.0f, citySize * 0.5f };
+
+	const Clock::time_point buildStart = Clock::now();
+	SceneBVH bvh;
+	bvh.Build(bounds);
+	std::cout << "  " << CULLING_OBJECT_COUNT << " objects, BVH build " << GetElapsedMilliseconds(buildStart) << " ms, " << CULLING_QUERIES << " queries per camera" << std::endl;
+
+	const CullingCamera cameras[] =
+	{
+		{ "street", Float3{ 10.0f, 2.0f, cityCenter.z + 10.0f }, Float3{ citySize, 2.0f, cityCenter.z + 10.0f }, Float3{ 0.0f, 1.0f, 0.0f } },
+		{ "overview", Float3{ -200.0f, 400.0f, -200.0f }, cityCenter, Float3{ 0.0f, 1.0f, 0.0f } },
+		{ "top-down", cityCenter + Float3{ 0.0f, 600.0f, 0.0f }, cityCenter, Float3{ 0.0f, 0.0f, 1.0f } },
+	};
+
+	const Float4x4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 2000.0f);
+	for (const CullingCamera& camera : cameras)
+	{
+		const Frustum frustum = Bounds::ExtractFrustum(projection * glm::lookAt(camera.Eye, camera.Center, camera.Up));
+
+		std::vector<uint32_t> bruteForceVisible;
+		std::vector<uint32_t> bvhVisible;
+		bruteForceVisible.reserve(CULLING_OBJECT_COUNT);
+		bvhVisible.reserve(CULLING_OBJECT_COUNT);
+
+		Clock::time_point start = Clock::now();
+		for (unsigned query = 0; query < CULLING_QUERIES; query++)
+		{
+			bruteForceVisible.clear();
+			CullBruteForce(frustum, bounds, bruteForceVisible);
+		}
+		const double bruteForceTime = GetElapsedMilliseconds(start);
+
+		start = Clock::now();
+		for (unsigned query = 0; query < CULLING_QUERIES; query++)
+		{
+			bvhVisible.clear();
+			bvh.Query(frustum, bvhVisible);
+		}
+		const double bvhTime = GetElapsedMilliseconds(start);
+
+		std::sort(bvhVisible.begin(), bvhVisible.end());
+		const double toNanosecondsPerObject = 1000000.0 / ((double)CULLING_QUERIES * CULLING_OBJECT_COUNT);
+		std::cout << "  " << std::left << std::setw(10) << camera.Name << std::right << std::setw(7) << bvhVisible.size() << " visible"
+			<< " | brute force " << bruteForceTime * toNanosecondsPerObject << " ns/object"
+			<< " | BVH " << bvhTime * toNanosecondsPerObject << " ns/object"
+			<< (bvhVisible == bruteForceVisible ? "" : " | visible sets differ") << std::endl;
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Animation
+//
+// Plays a generated animation of a few thousand nodes at 60 fps, every node has a linear translation, rotation and scale channel
+// The reference samples the same keys the straightforward way: binary search per channel, glm::slerp and glm TRS matrices
+
+static constexpr unsigned ANIMATION_NODE_COUNT = 3000;
+static constexpr unsigned ANIMATION_KEY_COUNT = 120;
+static constexpr float ANIMATION_DURATION = 4.0f;
+static constexpr unsigned ANIMATION_FRAMES = 480;
+
+struct ReferenceChannel
+{
+	uint32_t Node;
+	AnimationPath Path;
+	std::vector<float> Times;
+	std::vector<Float4> Values;
+};
+
+static Float4 SampleReferenceChannel(const ReferenceChannel& channel, float time)
+{
+	const auto nextKeyTime = std::upper_bound(channel.Times.begin(), channel.Times.end(), time);
+	const size_t key = nextKeyTime == channel.Times.begin() ? 0 : (nextKeyTime - channel.Times.begin()) - 1;
+	const size_t nextKey = std::min(key + 1, channel.Times.size() - 1);
+	const float keyDuration = channel.Times[nextKey] - channel.Times[key];
+	const float factor = keyDuration > 0.0f ? std::clamp((time - channel.Times[key]) / keyDuration, 0.0f, 1.0f) : 0.0f;
+
+	const Float4& from = channel.Values[key];
+	const Float4& to = channel.Values[nextKey];
+	if (channel.Path != AnimationPath::Rotation) return glm::mix(from, to, factor);
+
+	const glm::quat rotation = glm::slerp(glm::quat{ from.w, from.x, from.y, from.z }, glm::quat{ to.w, to.x, to.y, to.z }, factor);
+	return Float4{ rotation.x, rotation.y, rotation.z, rotation.w };
+}
+
+// Channels are sorted by node and go translation, rotation, scale
+static void ApplyReference(const std::vector<ReferenceChannel>& channels, float time, std::vector<Float4x4>& localTransforms)
+{
+	time = std::fmod(time, ANIMATION_DURATION);
+	for (size_t i = 0; i + 2 < channels.size(); i += 3)
+	{
+		const Float4 translation = SampleReferenceChannel(channels[i], time);
+		const Float4 rotation = SampleReferenceChannel(channels[i + 1], time);
+		const Float4 scale = SampleReferenceChannel(channels[i + 2], time);
+		localTransforms[channels[i].Node] = glm::translate(Float4x4{ 1.0f }, Float3{ translation })
+			* glm::mat4_cast(glm::quat{ rotation.w, rotation.x, rotation.y, rotation.z })
+			* glm::scale(Float4x4{ 1.0f }, Float3{ scale });
+	}
+}
+
+static void RunAnimation()
+{
+	std::mt19937 random{ 1 };
+	std::uniform_real_distribution<float> offsetDistribution{ -1.0f, 1.0f };
+	std::uniform_real_distribution<float> scaleDistribution{ 0.5f, 2.0f };
+
+	std::vector<float> times(ANIMATION_KEY_COUNT);
+	for (unsigned key = 0; key < ANIMATION_KEY_COUNT; key++)
+		times[key] = ANIMATION_DURATION * key / (ANIMATION_KEY_COUNT - 1);
+
+	// Four children per node keeps the nodes breadth first
+	Scene scene;
+	SceneAnimation animation{ "Benchmark" };
+	std::vector<ReferenceChannel> referenceChannels;
+	for (uint32_t i = 0; i < ANIMATION_NODE_COUNT; i++)
+	{
+		const uint32_t node = scene.AddNode("Node" + std::to_string(i), i == 0 ? Scene::InvalidNode : (i - 1) / 4, Float4x4{ 1.0f });
+		const uint32_t target = animation.AddTarget(node, Float3{ 0.0f }, Float4{ 0.0f, 0.0f, 0.0f, 1.0f }, Float3{ 1.0f });
+
+		// Keys wander from the previous ones so neighbouring rotations are closer than random quaternions
+		std::vector<Float4> translations(ANIMATION_KEY_COUNT);
+		std::vector<Float4> rotations(ANIMATION_KEY_COUNT);
+		std::vector<Float4> scales(ANIMATION_KEY_COUNT);
+		Float4 rotation = glm::normalize(Float4{ offsetDistribution(random), offsetDistribution(random), offsetDistribution(random), offsetDistribution(random) });
+		for (unsigned key = 0; key < ANIMATION_KEY_COUNT; key++)
+		{
+			translations[key] = Float4{ offsetDistribution(random), offsetDistribution(random), offsetDistribution(random), 0.0f } * 10.0f;
+			rotation = glm::normalize(rotation + 0.3f * Float4{ offsetDistribution(random), offsetDistribution(random), offsetDistribution(random), offsetDistribution(random) });
+			rotations[key] = rotation;
+			scales[key] = Float4{ scaleDistribution(random), scaleDistribution(random), scaleDistribution(random), 0.0f };
+		}
+
+		animation.AddChannel(target, AnimationPath::Translation, AnimationInterpolation::Linear, times, translations);
+		animation.AddChannel(target, AnimationPath::Rotation, AnimationInterpolation::Linear, times, rotations);
+		animation.AddChannel(target, AnimationPath::Scale, AnimationInterpolation::Linear, times, scales);
+		referenceChannels.push_back(ReferenceChannel{ node, AnimationPath::Translation, times, translations });
+		referenceChannels.push_back(ReferenceChannel{ node, AnimationPath::Rotation, times, rotations });
+		referenceChannels.push_back(ReferenceChannel{ node, AnimationPath::Scale, times, scales });
+	}
+
+	std::cout << "  " << ANIMATION_NODE_COUNT << " nodes, " << animation.GetChannelCount() << " channels with " << ANIMATION_KEY_COUNT << " keys each, "
+		<< ANIMATION_FRAMES << " frames at 60 fps" << std::endl;
+
+	std::vector<Float4x4> referenceTransforms(ANIMATION_NODE_COUNT, Float4x4{ 1.0f });
+	double animationTime = 0.0;
+	double updateTime = 0.0;
+	double referenceTime = 0.0;
+	float maxDifference = 0.0f;
+	for (unsigned frame = 0; frame < ANIMATION_FRAMES; frame++)
+	{
+		const float time = frame / 60.0f;
+
+		Clock::time_point start = Clock::now();
+		animation.Apply(time, scene);
+		animationTime += GetElapsedMilliseconds(start);
+
+		start = Clock::now();
+		scene.UpdateTransforms();
+		updateTime += GetElapsedMilliseconds(start);
+
+		start = Clock::now();
+		ApplyReference(referenceChannels, time, referenceTransforms);
+		referenceTime += GetElapsedMilliseconds(start);
+
+		for (uint32_t node = 0; node < ANIMATION_NODE_COUNT; node++)
+			for (int column = 0; column < 4; column++)
+				for (int row = 0; row < 4; row++)
+					maxDifference = std::max(maxDifference, std::abs(scene.NodeLocalTransforms[node][column][row] - referenceTransforms[node][column][row]));
+	}
+
+	std::cout << "  Animate scene                " << animationTime / ANIMATION_FRAMES << " ms per frame" << std::endl;
+	std::cout << "  Transform propagation        " << updateTime / ANIMATION_FRAMES << " ms per frame" << std::endl;
+	std::cout << "  Reference                    " << referenceTime / ANIMATION_FRAMES << " ms per frame" << std::endl;
+	std::cout << "  Max local transform element difference from the reference " << std::scientific << maxDifference << std::fixed << std::endl;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Shader preprocess
+//
+// Generates an include heavy shader library and expands it the old way and with ShaderPreprocessor
+// 30 shaders include 10 mid level headers from both stage blocks, each of those includes 5 of 20 guarded base headers
+// The old line based expansion is gone from Shader.cpp, so it is reproduced here: every include is read again and
+// expanded again, guards are left to the compiler
+// ShaderPreprocessor runs with a new instance per shader, which reads every file again, and with one instance for the
+// whole library like InitRenderResources, which reads each file once
+
+static constexpr unsigned SHADER_PREPROCESS_SHADER_COUNT = 30;
+static constexpr unsigned SHADER_PREPROCESS_MID_HEADER_COUNT = 10;
+static constexpr unsigned SHADER_PREPROCESS_BASE_HEADER_COUNT = 20;
+static constexpr unsigned SHADER_PREPROCESS_INCLUDES_PER_MID_HEADER = 5;
+static constexpr unsigned SHADER_PREPROCESS_RUNS = 5;
+static constexpr const char* SHADER_PREPROCESS_DIRECTORY = "BenchmarkShaders/";
+
+static void WriteGuardedHeader(const std::string& name, const std::vector<std::string>& includes, unsigned functionCount)
+{
+	std::string guard = name;
+	std::transform(guard.begin(), guard.end(), guard.begin(), [](char c) { return c == '.' ? '_' : (char) std::toupper(c); });
+
+	std::ofstream file{ SHADER_PREPROCESS_DIRECTORY + name };
+	file << "#ifndef " << guard << "\n#define " << guard << "\n\n";
+	for (const std::string& include : includes) file << "#include \"" << include << "\"\n";
+	for (unsigned i = 0; i < functionCount; i++)
+	{
+		const std::string function = guard + "_Function" + std::to_string(i);
+		file << "\nvec4 " << function << "(vec4 value, float weight)\n{\n    value.xyz = normalize(value.xyz) * weight;\n    return value * " << i + 1 << ".0;\n}\n";
+	}
+	file << "\n#endif // " << guard << "\n";
+}
+
+static std::vector<std::string> GenerateShaderLibrary()
+{
+	std::filesystem::create_directories(SHADER_PREPROCESS_DIRECTORY);
+
+	for (unsigned i = 0; i < SHADER_PREPROCESS_BASE_HEADER_COUNT; i++)
+		WriteGuardedHeader("Base" + std::to_string(i) + ".glsl", {}, 6);
+
+	std::vector<std::string> midHeaders;
+	for (unsigned i = 0; i < SHADER_PREPROCESS_MID_HEADER_COUNT; i++)
+	{
+		std::vector<std::string> includes;
+		for (unsigned j = 0; j < SHADER_PREPROCESS_INCLUDES_PER_MID_HEADER; j++)
+			includes.push_back("Base" + std::to_string((i * 3 + j) % SHADER_PREPROCESS_BASE_HEADER_COUNT) + ".glsl");
+
+		midHeaders.push_back("Mid" + std::to_string(i) + ".glsl");
+		WriteGuardedHeader(midHeaders.back(), includes, 4);
+	}
+
+	std::vector<std::string> shaderPaths;
+	for (unsigned i = 0; i < SHADER_PREPROCESS_SHADER_COUNT; i++)
+	{
+		shaderPaths.push_back(SHADER_PREPROCESS_DIRECTORY + std::string{ "Shader" } + std::to_string(i) + ".glsl");
+		std::ofstream file{ shaderPaths.back() };
+		file << "#version 430\n";
+		for (const char* stage : { "VERTEX", "FRAGMENT" })
+		{
+			file << "\n#ifdef " << stage << "\n\n";
+			for (const std::string& midHeader : midHeaders) file << "#include \"" << midHeader << "\"\n";
+			file << "\nvoid main()\n{\n}\n\n#endif // " << stage << "\n";
+		}
+	}
+	return shaderPaths;
+}
+
+static bool ExpandWithLineReader(std::string& output, const std::string& includeRoot, const std::string& includePath)
+{
+	const std::string filePath = std::filesystem::path{ includeRoot + includePath }.lexically_normal().string();
+	std::ifstream file{ filePath };
+	if (!file) return false;
+
+	std::vector<std::string> lines;
+	std::string line;
+	while (std::getline(file, line)) lines.push_back(line);
+
+	for (const std::string& line : lines)
+	{
+		if (line.find("#include") != std::string::npos)
+		{
+			std::string fileName = line;
+			for (const std::string& token : { std::string{ "#include" }, std::string{ " " }, std::string{ "\"" } })
+			{
+				for (size_t position = fileName.find(token); position != std::string::npos; position = fileName.find(token))
+					fileName.erase(position, token.size());
+			}
+			if (!ExpandWithLineReader(output, includeRoot, fileName)) return false;
+		}
+		else if (line.find("#version") == std::string::npos)
+		{
+			output.append(line + "\n");
+		}
+	}
+	return true;
+}
+
+static void RunShaderPreprocess()
+{
+	const std::vector<std::string> shaderPaths = GenerateShaderLibrary();
+	std::cout << "  " << SHADER_PREPROCESS_SHADER_COUNT << " shaders, " << SHADER_PREPROCESS_MID_HEADER_COUNT << " mid level headers, "
+		<< SHADER_PREPROCESS_BASE_HEADER_COUNT << " base headers, " << SHADER_PREPROCESS_RUNS << " runs" << std::endl;
+
+	std::vector<double> lineReaderTimes;
+	std::vector<double> uncachedTimes;
+	std::vector<double> cachedTimes;
+	size_t lineReaderSize = 0;
+	size_t preprocessorSize = 0;
+	for (unsigned run = 0; run < SHADER_PREPROCESS_RUNS; run++)
+	{
+		lineReaderSize = 0;
+		Clock::time_point start = Clock::now();
+		for (const std::string& path : shaderPaths)
+		{
+			std::string output;
+			const size_t rootLength = path.find_last_of("\\/") + 1;
+			ExpandWithLineReader(output, path.substr(0, rootLength), path.substr(rootLength));
+			lineReaderSize += output.size();
+		}
+		lineReaderTimes.push_back(GetElapsedMilliseconds(start));
+
+		const auto preprocess = [&shaderPaths, &preprocessorSize](bool shareCache) {
+			preprocessorSize = 0;
+			ShaderPreprocessor sharedPreprocessor;
+			for (const std::string& path : shaderPaths)
+			{
+				ShaderPreprocessor shaderPreprocessor;
+				std::vector<std::string> outputs;
+				std::vector<std::string> dependencies;
+				if (!(shareCache ? sharedPreprocessor : shaderPreprocessor).Process(path, { "VERTEX", "FRAGMENT" }, outputs, dependencies))
+				{
+					std::cout << "  [Preprocess error] " << (shareCache ? sharedPreprocessor : shaderPreprocessor).GetErrorMessage() << std::endl;
+					return false;
+				}
+				for (const std::string& output : outputs) preprocessorSize += output.size();
+			}
+			return true;
+		};
+
+		start = Clock::now();
+		if (!preprocess(false)) return;
+		uncachedTimes.push_back(GetElapsedMilliseconds(start));
+
+		start = Clock::now();
+		if (!preprocess(true)) return;
+		cachedTimes.push_back(GetElapsedMilliseconds(start));
+	}
+
+	PrintRange("old line reader, " + std::to_string(lineReaderSize / 1024) + " KB out", lineReaderTimes, "ms");
+	PrintRange("preprocessor per shader, " + std::to_string(preprocessorSize / 1024) + " KB out", uncachedTimes, "ms");
+	PrintRange("preprocessor with include cache, " + std::to_string(preprocessorSize / 1024) + " KB out", cachedTimes, "ms");
+
+	std::filesystem::remove_all(SHADER_PREPROCESS_DIRECTORY);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Migration
+//
+// Generates a version 7 text document full of removed node types and loads it, removed types are read into
+// Deprecated placeholders through REMOVED_NODE_TYPES and links to their pins are dropped while reading
+// The same document with only the node types that still exist is loaded next to it, the difference is the migration
+// Group of Float -> FloatBinaryOperator <- VarFloat, operator -> AsignFloat -> LoadTexture -> next group, 3 of 5 nodes
+// and 4 of 5 links per group are removed types
+
+static constexpr unsigned MIGRATION_GROUP_COUNT = 4000;
+static constexpr unsigned MIGRATION_RUNS = 5;
+static constexpr const char* MIGRATION_PATH = "BenchmarkMigration.rn";
+static constexpr const char* MIGRATION_KEPT_PATH = "BenchmarkMigrationKept.rn";
+
+struct MigrationNode
+{
+	EditorNodeType Type;
+	std::vector<std::string> Attributes;
+	unsigned PinCount;
+	unsigned FirstPin;
+};
+
+static void GenerateMigrationDocument(const std::string& path, unsigned groupCount, bool withRemovedTypes)
+{
+	std::vector<MigrationNode> nodes;
+	std::vector<std::pair<unsigned, unsigned>> links;
+	unsigned nextID = 1;
+	const auto addNode = [&nodes, &nextID](EditorNodeType type, std::vector<std::string> attributes, unsigned pinCount) {
+		nodes.push_back(MigrationNode{ type, std::move(attributes), pinCount, nextID + 1 });
+		nextID += 1 + pinCount;
+		return nodes.back().FirstPin;
+	};
+
+	// Pin counts of types that still exist come from the nodes, removed types have them in their old schema
+	const unsigned floatPinCount = (unsigned)FloatEditorNode{}.GetPins().size();
+	const unsigned operatorPinCount = (unsigned)FloatBinaryOperatorEditorNode{}.GetPins().size();
+
+	unsigned previousLoadPins = 0;
+	for (unsigned i = 0; i < groupCount; i++)
+	{
+		const unsigned floatPins = addNode(EditorNodeType::Float, { "NumFloats : 1", "Value0 : " + std::to_string(i % 100) }, floatPinCount);
+		const unsigned operatorPins = addNode(EditorNodeType::FloatBinaryOperator, { "OP : +" }, operatorPinCount);
+		links.emplace_back(floatPins, operatorPins);
+		if (!withRemovedTypes) continue;
+
+		const unsigned variablePins = addNode(EditorNodeType::DEPRECATED_VarFloat, {}, 2);
+		const unsigned asignPins = addNode(EditorNodeType::DEPRECATED_AsignFloat, {}, 4);
+		const unsigned loadPins = addNode(EditorNodeType::DEPRECATED_LoadTexture, { "Path : Texture" + std::to_string(i) + ".png" }, 3);
+		links.emplace_back(variablePins, operatorPins + 1);
+		links.emplace_back(operatorPins + 2, asignPins + 2);
+		links.emplace_back(asignPins + 1, loadPins);
+		if (previousLoadPins) links.emplace_back(previousLoadPins + 1, asignPins);
+		previousLoadPins = loadPins;
+	}
+
+	std::ofstream file{ path };
+	file << "Version : 7\nUseTokens : 0\nFirstID : " << nextID + links.size() + 1 << "\n";
+	file << "Count : 0\n";
+
+	file << "Count : " << nodes.size() << "\n";
+	for (const MigrationNode& node : nodes)
+	{
+		file << "Type : " << EnumToInt(node.Type) << "\n";
+		for (const std::string& attribute : node.Attributes) file << attribute << "\n";
+		file << "ID : " << node.FirstPin - 1 << "\n";
+		file << "Count : " << node.PinCount << "\n";
+		for (unsigned pin = 0; pin < node.PinCount; pin++) file << "ID : " << node.FirstPin + pin << "\n";
+		file << "Count : 0\n";
+	}
+
+	file << "Count : " << links.size() << "\n";
+	for (const auto& [start, end] : links)
+		file << "ID : " << nextID++ << "\nStart : " << start << "\nEnd : " << end << "\n";
+
+	file << "Count : " << nodes.size() << "\n";
+	for (size_t i = 0; i < nodes.size(); i++)
+		file << "ID : " << nodes[i].FirstPin - 1 << "\nPos.X : " << (i % 5) * 200 << "\nPos.Y : " << (i / 5) * 150 << "\n";
+}
+
+static bool LoadMigrationDocument(const std::string& path, unsigned& nodeCount, unsigned& linkCount)
+{
+	CustomNodeList customNodeList;
+	NodeGraph nodeGraph;
+	VariablePool variablePool;
+
+	NodeGraphSerializer serializer;
+	std::vector<CustomEditorNode*> customNodes;
+	const UniqueID firstID = serializer.Deserialize(path, nodeGraph, variablePool, customNodes);
+	for (CustomEditorNode* customNode : customNodes) customNodeList.push_back(Ptr<CustomEditorNode>(customNode));
+
+	nodeCount = nodeGraph.GetNodeCount();
+	linkCount = nodeGraph.GetLinkCount();
+	return firstID != 0;
+}
+
+static void RunMigration()
+{
+	GenerateMigrationDocument(MIGRATION_PATH, MIGRATION_GROUP_COUNT, true);
+	GenerateMigrationDocument(MIGRATION_KEPT_PATH, MIGRATION_GROUP_COUNT, false);
+
+	std::vector<double> migrationTimes;
+	std::vector<double> keptTimes;
+	unsigned nodeCount = 0;
+	unsigned linkCount = 0;
+	unsigned keptNodeCount = 0;
+	unsigned keptLinkCount = 0;
+	for (unsigned run = 0; run < MIGRATION_RUNS; run++)
+	{
+		Clock::time_point start = Clock::now();
+		if (!LoadMigrationDocument(MIGRATION_PATH, nodeCount, linkCount))
+		{
+			std::cout << "  [Load error] " << MIGRATION_PATH << std::endl;
+			return;
+		}
+		migrationTimes.push_back(GetElapsedMilliseconds(start));
+
+		start = Clock::now();
+		if (!LoadMigrationDocument(MIGRATION_KEPT_PATH, keptNodeCount, keptLinkCount))
+		{
+			std::cout << "  [Load error] " << MIGRATION_KEPT_PATH << std::endl;
+			return;
+		}
+		keptTimes.push_back(GetElapsedMilliseconds(start));
+	}
+
+	std::cout << "  version 7, " << MIGRATION_GROUP_COUNT << " groups, " << MIGRATION_RUNS << " runs" << std::endl;
+	PrintRange("with removed types, " + std::to_string(nodeCount) + " nodes " + std::to_string(linkCount) + " links", migrationTimes, "ms");
+	PrintRange("without them, " + std::to_string(keptNodeCount) + " nodes " + std::to_string(keptLinkCount) + " links", keptTimes, "ms");
+
+	std::filesystem::remove(MIGRATION_PATH);
+	std::filesystem::remove(MIGRATION_KEPT_PATH);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct Benchmark
+{
+	const char* Name;
+	const char* Description;
+	void (*Run)();
+};
+
+static const Benchmark Benchmarks[] =
+{
+	{ "text-load", "generated 100k node .rn document, old line stream reader vs mapped file parser in MB/s", RunTextLoad },
+	{ "culling", "generated city of 100k objects, BVH frustum query vs testing every object in ns/object", RunCulling },
+	{ "animation", "generated 3000 node animation with 9000 channels played at 60 fps vs binary search and glm slerp", RunAnimation },
+	{ "shader-preprocess", "generated include heavy shader library, old line reader vs preprocessor with and without include cache", RunShaderPreprocess },
+	{ "migration", "generated version 7 document with removed node types, load with migration vs the same document without them", RunMigration },
+};
+
+namespace HeadlessBenchmarks
+{
+	bool Run(const std::string& name)
+	{
+		bool found = false;
+		std::cout << std::fixed << std::setprecision(2);
+		for (const Benchmark& benchmark : Benchmarks)
+		{
+			if (name != "all" && name != benchmark.Name) continue;
+
+			found = true;
+			std::cout << "[Benchmark] " << benchmark.Name << std::endl;
+			benchmark.Run();
+
+			AppConsole& console = App::Get()->GetConsole();
+			std::cout << console.GetText();
+			console.Clear();
+		}
+		return found;
+	}
+
+	void PrintNames()
+	{
+		std::cout << "Benchmarks:" << std::endl;
+		for (const Benchmark& benchmark : Benchmarks)
+			std::cout << "  " << benchmark.Name << " - " << benchmark.Description << std::endl;
+	}
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+// Benchmarks of the headless target, run with: RenderNodesHeadless --bench <name>
+// Every benchmark generates its own input, so numbers can be reproduced on any machine
+namespace HeadlessBenchmarks
+{
+	// Returns false if there is no benchmark with that name, "all" runs every one of them
+	bool Run(const std::string& name);
+
+	void PrintNames();
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "HeadlessBenchmarks.h"
+#include "App/App.h"
+#include "Execution/ExecutorNode.h"
+#include "NodeGraph/NodeGraph.h"
+#include "NodeGraph/NodeGraphCompiler.h"
+#include "NodeGraph/NodeGraphSerializer.h"
+
+// Entry point of the headless target, it loads and compiles documents without a window
+// Usage: RenderNodesHeadless <document or folder>...
+//        RenderNodesHeadless --bench <benchmark or all>
+// Folders are searched recursively, exit code is 1 if any document fails to load or compile
+
+using Clock = std::chrono::steady_clock;
+
+struct DocumentReport
+{
+	bool Loaded = false;
+	unsigned CompileErrors = 0;
+
+	double LoadTime = 0.0;
+	double CompileTime = 0.0;
+
+	unsigned NodeCount = 0;
+	unsigned LinkCount = 0;
+	unsigned CustomNodeCount = 0;
+	unsigned ExecutorNodeCount = 0;
+	unsigned ValueNodeCount = 0;
+};
+
+static double GetElapsedMilliseconds(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static bool IsDocument(const std::filesystem::path& path)
+{
+	const std::string extension = path.extension().string();
+	return extension == NodeGraphSerializer::TEXT_EXTENSION || extension == NodeGraphSerializer::BINARY_EXTENSION || extension == NodeGraphSerializer::JOURNAL_EXTENSION;
+}
+
+static void CollectDocuments(const std::string& path, std::vector<std::string>& documents)
+{
+	std::error_code error;
+	if (!std::filesystem::is_directory(path, error))
+	{
+		documents.push_back(path);
+		return;
+	}
+
+	std::vector<std::string> folderDocuments;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(path, error))
+	{
+		if (entry.is_regular_file() && IsDocument(entry.path())) folderDocuments.push_back(entry.path().string());
+	}
+	std::sort(folderDocuments.begin(), folderDocuments.end());
+	documents.insert(documents.end(), folderDocuments.begin(), folderDocuments.end());
+}
+
+static void DeletePipeline(CompiledPipeline& pipeline)
+{
+	delete pipeline.OnStartNode;
+	delete pipeline.OnUpdateNode;
+	for (auto& it : pipeline.OnKeyPressedNodes) delete it.second;
+	for (auto& it : pipeline.OnKeyReleasedNodes) delete it.second;
+	for (auto& it : pipeline.OnKeyDownNodes) delete it.second;
+	pipeline = {};
+}
+
+// Messages logged while loading or compiling go to the console, they are printed under the document
+static void FlushConsole()
+{
+	AppConsole& console = App::Get()->GetConsole();
+	if (console.GetText().empty()) return;
+
+	std::cout << console.GetText();
+	console.Clear();
+}
+
+static DocumentReport ProcessDocument(const std::string& path)
+{
+	DocumentReport report{};
+
+	// Custom nodes are declared first so the graph with their instances goes away before them
+	CustomNodeList customNodeList;
+	NodeGraph nodeGraph;
+	VariablePool variablePool;
+
+	const Clock::time_point loadStart = Clock::now();
+	{
+		NodeGraphSerializer serializer;
+		std::vector<CustomEditorNode*> customNodes;
+		const UniqueID firstID = serializer.Deserialize(path, nodeGraph, variablePool, customNodes);
+		for (CustomEditorNode* customNode : customNodes) customNodeList.push_back(Ptr<CustomEditorNode>(customNode));
+
+		if (!firstID) return report;
+		IDGen::Init(firstID);
+
+		NodeGraphSerializer::LoadInstancedCustomNodeGraphs(nodeGraph);
+		nodeGraph.RefreshNodes(variablePool);
+	}
+	report.LoadTime = GetElapsedMilliseconds(loadStart);
+	report.Loaded = true;
+	report.NodeCount = nodeGraph.GetNodeCount();
+	report.LinkCount = nodeGraph.GetLinkCount();
+	report.CustomNodeCount = (unsigned)customNodeList.size();
+
+	const unsigned executorNodesBefore = CompiledNodeCounters::ExecutorNodes;
+	const unsigned valueNodesBefore = CompiledNodeCounters::ValueNodes;
+	const Clock::time_point compileStart = Clock::now();
+
+	NodeGraphCompiler compiler;
+	CompiledPipeline pipeline = compiler.Compile(nodeGraph, variablePool);
+
+	report.CompileTime = GetElapsedMilliseconds(compileStart);
+	report.ExecutorNodeCount = CompiledNodeCounters::ExecutorNodes - executorNodesBefore;
+	report.ValueNodeCount = CompiledNodeCounters::ValueNodes - valueNodesBefore;
+	report.CompileErrors = (unsigned)compiler.GetCompileErrors().size();
+
+	for (const auto& err : compiler.GetCompileErrors())
+		App::Get()->GetConsole().Log("[Compilation error] " + err.Message + " (node " + std::to_string(err.Node) + ")");
+
+	DeletePipeline(pipeline);
+	return report;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc == 3 && std::string{ argv[1] } == "--bench")
+	{
+		const bool found = HeadlessBenchmarks::Run(argv[2]);
+		if (!found) HeadlessBenchmarks::PrintNames();
+
+		App::Destroy();
+		return found ? 0 : 1;
+	}
+
+	std::vector<std::string> documents;
+	for (int i = 1; i < argc; i++) CollectDocuments(argv[i], documents);
+
+	if (documents.empty())
+	{
+		std::cout << "Usage: RenderNodesHeadless <document or folder>..." << std::endl;
+		std::cout << "       RenderNodesHeadless --bench <benchmark or all>" << std::endl;
+		HeadlessBenchmarks::PrintNames();
+		return 1;
+	}
+
+	unsigned loadFailures = 0;
+	unsigned compileFailures = 0;
+	double totalLoadTime = 0.0;
+	double totalCompileTime = 0.0;
+
+	std::cout << std::fixed << std::setprecision(2);
+	for (const std::string& path : documents)
+	{
+		const DocumentReport report = ProcessDocument(path);
+
+		if (!report.Loaded)
+		{
+			loadFailures++;
+			std::cout << "[Load error] " << path << std::endl;
+			FlushConsole();
+			continue;
+		}
+
+		if (report.CompileErrors) compileFailures++;
+		totalLoadTime += report.LoadTime;
+		totalCompileTime += report.CompileTime;
+
+		std::cout << (report.CompileErrors ? "[Compile error] " : "[OK] ") << path
+			<< " | load " << report.LoadTime << " ms"
+			<< " | compile " << report.CompileTime << " ms"
+			<< " | nodes " << report.NodeCount
+			<< " | links " << report.LinkCount
+			<< " | custom nodes " << report.CustomNodeCount
+			<< " | executor nodes " << report.ExecutorNodeCount
+			<< " | value nodes " << report.ValueNodeCount << std::endl;
+		FlushConsole();
+	}
+
+	std::cout << documents.size() << " documents"
+		<< " | load errors " << loadFailures
+		<< " | compile errors " << compileFailures
+		<< " | load " << totalLoadTime << " ms"
+		<< " | compile " << totalCompileTime << " ms" << std::endl;
+
+	App::Destroy();
+	return loadFailures || compileFailures ? 1 : 0;
+}
@@ -4,7 +4,8 @@
 
 #include "Common.h"
 
-using UniqueID = uintptr_t;
+// IDs are 32 bit, documents store them that way and flat ID keyed containers stay compact
+using UniqueID = uint32_t;
 using NodeID = UniqueID;
 using PinID = UniqueID;
 using LinkID = UniqueID;
@@ -16,6 +17,11 @@ namespace IDGen
 
 	static constexpr UniqueID ReservedIDs = 1024;
 
+	// Graphs read on worker threads take IDs from a per thread counter in the upper half of the range,
+	// so they don't depend on scheduling. Those IDs are replaced with real ones in a single threaded pass
+	static constexpr UniqueID ProvisionalIDs = (UniqueID)1 << (sizeof(UniqueID) * 8 - 1);
+	extern thread_local UniqueID ProvisionalAllocator;
+
 	inline void Init(UniqueID initialValue)
 	{
 		initialValue = std::max((UniqueID) ReservedIDs, initialValue);
@@ -24,6 +30,21 @@ namespace IDGen
 
 	inline UniqueID Generate()
 	{
-		return Allocator.fetch_add(1);
+		if (ProvisionalAllocator) return ProvisionalAllocator++;
+
+		const UniqueID id = Allocator.fetch_add(1);
+		ASSERT_M(id < ProvisionalIDs, "Ran out of unique IDs!");
+		return id;
 	}
+
+	inline bool IsProvisional(UniqueID id)
+	{
+		return id >= ProvisionalIDs;
+	}
+
+	struct ScopedProvisionalIDs
+	{
+		ScopedProvisionalIDs() { ProvisionalAllocator = ProvisionalIDs; }
+		~ScopedProvisionalIDs() { ProvisionalAllocator = 0; }
+	};
 }
\ No newline at end of file
@@ -15,6 +15,18 @@ void NodeGraph::AddNode(EditorNode* node)
     m_Nodes[node->GetID()] = Ptr<EditorNode>(node);
 }
 
+void NodeGraph::AddNodes(const std::vector<EditorNode*>& nodes)
+{
+    // Nodes read from older documents are not in ID order, they are sorted once instead of inserted one by one
+    std::vector<IDMap<Ptr<EditorNode>>::Entry> entries;
+    entries.reserve(m_Nodes.size() + nodes.size());
+    for (auto& it : m_Nodes)
+        entries.emplace_back(it.first, std::move(it.second));
+    for (EditorNode* node : nodes)
+        entries.emplace_back(node->GetID(), Ptr<EditorNode>(node));
+    m_Nodes.Assign(std::move(entries));
+}
+
 void NodeGraph::ReplaceNode(NodeID nodeID, EditorNode* node)
 {
     ASSERT(node->GetID() == nodeID);
@@ -38,17 +50,17 @@ void NodeGraph::ReplacePinLinks(PinID oldPin, PinID newPin)
 
 void NodeGraph::AddLink(const EditorNodeLink& link)
 {
+    const auto& endPin = GetPinByID(link.End);
+    const auto& startPin = GetPinByID(link.Start);
     for (const auto& it : m_Links)
     {
         const auto& l = it.second;
-        const auto& endPin = GetPinByID(link.End);
         if (endPin.Type != PinType::Execution && l.End == link.End)
         {
             m_Links.erase(it.first);
             break;
         }
 
-        const auto& startPin = GetPinByID(link.Start);
         if (startPin.Type == PinType::Execution && l.Start == link.Start)
         {
             m_Links.erase(it.first);
@@ -252,6 +264,16 @@ void NodeGraph::RefreshNodes(const VariablePool& variablePool)
 	}
 }
 
+bool NodeGraph::ResolveDeferredLoad()
+{
+    if (!m_DeferredLoad) return true;
+
+    // Loader is cleared first since reading the graph goes through this graph again
+    const std::function<bool(NodeGraph&)> load = std::move(m_DeferredLoad);
+    m_DeferredLoad = nullptr;
+    return load(*this);
+}
+
 void NodeGraph::RefreshNode(EditorNode* editorNode, const VariablePool& variablePool)
 {
 	switch (editorNode->GetType())
@@ -1,7 +1,9 @@
 #pragma once
 
-#include <unordered_map>
+#include <functional>
+#include <vector>
 
+#include "../Util/IDMap.h"
 #include "../Editor/EditorNode.h"
 #include "../Editor/ExecutorEditorNode.h"
 #include "../Editor/EvaluationEditorNode.h"
@@ -13,6 +15,7 @@ public:
 public:
 
     void AddNode(EditorNode* node);
+    void AddNodes(const std::vector<EditorNode*>& nodes);
     void ReplaceNode(NodeID nodeID, EditorNode* node);
     void ReplacePinLinks(PinID oldPin, PinID newPin);
     void AddLink(const EditorNodeLink& link);
@@ -65,12 +68,20 @@ public:
     unsigned GetNodeCount() const { return m_Nodes.size(); }
     unsigned GetLinkCount() const { return m_Links.size(); }
 
-    const std::unordered_map<NodeID, ImVec2>& GetNodePositions() const { return m_NodePositions; }
-    void SetNodePositions(const std::unordered_map<NodeID, ImVec2>& nodePositions) { m_NodePositions = nodePositions; }
+    const IDMap<ImVec2>& GetNodePositions() const { return m_NodePositions; }
+    void SetNodePositions(IDMap<ImVec2>&& nodePositions) { m_NodePositions = std::move(nodePositions); }
+
+    // Custom node graphs from binary documents are read on first use, graph stays empty until it is resolved
+    void SetDeferredLoad(std::function<bool(NodeGraph&)> load) { m_DeferredLoad = std::move(load); }
+    bool HasDeferredLoad() const { return (bool) m_DeferredLoad; }
+    const std::function<bool(NodeGraph&)>& GetDeferredLoad() const { return m_DeferredLoad; }
+    bool ResolveDeferredLoad();
 
 private:
-    std::unordered_map<NodeID, Ptr<EditorNode>> m_Nodes;
-    std::unordered_map<LinkID, EditorNodeLink> m_Links;
+    IDMap<Ptr<EditorNode>> m_Nodes;
+    IDMap<EditorNodeLink> m_Links;
+
+    IDMap<ImVec2> m_NodePositions;
 
-    std::unordered_map<NodeID, ImVec2> m_NodePositions;
+    std::function<bool(NodeGraph&)> m_DeferredLoad;
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "NodeGraphCompiler.h"
 
+#include <algorithm>
+
 #include "../Execution/ExecutorNode.h"
 #include "../Editor/EditorNode.h"
 #include "../Editor/RenderPipelineEditor.h"
@@ -88,7 +90,10 @@ CompiledPipeline NodeGraphCompiler::Compile(const NodeGraph& graph, const Variab
 
 	CompiledPipeline pipeline{};
 	pipeline.OnStartNode = Compile(GetNodeGraph()->GetOnStartNode(), context);
+
+	context.InFrame = true;
 	pipeline.OnUpdateNode = Compile(GetNodeGraph()->GetOnUpdateNode(), context);
+	context.InFrame = false;
 
 	const auto compileInputNodes = [this, &graph, &context](
 		EditorNodeType nodeType,
@@ -120,8 +125,8 @@ CompiledPipeline NodeGraphCompiler::Compile(const NodeGraph& graph, const Variab
 
 	m_ContextStack.pop();
 
-	pipeline.EditorLinks = context.EditorLinks;
 	pipeline.VariablePool = variablePool;
+	pipeline.TransientTextures = ComputeTransientTextures(context, variablePool);
 	return pipeline;
 }
 
@@ -131,6 +136,9 @@ ExecutorNode* NodeGraphCompiler::Compile(ExecutionEditorNode* executorNode, Cont
 	ExecutorNode* currentNode = firstNode;
 	ExecutionEditorNode* currentEditorNode = executorNode;
 
+	// Nodes after an If node only run when the condition passes
+	const bool wasConditional = context.Conditional;
+
 	while (currentEditorNode)
 	{
 		ExecutorNode* nextNode = CompileExecutorNode(currentEditorNode, context);
@@ -138,6 +146,8 @@ ExecutorNode* NodeGraphCompiler::Compile(ExecutionEditorNode* executorNode, Cont
 		currentNode = nextNode;
 		currentEditorNode = GetNextExecutorNode(currentEditorNode);
 	}
+
+	context.Conditional = wasConditional;
 	return firstNode;
 }
 
@@ -146,6 +156,7 @@ ExecutorNode* NodeGraphCompiler::Compile(ExecutionEditorNode* executorNode, Cont
 ExecutorNode* NodeGraphCompiler::CompileExecutorNode(ExecutionEditorNode* executorNode, Context& context)
 {
 	ExecutorNode* compiledNode = nullptr;
+	context.Step++;
 	switch (executorNode->GetType())
 	{
 		COMPILE_NODE(Print, CompilePrintNode, PrintEditorNode);
@@ -153,7 +164,13 @@ ExecutorNode* NodeGraphCompiler::CompileExecutorNode(ExecutionEditorNode* execut
 		COMPILE_NODE(ClearRenderTarget, CompileClearRenderTargetNode, ClearRenderTargetEditorNode);
 		COMPILE_NODE(PresentTexture, CompilePresentTextureTargetNode, PresentTextureEditorNode);
 		COMPILE_NODE(DrawMesh, CompileDrawMeshNode, DrawMeshEditorNode);
+		COMPILE_NODE(DispatchCompute, CompileDispatchComputeNode, DispatchComputeEditorNode);
+		COMPILE_NODE(CullScene, CompileCullSceneNode, CullSceneEditorNode);
+		COMPILE_NODE(DrawSceneIndirect, CompileDrawSceneIndirectNode, DrawSceneIndirectEditorNode);
+		COMPILE_NODE(SetSceneNodeTransform, CompileSetSceneNodeTransformNode, SetSceneNodeTransformEditorNode);
+		COMPILE_NODE(AnimateScene, CompileAnimateSceneNode, AnimateSceneEditorNode);
 		COMPILE_NODE(ForEachSceneObject, CompileForEachSceneObjectNode, ForEachSceneObjectEditorNode);
+		COMPILE_NODE(ForEachVisibleSceneObject, CompileForEachVisibleSceneObjectNode, ForEachVisibleSceneObjectEditorNode);
 		COMPILE_NODE(AsignVariable, CompileAsignVariableNode, AsignVariableEditorNode);
 		COMPILE_NODE(OnStart, CompileEmptyNode, ExecutionEditorNode);
 		COMPILE_NODE(OnUpdate, CompileEmptyNode, ExecutionEditorNode);
@@ -168,7 +185,7 @@ ExecutorNode* NodeGraphCompiler::CompileExecutorNode(ExecutionEditorNode* execut
 		NOT_IMPLEMENTED;
 	}
 
-	context.EditorLinks[compiledNode] = executorNode->GetID();
+	compiledNode->SetEditorNode(executorNode->GetID());
 
 	return compiledNode;
 }
@@ -178,6 +195,7 @@ ExecutorNode* NodeGraphCompiler::CompileIfNode(IfEditorNode* ifNode, Context& co
 	PinEvaluator pinEvaluator{ m_ContextStack };
 
 	BoolValueNode* conditionNode = pinEvaluator.EvaluateBool(ifNode->GetConditionPin());
+	context.Conditional = true;
 	
 	ExecutorNode* elseBranch = nullptr;
 	if (const NodeID elsePinInput = GetNodeGraph()->GetInputPinFromOutput(ifNode->GetExecutionElse().ID))
@@ -254,6 +272,8 @@ ExecutorNode* NodeGraphCompiler::CompileAsignVariableNode(AsignVariableEditorNod
 	case VariableType::Shader:
 	case VariableType::Texture:
 	case VariableType::Scene:
+	case VariableType::Sampler:
+	case VariableType::Buffer:
 		ASSERT_M(0, "Tring to compile AsignVariableEditorNode for the variable types that shouldn't be asigned.");
 		break;
 	case VariableType::Invalid:
@@ -270,6 +290,7 @@ ExecutorNode* NodeGraphCompiler::CompileClearRenderTargetNode(ClearRenderTargetE
 	PinEvaluator pinEvaluator{ m_ContextStack };
 	TextureValueNode* textureNode = pinEvaluator.EvaluateTexture(clearRtNode->GetTargeteTexturePin());
 	Float4ValueNode* clearColorNode = pinEvaluator.EvaluateFloat4(clearRtNode->GetClearColorPin());
+	RecordTextureUses(pinEvaluator.TakeEvaluatedTextures(), true, context);
 	return new ClearRenderTargetExecutorNode{ textureNode, clearColorNode };
 }
 
@@ -277,6 +298,11 @@ ExecutorNode* NodeGraphCompiler::CompilePresentTextureTargetNode(PresentTextureE
 {
 	PinEvaluator pinEvaluator{ m_ContextStack };
 	TextureValueNode* textureNode = pinEvaluator.EvaluateTexture(presentTextureNode->GetTexturePin());
+
+	// Presented texture is read after the frame ends
+	for (const VariableID textureID : pinEvaluator.TakeEvaluatedTextures())
+		context.PersistentTextures.insert(textureID);
+
 	return new PresentTextureExecutorNode{ textureNode };
 }
 
@@ -288,35 +314,183 @@ ExecutorNode* NodeGraphCompiler::CompileDrawMeshNode(DrawMeshEditorNode* drawMes
 	MeshValueNode* meshNode = pinEvaluator.EvaluateMesh(drawMeshNode->GetMeshPin());
 	BindTableValueNode* bindTableNode = pinEvaluator.EvaluatePinOptional<BindTableValueNode, &PinEvaluator::EvaluateBindTable>(drawMeshNode->GetBindTablePin());
 	RenderStateValueNode* renderStateNode = pinEvaluator.EvaluatePinOptional<RenderStateValueNode, &PinEvaluator::EvaluateRenderState>(drawMeshNode->GetRenderStatePin());
+	RecordTextureUses(pinEvaluator.TakeEvaluatedTextures(), false, context);
 
 	return new DrawMeshExecutorNode{ framebufferNode, shaderNode, meshNode, bindTableNode, renderStateNode };
 }
 
-ExecutorNode* NodeGraphCompiler::CompileForEachSceneObjectNode(ForEachSceneObjectEditorNode* forEachSceneObjectNode, Context& context)
+ExecutorNode* NodeGraphCompiler::CompileDispatchComputeNode(DispatchComputeEditorNode* dispatchComputeNode, Context& context)
+{
+	PinEvaluator pinEvaluator{ m_ContextStack };
+	ShaderValueNode* shaderNode = pinEvaluator.EvaluateShader(dispatchComputeNode->GetShaderPin());
+	IntValueNode* groupCountXNode = pinEvaluator.EvaluateInt(dispatchComputeNode->GetGroupCountXPin());
+	IntValueNode* groupCountYNode = pinEvaluator.EvaluateInt(dispatchComputeNode->GetGroupCountYPin());
+	IntValueNode* groupCountZNode = pinEvaluator.EvaluateInt(dispatchComputeNode->GetGroupCountZPin());
+	BindTableValueNode* bindTableNode = pinEvaluator.EvaluatePinOptional<BindTableValueNode, &PinEvaluator::EvaluateBindTable>(dispatchComputeNode->GetBindTablePin());
+	RecordTextureUses(pinEvaluator.TakeEvaluatedTextures(), false, context);
+
+	return new DispatchComputeExecutorNode{ shaderNode, groupCountXNode, groupCountYNode, groupCountZNode, bindTableNode };
+}
+
+ExecutorNode* NodeGraphCompiler::CompileCullSceneNode(CullSceneEditorNode* cullSceneNode, Context& context)
+{
+	PinEvaluator pinEvaluator{ m_ContextStack };
+	SceneValueNode* sceneNode = pinEvaluator.EvaluateScene(cullSceneNode->GetScenePin());
+	Float4x4ValueNode* viewProjectionNode = pinEvaluator.EvaluateFloat4x4(cullSceneNode->GetViewProjectionPin());
+
+	return new CullSceneExecutorNode{ sceneNode, viewProjectionNode };
+}
+
+ExecutorNode* NodeGraphCompiler::CompileSetSceneNodeTransformNode(SetSceneNodeTransformEditorNode* setNodeTransformNode, Context& context)
+{
+	PinEvaluator pinEvaluator{ m_ContextStack };
+	SceneValueNode* sceneNode = pinEvaluator.EvaluateScene(setNodeTransformNode->GetScenePin());
+	StringValueNode* nodeNameNode = pinEvaluator.EvaluateString(setNodeTransformNode->GetNodeNamePin());
+	Float4x4ValueNode* transformNode = pinEvaluator.EvaluateFloat4x4(setNodeTransformNode->GetTransformPin());
+
+	return new SetSceneNodeTransformExecutorNode{ sceneNode, nodeNameNode, transformNode };
+}
+
+ExecutorNode* NodeGraphCompiler::CompileAnimateSceneNode(AnimateSceneEditorNode* animateSceneNode, Context& context)
+{
+	PinEvaluator pinEvaluator{ m_ContextStack };
+	SceneValueNode* sceneNode = pinEvaluator.EvaluateScene(animateSceneNode->GetScenePin());
+	IntValueNode* animationNode = pinEvaluator.EvaluateInt(animateSceneNode->GetAnimationPin());
+	FloatValueNode* timeNode = pinEvaluator.EvaluateFloat(animateSceneNode->GetTimePin());
+
+	return new AnimateSceneExecutorNode{ sceneNode, animationNode, timeNode };
+}
+
+ExecutorNode* NodeGraphCompiler::CompileDrawSceneIndirectNode(DrawSceneIndirectEditorNode* drawSceneNode, Context& context)
 {
 	PinEvaluator pinEvaluator{ m_ContextStack };
+	TextureValueNode* framebufferNode = pinEvaluator.EvaluateTexture(drawSceneNode->GetFrameBufferPin());
+	ShaderValueNode* shaderNode = pinEvaluator.EvaluateShader(drawSceneNode->GetShaderPin());
+	SceneValueNode* sceneNode = pinEvaluator.EvaluateScene(drawSceneNode->GetScenePin());
+	BindTableValueNode* bindTableNode = pinEvaluator.EvaluatePinOptional<BindTableValueNode, &PinEvaluator::EvaluateBindTable>(drawSceneNode->GetBindTablePin());
+	RenderStateValueNode* renderStateNode = pinEvaluator.EvaluatePinOptional<RenderStateValueNode, &PinEvaluator::EvaluateRenderState>(drawSceneNode->GetRenderStatePin());
+	RecordTextureUses(pinEvaluator.TakeEvaluatedTextures(), false, context);
+
+	return new DrawSceneIndirectExecutorNode{ framebufferNode, shaderNode, sceneNode, bindTableNode, renderStateNode };
+}
 
-	const NodeID executionLoopOutput = GetNodeGraph()->GetInputPinFromOutput(forEachSceneObjectNode->GetLoopPin().ID);
+ExecutorNode* NodeGraphCompiler::CompileLoopBody(const EditorNodePin& loopPin, Context& context)
+{
+	const NodeID executionLoopOutput = GetNodeGraph()->GetInputPinFromOutput(loopPin.ID);
 	if (!executionLoopOutput)
-		return new EmptyExecutorNode{};
+		return nullptr;
 
 	EditorNode* executionLoopFirstNode = GetNodeGraph()->GetPinOwner(executionLoopOutput);
 	ExecutionEditorNode* exExecutionLoopFirstNode = dynamic_cast<ExecutionEditorNode*>(executionLoopFirstNode);
 	ASSERT(exExecutionLoopFirstNode);
 
 	if (!exExecutionLoopFirstNode)
-		return new EmptyExecutorNode{};
+		return nullptr;
 
-	SceneValueNode* sceneNode = pinEvaluator.EvaluateScene(forEachSceneObjectNode->GetScenePin());
+	// Loop body may run any number of times, so everything used in it stays alive for the whole loop
+	const unsigned loopStart = context.Step;
+	const bool wasConditional = context.Conditional;
+	context.Conditional = true;
 
 	const auto contextStack = m_ContextStack;
 	ExecutorNode* executionLoopNode = Compile(exExecutionLoopFirstNode, context);
 	m_ContextStack = contextStack;
 
+	context.Conditional = wasConditional;
+	ExtendTextureLifetimes(loopStart, context.Step, context);
+
+	return executionLoopNode;
+}
+
+ExecutorNode* NodeGraphCompiler::CompileForEachSceneObjectNode(ForEachSceneObjectEditorNode* forEachSceneObjectNode, Context& context)
+{
+	ExecutorNode* executionLoopNode = CompileLoopBody(forEachSceneObjectNode->GetLoopPin(), context);
+	if (!executionLoopNode)
+		return new EmptyExecutorNode{};
+
+	PinEvaluator pinEvaluator{ m_ContextStack };
+	SceneValueNode* sceneNode = pinEvaluator.EvaluateScene(forEachSceneObjectNode->GetScenePin());
+
 	return new ForEachSceneObjectExecutorNode{ sceneNode, forEachSceneObjectNode->GetSceneObjectPin().ID, executionLoopNode };
 }
 
+ExecutorNode* NodeGraphCompiler::CompileForEachVisibleSceneObjectNode(ForEachVisibleSceneObjectEditorNode* forEachVisibleSceneObjectNode, Context& context)
+{
+	ExecutorNode* executionLoopNode = CompileLoopBody(forEachVisibleSceneObjectNode->GetLoopPin(), context);
+	if (!executionLoopNode)
+		return new EmptyExecutorNode{};
+
+	PinEvaluator pinEvaluator{ m_ContextStack };
+	SceneValueNode* sceneNode = pinEvaluator.EvaluateScene(forEachVisibleSceneObjectNode->GetScenePin());
+	Float4x4ValueNode* viewProjectionNode = pinEvaluator.EvaluateFloat4x4(forEachVisibleSceneObjectNode->GetViewProjectionPin());
+
+	return new ForEachVisibleSceneObjectExecutorNode{ sceneNode, viewProjectionNode, forEachVisibleSceneObjectNode->GetSceneObjectPin().ID, executionLoopNode };
+}
+
 ExecutorNode* NodeGraphCompiler::CompileEmptyNode(ExecutionEditorNode* node, Context& context)
 {
 	return new EmptyExecutorNode{};
+}
+
+void NodeGraphCompiler::RecordTextureUses(const std::vector<VariableID>& textures, bool clear, Context& context)
+{
+	for (const VariableID textureID : textures)
+	{
+		if (!context.InFrame)
+		{
+			context.PersistentTextures.insert(textureID);
+			continue;
+		}
+
+		const auto it = context.FrameTextureUses.find(textureID);
+		if (it == context.FrameTextureUses.end())
+		{
+			TextureUse use;
+			use.FirstUse = context.Step;
+			use.LastUse = context.Step;
+			use.ClearedInFrame = clear && !context.Conditional;
+			context.FrameTextureUses[textureID] = use;
+		}
+		else
+		{
+			it->second.LastUse = context.Step;
+		}
+	}
+}
+
+void NodeGraphCompiler::ExtendTextureLifetimes(unsigned firstStep, unsigned lastStep, Context& context)
+{
+	for (auto& it : context.FrameTextureUses)
+	{
+		TextureUse& use = it.second;
+		if (use.LastUse < firstStep) continue;
+
+		use.FirstUse = std::min(use.FirstUse, firstStep);
+		use.LastUse = std::max(use.LastUse, lastStep);
+	}
+}
+
+std::vector<TransientTextureLifetime> NodeGraphCompiler::ComputeTransientTextures(const Context& context, const VariablePool& variablePool)
+{
+	std::vector<TransientTextureLifetime> transientTextures;
+	for (const auto& it : context.FrameTextureUses)
+	{
+		const VariableID textureID = it.first;
+		const TextureUse& use = it.second;
+
+		if (!use.ClearedInFrame || context.PersistentTextures.count(textureID)) continue;
+
+		const Variable& variable = variablePool.GetRef(textureID);
+		if (variable.Type != VariableType::Texture) continue;
+
+		const TextureData& texData = variable.Get<TextureData>();
+		if (!texData.Framebuffer || !texData.Path.empty()) continue;
+
+		TransientTextureLifetime lifetime;
+		lifetime.Texture = textureID;
+		lifetime.FirstUse = use.FirstUse;
+		lifetime.LastUse = use.LastUse;
+		transientTextures.push_back(lifetime);
+	}
+	return transientTextures;
 }
\ No newline at end of file
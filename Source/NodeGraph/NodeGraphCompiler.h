@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 #include <stack>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "../Editor/EditorNode.h"
 #include "../Editor/ExecutorEditorNode.h"
@@ -21,9 +23,23 @@ class NodeGraphCompiler
 		NodeID Node;
 	};
 
+	struct TextureUse
+	{
+		unsigned FirstUse = 0;
+		unsigned LastUse = 0;
+
+		// First use in the frame is unconditional clear, so the content of the previous frame isn't needed
+		bool ClearedInFrame = false;
+	};
+
 	struct Context
 	{
-		std::unordered_map<ExecutorNode*, NodeID> EditorLinks;
+		// Render target lifetime analysis
+		bool InFrame = false;
+		bool Conditional = false;
+		unsigned Step = 0;
+		std::unordered_map<VariableID, TextureUse> FrameTextureUses;
+		std::unordered_set<VariableID> PersistentTextures;
 	};
 
 public:
@@ -36,6 +52,7 @@ private:
 	ExecutorNode* Compile(ExecutionEditorNode* executorNode, Context& context);
 	ExecutorNode* CompileExecutorNode(ExecutionEditorNode* executorNode, Context& context);
 
+	ExecutorNode* CompileLoopBody(const EditorNodePin& loopPin, Context& context);
 	ExecutorNode* CompileEmptyNode(ExecutionEditorNode* node, Context& context);
 	ExecutorNode* CompileIfNode(IfEditorNode* ifNode, Context& context);
 	ExecutorNode* CompilePrintNode(PrintEditorNode* printNode, Context& context);
@@ -43,7 +60,17 @@ private:
 	ExecutorNode* CompileClearRenderTargetNode(ClearRenderTargetEditorNode* clearRtNode, Context& context);
 	ExecutorNode* CompilePresentTextureTargetNode(PresentTextureEditorNode* presentTextureNode, Context& context);
 	ExecutorNode* CompileDrawMeshNode(DrawMeshEditorNode* drawMeshNode, Context& context);
+	ExecutorNode* CompileDispatchComputeNode(DispatchComputeEditorNode* dispatchComputeNode, Context& context);
+	ExecutorNode* CompileCullSceneNode(CullSceneEditorNode* cullSceneNode, Context& context);
+	ExecutorNode* CompileDrawSceneIndirectNode(DrawSceneIndirectEditorNode* drawSceneNode, Context& context);
+	ExecutorNode* CompileSetSceneNodeTransformNode(SetSceneNodeTransformEditorNode* setNodeTransformNode, Context& context);
+	ExecutorNode* CompileAnimateSceneNode(AnimateSceneEditorNode* animateSceneNode, Context& context);
 	ExecutorNode* CompileForEachSceneObjectNode(ForEachSceneObjectEditorNode* forEachSceneObjectNode, Context& context);
+	ExecutorNode* CompileForEachVisibleSceneObjectNode(ForEachVisibleSceneObjectEditorNode* forEachVisibleSceneObjectNode, Context& context);
+
+	void RecordTextureUses(const std::vector<VariableID>& textures, bool clear, Context& context);
+	void ExtendTextureLifetimes(unsigned firstStep, unsigned lastStep, Context& context);
+	std::vector<TransientTextureLifetime> ComputeTransientTextures(const Context& context, const VariablePool& variablePool);
 	
 private:
 	const NodeGraph* GetNodeGraph() const { return m_ContextStack.top().Graph; }
@@ -1,11 +1,21 @@
 #include "NodeGraphSerializer.h"
 
-#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 
 #include "../App/App.h"
 #include "../Common.h"
 #include "../NodeGraph/NodeGraph.h"
 #include "../Editor/RenderPipelineEditor.h"
+#include "../Util/AtomicFile.h"
+#include "../Util/Hash.h"
+#include "../Util/MappedFile.h"
 
 // #define ENABLE_TOKEN_VERIFICATION
 #define ASSERT_ON_LOAD_FAILED
@@ -35,37 +45,219 @@ static const std::string END_VARIABLE_POOL_TOKEN = "END_VARIABLE_POOL";
 static const std::string BEGIN_VARIABLE_TOKEN = "BEGIN_VARIABLE";
 static const std::string END_VARIABLE_TOKEN = "END_VARIABLE";
 
+static bool HasExtension(const std::string& path, const std::string& extension)
+{
+	if (path.size() < extension.size()) return false;
+	return std::equal(extension.rbegin(), extension.rend(), path.rbegin(), [](char a, char b) { return a == std::tolower((unsigned char)b); });
+}
+
+// Node types that were removed from the editor, documents that still have them are migrated while they are read
+// A removed node becomes a Deprecated placeholder without pins, its pin records are skipped and links to them are dropped
+struct RemovedNodeType
+{
+	EditorNodeType Type;
+
+	// String attributes that were written before the node ID
+	std::vector<std::string> Attributes;
+
+	// Pins in the order they were written, types are needed to skip constant values
+	std::vector<PinType> Pins;
+};
+
+static const std::vector<RemovedNodeType> REMOVED_NODE_TYPES = {
+	{ EditorNodeType::DEPRECATED_VarFloat, {}, { PinType::Float, PinType::String } },
+	{ EditorNodeType::DEPRECATED_VarFloat2, {}, { PinType::Float2, PinType::String } },
+	{ EditorNodeType::DEPRECATED_VarFloat3, {}, { PinType::Float3, PinType::String } },
+	{ EditorNodeType::DEPRECATED_VarFloat4, {}, { PinType::Float4, PinType::String } },
+	{ EditorNodeType::DEPRECATED_VarFloat4x4, {}, { PinType::Float4x4, PinType::String } },
+	{ EditorNodeType::DEPRECATED_VarBool, {}, { PinType::Bool, PinType::String } },
+	{ EditorNodeType::DEPRECATED_VarInt, {}, { PinType::Int, PinType::String } },
+	{ EditorNodeType::DEPRECATED_GetScene, {}, { PinType::Scene, PinType::String } },
+	{ EditorNodeType::DEPRECATED_GetTexture, {}, { PinType::Texture, PinType::String } },
+	{ EditorNodeType::DEPRECATED_GetShader, {}, { PinType::Shader, PinType::String } },
+	{ EditorNodeType::DEPRECATED_LoadScene, { "Path" }, { PinType::Execution, PinType::Execution, PinType::String } },
+	{ EditorNodeType::DEPRECATED_LoadTexture, { "Path" }, { PinType::Execution, PinType::Execution, PinType::String } },
+	{ EditorNodeType::DEPRECATED_LoadShader, { "Path" }, { PinType::Execution, PinType::Execution, PinType::String } },
+	{ EditorNodeType::DEPRECATED_AsignBool, {}, { PinType::Execution, PinType::Execution, PinType::Bool, PinType::String } },
+	{ EditorNodeType::DEPRECATED_AsignInt, {}, { PinType::Execution, PinType::Execution, PinType::Int, PinType::String } },
+	{ EditorNodeType::DEPRECATED_AsignFloat, {}, { PinType::Execution, PinType::Execution, PinType::Float, PinType::String } },
+	{ EditorNodeType::DEPRECATED_AsignFloat2, {}, { PinType::Execution, PinType::Execution, PinType::Float2, PinType::String } },
+	{ EditorNodeType::DEPRECATED_AsignFloat3, {}, { PinType::Execution, PinType::Execution, PinType::Float3, PinType::String } },
+	{ EditorNodeType::DEPRECATED_AsignFloat4, {}, { PinType::Execution, PinType::Execution, PinType::Float4, PinType::String } },
+	{ EditorNodeType::DEPRECATED_AsignFloat4x4, {}, { PinType::Execution, PinType::Execution, PinType::Float4x4, PinType::String } },
+	{ EditorNodeType::DEPRECATED_CreateTexture, {}, { PinType::Execution, PinType::Execution, PinType::String, PinType::Int, PinType::Int, PinType::Bool, PinType::Bool } },
+};
+
+static const RemovedNodeType* FindRemovedNodeType(EditorNodeType nodeType)
+{
+	for (const RemovedNodeType& removedType : REMOVED_NODE_TYPES)
+	{
+		if (removedType.Type == nodeType) return &removedType;
+	}
+	return nullptr;
+}
+
+struct NodeGraphSerializer::DeferredBinaryDocument
+{
+	~DeferredBinaryDocument() { MappedFile::Unmap(Mapping); }
+
+	// Windows doesn't replace a file with an open view, saving over the document first moves it to memory
+	void CopyMappingToMemory();
+
+	std::string Path;
+	const void* Mapping = nullptr;
+	size_t MappingSize = 0;
+	std::vector<uint8_t> Data;
+	unsigned Version = 0;
+	BinaryChunkReader Chunks[EnumToInt(BinaryChunk::Count)];
+	std::vector<std::string_view> Strings;
+	std::vector<CustomEditorNode*> CustomNodes;
+
+	// Where each custom node graph starts, followed by the main graph that ends the last one
+	std::vector<GraphChunkOffsets> GraphOffsets;
+};
+
+void NodeGraphSerializer::DeferredBinaryDocument::CopyMappingToMemory()
+{
+	if (!Mapping) return;
+
+	const uint8_t* mapping = static_cast<const uint8_t*>(Mapping);
+	Data.assign(mapping, mapping + MappingSize);
+	const auto rebase = [this, mapping](const uint8_t* pointer) { return pointer ? Data.data() + (pointer - mapping) : nullptr; };
+
+	for (BinaryChunkReader& chunk : Chunks)
+	{
+		chunk.Begin = rebase(chunk.Begin);
+		chunk.Data = rebase(chunk.Data);
+		chunk.End = rebase(chunk.End);
+	}
+	for (std::string_view& str : Strings)
+		str = { reinterpret_cast<const char*>(rebase(reinterpret_cast<const uint8_t*>(str.data()))), str.size() };
+
+	MappedFile::Unmap(Mapping);
+	Mapping = nullptr;
+}
+
+bool NodeGraphSerializer::DeferredGraphLoad::operator()(NodeGraph& nodeGraph) const
+{
+	NodeGraphSerializer serializer;
+	return serializer.ReadDeferredNodeGraph(*Document, Document->GraphOffsets[Index], nodeGraph);
+}
+
 void NodeGraphSerializer::Serialize(const std::string& path, const NodeGraph& nodeGraph, const VariablePool& variablePool)
 {
-	m_Output.open(path);
+	Serialize(path, IDGen::Generate(), nodeGraph, variablePool, *App::Get()->GetCustomNodes());
+}
+
+std::string NodeGraphSerializer::SerializeToMemory(const std::string& path, const NodeGraph& nodeGraph, const VariablePool& variablePool)
+{
+	return SerializeToMemory(path, IDGen::Generate(), nodeGraph, variablePool, *App::Get()->GetCustomNodes());
+}
+
+void NodeGraphSerializer::Serialize(const std::string& path, UniqueID firstID, const NodeGraph& nodeGraph, const VariablePool& variablePool, const CustomNodeList& customNodes)
+{
+	// Unread custom node graphs of the document that is overwritten keep its mapping open
+	for (const auto& customNode : customNodes)
+	{
+		const DeferredGraphLoad* load = customNode->m_NodeGraph->GetDeferredLoad().target<DeferredGraphLoad>();
+		std::error_code error;
+		if (load && load->Document->Mapping && std::filesystem::equivalent(load->Document->Path, path, error))
+			load->Document->CopyMappingToMemory();
+	}
+
+	if (HasExtension(path, JOURNAL_EXTENSION))
+	{
+		SerializeJournal(path, firstID, nodeGraph, variablePool, customNodes);
+		return;
+	}
+
+	const std::string document = SerializeToMemory(path, firstID, nodeGraph, variablePool, customNodes);
+	if (!AtomicFile::Write(path, document.data(), document.size()))
+		App::Get()->GetConsole().Log("Failed to write " + path);
+}
+
+std::string NodeGraphSerializer::SerializeToMemory(const std::string& path, UniqueID firstID, const NodeGraph& nodeGraph, const VariablePool& variablePool, const CustomNodeList& customNodes)
+{
+	// Whoever takes the contents writes the whole file, so journal is compacted
+	if (HasExtension(path, JOURNAL_EXTENSION))
+		return WriteCompactedJournal(path, firstID, BuildJournalRecords(nodeGraph, variablePool, customNodes));
+
+	m_Binary = HasExtension(path, BINARY_EXTENSION);
+	m_ChunkStack.clear();
 
 #ifdef ENABLE_TOKEN_VERIFICATION
-	m_UseTokens = true;
+	m_UseTokens = !m_Binary;
 #else
 	m_UseTokens = false;
 #endif
 
 	m_Version = VERSION;
 
-	WriteAttribute("Version", VERSION);
-	WriteAttribute("UseTokens", m_UseTokens);
-	WriteAttribute("FirstID", IDGen::Generate());
+	m_Output.clear();
+
+	if (m_Binary)
+	{
+		for (std::vector<uint8_t>& chunk : m_OutputChunks) chunk.clear();
+		m_OutputStrings.clear();
+		m_OutputStringIndices.clear();
+		BeginDeferredGraphCopies(customNodes);
+	}
+	else
+	{
+		WriteAttribute("Version", VERSION);
+		WriteAttribute("UseTokens", m_UseTokens);
+		WriteAttribute("FirstID", firstID);
+	}
 
 	WriteVariablePool(variablePool);
-	WriteCustomNodeList();
+	WriteCustomNodeList(customNodes);
 	WriteNodeGraph(nodeGraph);
 
-	m_Output.close();
+	if (m_Binary) WriteBinaryDocument(firstID);
+	m_CopiedDocument = nullptr;
+
+	return std::move(m_Output);
 }
 
 UniqueID NodeGraphSerializer::Deserialize(const std::string& path, NodeGraph& nodeGraph, VariablePool& variablePool, std::vector<CustomEditorNode*>& customNodes)
 {
 	m_OperationSuccess = true;
-	
-	m_Input = std::ifstream{ path };
-	if (!m_Input.is_open()) return 0;
+	m_ChunkStack.clear();
+
+	// Both formats are read in place from the mapping
+	MappedFile file;
+	if (!file.Open(path)) return 0;
+
+	uint32_t magic = 0;
+	if (file.GetSize() >= sizeof(magic)) memcpy(&magic, file.GetData(), sizeof(magic));
+	m_Binary = magic == BINARY_MAGIC;
+
+	UniqueID firstID = 0;
+	if (magic == JOURNAL_MAGIC)
+	{
+		variablePool = {};
+		const bool loaded = ReadJournal(path, file.GetData(), file.GetSize(), nodeGraph, variablePool, customNodes, firstID);
+		m_TextCursor = nullptr;
+		m_TextEnd = nullptr;
+
+		if (!loaded) App::Get()->GetConsole().Log("Journal document is corrupted");
+		return loaded ? firstID : 0;
+	}
 
-	m_Version = ReadIntAttr("Version");
+	if (m_Binary)
+	{
+		if (!ReadBinaryDocument(file.GetData(), file.GetSize(), firstID))
+		{
+			App::Get()->GetConsole().Log("Binary document is corrupted");
+			return 0;
+		}
+	}
+	else
+	{
+		SetTextInput({ static_cast<const char*>(file.GetData()), file.GetSize() });
+
+		m_Version = ReadIntAttr("Version");
+	}
 
 	if (m_Version < 7)
 	{
@@ -74,8 +266,11 @@ UniqueID NodeGraphSerializer::Deserialize(const std::string& path, NodeGraph& no
 		return 0;
 	}
 
-	m_UseTokens = ReadIntAttr("UseTokens");
-	unsigned firstID = ReadIntAttr("FirstID");
+	if (!m_Binary)
+	{
+		m_UseTokens = ReadIntAttr("UseTokens");
+		firstID = ReadIntAttr("FirstID");
+	}
 
 	variablePool = {};
 	if (m_Version >= 9)
@@ -86,11 +281,46 @@ UniqueID NodeGraphSerializer::Deserialize(const std::string& path, NodeGraph& no
 	customNodes = ReadCustomNodeList();
 	ReadNodeGraph(nodeGraph, customNodes);
 
-	m_Input.close();
+	if (m_DeferredDocument)
+	{
+		// Custom node graphs that are not read yet keep the mapping alive, unless the document failed to load
+		if (!m_OperationSuccess)
+		{
+			for (CustomEditorNode* customNode : m_DeferredDocument->CustomNodes)
+				customNode->m_NodeGraph->SetDeferredLoad(nullptr);
+		}
+		else if (m_DeferredDocument.use_count() > 1)
+		{
+			m_DeferredDocument->Path = path;
+			m_DeferredDocument->MappingSize = file.GetSize();
+			m_DeferredDocument->Mapping = file.Release();
+		}
+		m_DeferredDocument = nullptr;
+	}
+
+	for (BinaryChunkReader& chunk : m_InputChunks) chunk = {};
+	m_InputStrings.clear();
+	m_TextCursor = nullptr;
+	m_TextEnd = nullptr;
 
 	return m_OperationSuccess ? firstID : 0;
 }
 
+bool NodeGraphSerializer::Convert(const std::string& sourcePath, const std::string& destinationPath)
+{
+	CustomNodeList customNodes;
+	NodeGraph nodeGraph;
+	VariablePool variablePool;
+	std::vector<CustomEditorNode*> loadedCustomNodes;
+	const UniqueID firstID = Deserialize(sourcePath, nodeGraph, variablePool, loadedCustomNodes);
+	for (CustomEditorNode* customNode : loadedCustomNodes) customNodes.push_back(Ptr<CustomEditorNode>(customNode));
+
+	if (!firstID) return false;
+
+	Serialize(destinationPath, firstID, nodeGraph, variablePool, customNodes);
+	return true;
+}
+
 //////////////////////////////
 ///			WRITING			//
 //////////////////////////////
@@ -99,6 +329,7 @@ UniqueID NodeGraphSerializer::Deserialize(const std::string& path, NodeGraph& no
 
 void NodeGraphSerializer::WriteVariablePool(const VariablePool& variablePool)
 {
+	BeginChunk(BinaryChunk::Variables);
 	WriteToken(BEGIN_VARIABLE_POOL_TOKEN);
 
 	uint32_t variableCount = 0;
@@ -124,6 +355,7 @@ void NodeGraphSerializer::WriteVariablePool(const VariablePool& variablePool)
 	variablePool.ForEachVariable(writeVariable);
 
 	WriteToken(END_VARIABLE_POOL_TOKEN);
+	EndChunk();
 }
 
 void NodeGraphSerializer::WriteVariable(VariableID id, const Variable& variable)
@@ -165,6 +397,12 @@ void NodeGraphSerializer::WriteVariable(VariableID id, const Variable& variable)
 	case VariableType::Scene:
 		WriteAttribute("ValueSceneData", variable.Get<SceneData>());
 		break;
+	case VariableType::Sampler:
+		WriteAttribute("ValueSamplerData", variable.Get<SamplerData>());
+		break;
+	case VariableType::Buffer:
+		WriteAttribute("ValueBufferData", variable.Get<BufferData>());
+		break;
 	case VariableType::Invalid:
 	case VariableType::Count:
 		break;
@@ -189,87 +427,130 @@ void NodeGraphSerializer::WriteNodeGraph(const NodeGraph& nodeGraph)
 
 void NodeGraphSerializer::WriteNodeList(const NodeGraph& nodeGraph)
 {
+	BeginChunk(BinaryChunk::Nodes);
 	WriteToken(BEGIN_NODE_LIST_TOKEN);
 	WriteAttribute("Count", nodeGraph.GetNodeCount());
 
-	const auto fn = [this](EditorNode* node) { this->WriteNode(node); };
+	// Graph iterates in ID order so an unchanged graph is written to the same bytes
+	const auto fn = [this](EditorNode* node) { WriteNode(node); };
 	nodeGraph.ForEachNode(fn);
 
 	WriteToken(END_NODE_LIST_TOKEN);
+	EndChunk();
 }
 
 void NodeGraphSerializer::WriteLinkList(const NodeGraph& nodeGraph)
 {
+	BeginChunk(BinaryChunk::Links);
 	WriteToken(BEGIN_LINK_LIST_TOKEN);
 	WriteAttribute("Count", nodeGraph.GetLinkCount());
 
-	const auto fn = [this](const EditorNodeLink& link) { this->WriteLink(link); };
+	const auto fn = [this](const EditorNodeLink& link) { WriteLink(link); };
 	nodeGraph.ForEachLink(fn);
 
 	WriteToken(END_LINK_LIST_TOKEN);
+	EndChunk();
 }
 
-void NodeGraphSerializer::WriteCustomNodeList()
+void NodeGraphSerializer::WriteCustomNodeList(const CustomNodeList& customNodes)
 {
-	const auto& customNodes = *App::Get()->GetCustomNodes();
-
+	BeginChunk(BinaryChunk::CustomNodes);
 	WriteToken(BEGIN_NODE_LIST_TOKEN);
 
-	std::unordered_map<std::string, std::unordered_set<std::string>> nodeDependencies;
-	std::unordered_set<CustomEditorNode*> nodesToWrite;
+	std::vector<CustomEditorNode*> writeOrder;
+	WriteAttribute("Count", customNodes.size());
+	if (!GetCustomNodeWriteOrder(customNodes, writeOrder))
+	{
+		EndChunk();
+		return;
+	}
+
+	if (m_Binary)
+	{
+		WriteCustomNodeIndex(writeOrder);
+	}
+	else
+	{
+		for (CustomEditorNode* node : writeOrder)
+			WriteCustomNode(node);
+	}
+
+	WriteToken(END_NODE_LIST_TOKEN);
+	EndChunk();
+}
+
+bool NodeGraphSerializer::GetCustomNodeWriteOrder(const CustomNodeList& customNodes, std::vector<CustomEditorNode*>& writeOrder)
+{
+	// Binary reader finds custom nodes by name in the whole index, so graphs copied unread don't need to be ordered
+	std::vector<CustomEditorNode*> customNodePointers;
 	for (const auto& customNode : customNodes)
 	{
-		const auto fn = [&nodeDependencies, cnName = customNode->GetName()](EditorNode* node) {
+		if (!GetCopyableDeferredGraph(customNode.get())) customNodePointers.push_back(customNode.get());
+	}
+	LoadCustomNodeGraphs(customNodePointers);
+
+	std::unordered_map<std::string, size_t> nodeIndices;
+	for (size_t i = 0; i < customNodes.size(); i++) nodeIndices[customNodes[i]->GetName()] = i;
+
+	// Dependencies are kept in list order so the write order doesn't depend on the map order of the graphs
+	std::vector<std::vector<size_t>> nodeDependencies(customNodes.size());
+	for (size_t i = 0; i < customNodes.size(); i++)
+	{
+		if (GetCopyableDeferredGraph(customNodes[i].get())) continue;
+
+		bool foundMissingDependency = false;
+		std::vector<size_t>& dependencies = nodeDependencies[i];
+		const auto fn = [&nodeIndices, &dependencies, &foundMissingDependency](EditorNode* node) {
 			if (node->GetType() == EditorNodeType::Custom)
 			{
 				CustomEditorNode* cn = static_cast<CustomEditorNode*>(node);
-				nodeDependencies[cnName].insert(cn->GetName());
+				const auto it = nodeIndices.find(cn->GetName());
+				if (it != nodeIndices.end()) dependencies.push_back(it->second);
+				else foundMissingDependency = true;
 			}
 		};
-		customNode->GetNodeGraph()->ForEachNode(fn);
-		nodesToWrite.insert(customNode.get());
-	}
+		customNodes[i]->GetNodeGraph()->ForEachNode(fn);
 
-	std::unordered_set<std::string> writtenNodes;
-	WriteAttribute("Count", customNodes.size());
-	while (!nodesToWrite.empty())
-	{
-		CustomEditorNode* nodeToWrite = nullptr;
-		for (const auto& customNode : nodesToWrite)
+		if (foundMissingDependency)
 		{
-			bool foundMissingDependency = false;
-			for (const auto& nodeDep : nodeDependencies[customNode->GetName()])
-			{
-				if (writtenNodes.count(nodeDep) == 0)
-				{
-					foundMissingDependency = true;
-					break;
-				}
-			}
-
-			if (!foundMissingDependency)
-			{
-				nodeToWrite = customNode;
-				break;
-			}
+			LOAD_ASSERT();
+			m_OperationSuccess = false;
+			return false;
 		}
 
-		if (nodeToWrite)
-		{
-			WriteCustomNode(nodeToWrite);
+		std::sort(dependencies.begin(), dependencies.end());
+		dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+	}
 
-			nodesToWrite.erase(nodeToWrite);
-			writtenNodes.insert(nodeToWrite->GetName());
+	// Depth first so every node comes after the nodes it uses, list that is already in that order stays as it is
+	enum class VisitState : uint8_t { NotVisited, Visiting, Visited };
+	std::vector<VisitState> visitStates(customNodes.size(), VisitState::NotVisited);
+	const std::function<bool(size_t)> visit = [&](size_t index) {
+		if (visitStates[index] == VisitState::Visited) return true;
+		if (visitStates[index] == VisitState::Visiting) return false;
+
+		visitStates[index] = VisitState::Visiting;
+		for (const size_t dependency : nodeDependencies[index])
+		{
+			if (!visit(dependency)) return false;
 		}
-		else
+		visitStates[index] = VisitState::Visited;
+
+		writeOrder.push_back(customNodes[index].get());
+		return true;
+	};
+
+	for (size_t i = 0; i < customNodes.size(); i++)
+	{
+		if (!visit(i))
 		{
 			LOAD_ASSERT();
 			m_OperationSuccess = false;
-			return;
+			return false;
 		}
 	}
 
-	WriteToken(END_NODE_LIST_TOKEN);
+	return true;
 }
 
 void NodeGraphSerializer::WriteCustomNode(CustomEditorNode* node)
@@ -282,13 +563,106 @@ void NodeGraphSerializer::WriteCustomNode(CustomEditorNode* node)
 	WriteToken(END_NODE_TOKEN);
 }
 
+void NodeGraphSerializer::WriteCustomNodeIndex(const std::vector<CustomEditorNode*>& nodes)
+{
+	// Entries go before the graphs so the index is read without touching them
+	// Where a graph starts is known only after the ones before it are written, so offsets are patched in
+	std::vector<uint8_t>& indexChunk = m_OutputChunks[EnumToInt(BinaryChunk::CustomNodes)];
+	std::vector<size_t> offsetPositions;
+	for (CustomEditorNode* node : nodes)
+	{
+		WriteAttribute("Name", node->m_Name);
+		WritePinList(node->GetCustomPins(), true);
+
+		offsetPositions.push_back(indexChunk.size());
+		WriteBinaryValue(GraphChunkOffsets{});
+	}
+
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		const GraphChunkOffsets offsets = GetGraphChunkOffsets();
+		memcpy(indexChunk.data() + offsetPositions[i], &offsets, sizeof(offsets));
+
+		if (const DeferredGraphLoad* load = GetCopyableDeferredGraph(nodes[i])) CopyDeferredGraph(*load);
+		else WriteNodeGraph(*nodes[i]->GetNodeGraph());
+	}
+
+	// Main graph comes after all custom node graphs
+	WriteBinaryValue(GetGraphChunkOffsets());
+}
+
+void NodeGraphSerializer::BeginDeferredGraphCopies(const CustomNodeList& customNodes)
+{
+	// Graphs of one document are copied, that is the last loaded one unless custom nodes were mixed some other way
+	m_CopiedDocument = nullptr;
+	for (const auto& customNode : customNodes)
+	{
+		const DeferredGraphLoad* load = customNode->m_NodeGraph->GetDeferredLoad().target<DeferredGraphLoad>();
+		if (load && load->Document->Version == VERSION)
+		{
+			m_CopiedDocument = load->Document.get();
+			break;
+		}
+	}
+	if (!m_CopiedDocument) return;
+
+	for (const std::string_view str : m_CopiedDocument->Strings)
+	{
+		m_OutputStringIndices.emplace(str, (uint32_t)m_OutputStrings.size());
+		m_OutputStrings.emplace_back(str);
+	}
+}
+
+const NodeGraphSerializer::DeferredGraphLoad* NodeGraphSerializer::GetCopyableDeferredGraph(const CustomEditorNode* node) const
+{
+	if (!m_Binary || !m_CopiedDocument) return nullptr;
+
+	const DeferredGraphLoad* load = node->m_NodeGraph->GetDeferredLoad().target<DeferredGraphLoad>();
+	if (!load || load->Document.get() != m_CopiedDocument) return nullptr;
+
+	const DeferredBinaryDocument& document = *load->Document;
+	if (load->Index + 1 >= document.GraphOffsets.size()) return nullptr;
+
+	const GraphChunkOffsets& begin = document.GraphOffsets[load->Index];
+	const GraphChunkOffsets& end = document.GraphOffsets[load->Index + 1];
+	for (size_t i = 0; i < begin.size(); i++)
+	{
+		const BinaryChunkReader& chunk = document.Chunks[EnumToInt(GRAPH_CHUNKS[i])];
+		if (begin[i] > end[i] || end[i] > (size_t)(chunk.End - chunk.Begin)) return nullptr;
+	}
+	return load;
+}
+
+void NodeGraphSerializer::CopyDeferredGraph(const DeferredGraphLoad& load)
+{
+	const DeferredBinaryDocument& document = *load.Document;
+	const GraphChunkOffsets& begin = document.GraphOffsets[load.Index];
+	const GraphChunkOffsets& end = document.GraphOffsets[load.Index + 1];
+	for (size_t i = 0; i < begin.size(); i++)
+	{
+		const BinaryChunkReader& chunk = document.Chunks[EnumToInt(GRAPH_CHUNKS[i])];
+		std::vector<uint8_t>& outputChunk = m_OutputChunks[EnumToInt(GRAPH_CHUNKS[i])];
+		outputChunk.insert(outputChunk.end(), chunk.Begin + begin[i], chunk.Begin + end[i]);
+	}
+}
+
+NodeGraphSerializer::GraphChunkOffsets NodeGraphSerializer::GetGraphChunkOffsets() const
+{
+	GraphChunkOffsets offsets{};
+	for (size_t i = 0; i < offsets.size(); i++)
+		offsets[i] = (uint32_t)m_OutputChunks[EnumToInt(GRAPH_CHUNKS[i])].size();
+	return offsets;
+}
+
 void NodeGraphSerializer::WritePinList(const std::vector<EditorNodePin>& pins, bool custom)
 {
+	BeginChunk(BinaryChunk::Pins);
 	WriteToken(BEGIN_PIN_LIST_TOKEN);
 	WriteAttribute("Count", pins.size());
 	for (const EditorNodePin& pin : pins)
 		WritePin(pin, custom);
 	WriteToken(END_PIN_LIST_TOKEN);
+	EndChunk();
 
 }
 
@@ -339,10 +713,12 @@ void NodeGraphSerializer::WritePin(const EditorNodePin& pin, bool custom)
 
 void NodeGraphSerializer::WriteNodePositions(const NodeGraph& nodeGraph)
 {
+	BeginChunk(BinaryChunk::NodePositions);
 	WriteToken(BEGIN_NODE_POSITIONS_TOKEN);
 
-	WriteAttribute("Count", nodeGraph.GetNodePositions().size());
-	for (const auto& it : nodeGraph.GetNodePositions())
+	const auto& nodePositions = nodeGraph.GetNodePositions();
+	WriteAttribute("Count", nodePositions.size());
+	for (const auto& it : nodePositions)
 	{
 		const NodeID& nodeID = it.first;
 		const ImVec2& nodePos = it.second;
@@ -352,6 +728,7 @@ void NodeGraphSerializer::WriteNodePositions(const NodeGraph& nodeGraph)
 		WriteAttribute("Pos.Y", nodePos.y);
 	}
 	WriteToken(END_NODE_POSITIONS_TOKEN);
+	EndChunk();
 }
 
 #define READ_EDITOR_NODE(Type) Type* readNode = static_cast<Type*>(node)
@@ -425,7 +802,14 @@ void NodeGraphSerializer::WriteNode(EditorNode* node)
 	case EditorNodeType::PresentTexture:
 	case EditorNodeType::ClearRenderTarget:
 	case EditorNodeType::GetCubeMesh:
+	case EditorNodeType::GetSkinPalette:
+	case EditorNodeType::GetObjectTransform:
 	case EditorNodeType::DrawMesh:
+	case EditorNodeType::DispatchCompute:
+	case EditorNodeType::CullScene:
+	case EditorNodeType::DrawSceneIndirect:
+	case EditorNodeType::SetSceneNodeTransform:
+	case EditorNodeType::AnimateScene:
 	case EditorNodeType::BindTable:
 	case EditorNodeType::CreateFloat2:
 	case EditorNodeType::CreateFloat3:
@@ -445,6 +829,7 @@ void NodeGraphSerializer::WriteNode(EditorNode* node)
 	case EditorNodeType::NormalizeFloat4:
 	case EditorNodeType::CrossProductOperation:
 	case EditorNodeType::ForEachSceneObject:
+	case EditorNodeType::ForEachVisibleSceneObject:
 	{
 		READ_EDITOR_NODE(EditorNode);
 	} break;
@@ -455,6 +840,7 @@ void NodeGraphSerializer::WriteNode(EditorNode* node)
 		WriteAttribute("TexcoordBit", readNode->m_TexcoordBit);
 		WriteAttribute("NormalBit", readNode->m_NormalBit);
 		WriteAttribute("TangentBit", readNode->m_TangentBit);
+		WriteAttribute("SkinningBit", readNode->m_SkinningBit);
 	} break;
 	case EditorNodeType::RenderState:
 	{
@@ -556,62 +942,83 @@ void NodeGraphSerializer::WriteLink(const EditorNodeLink& link)
 
 void NodeGraphSerializer::ReadVariablePool(VariablePool& variablePool)
 {
+	BeginChunk(BinaryChunk::Variables);
 	EatToken(BEGIN_VARIABLE_POOL_TOKEN);
 
 	const int variableCount = ReadIntAttr("Count");
 
 	for (int i = 0; i < variableCount; i++)
-	{
-		EatToken(BEGIN_VARIABLE_TOKEN);
+		ReadVariable(variablePool);
 
-		const VariableID id = ReadIntAttr("ID");
-		const std::string name = ReadStrAttr("Name");
-		const VariableType type = IntToEnum<VariableType>(ReadIntAttr("Type"));
-		Variable& var = variablePool.GetRefOrCreate(id, type, name);
+	EatToken(END_VARIABLE_POOL_TOKEN);
+	EndChunk();
+}
 
-		switch (var.Type)
-		{
-		case VariableType::Bool:
-			var.Get<bool>() = ReadBoolAttr("ValueBool");
-			break;
-		case VariableType::Int:
-			var.Get<int>() = ReadIntAttr("ValueInt");
-			break;
-		case VariableType::Float:
-			var.Get<float>() = ReadFloatAttr("ValueFloat");
-			break;
-		case VariableType::Float2:
-			var.Get<Float2>() = ReadFloat2Attr("ValueFloat2");
-			break;
-		case VariableType::Float3:
-			var.Get<Float3>() = ReadFloat3Attr("ValueFloat3");
-			break;
-		case VariableType::Float4:
-			var.Get<Float4>() = ReadFloat4Attr("ValueFloat4");
-			break;
-		case VariableType::Float4x4:
-			var.Get<Float4x4>() = ReadFloat4x4Attr("ValueFloat4x4");
-			break;
-		case VariableType::Shader:
-			var.Get<ShaderData>() = ReadShaderDataAttr("ValueShaderData");
-			break;
-		case VariableType::Texture:
-			var.Get<TextureData>() = ReadTextureDataAttr("ValueTextureData");
-			break;
-		case VariableType::Scene:
-			var.Get<SceneData>() = ReadSceneDataAttr("ValueSceneData");
-			break;
-		case VariableType::Count:
-		case VariableType::Invalid:
-			break;
-		default:
-			NOT_IMPLEMENTED;
-			break;
-		}
+void NodeGraphSerializer::ReadVariable(VariablePool& variablePool)
+{
+	VariableID id = 0;
+	Variable variable{};
+	ReadVariable(id, variable);
+	variablePool.LoadVariable(id, variable);
+}
 
-		EatToken(END_VARIABLE_TOKEN);
+void NodeGraphSerializer::ReadVariable(VariableID& id, Variable& var)
+{
+	EatToken(BEGIN_VARIABLE_TOKEN);
+
+	id = ReadIntAttr("ID");
+	var = Variable{};
+	var.Name = ReadStrAttr("Name");
+	var.Type = IntToEnum<VariableType>(ReadIntAttr("Type"));
+	var.SetDefault();
+
+	switch (var.Type)
+	{
+	case VariableType::Bool:
+		var.Get<bool>() = ReadBoolAttr("ValueBool");
+		break;
+	case VariableType::Int:
+		var.Get<int>() = ReadIntAttr("ValueInt");
+		break;
+	case VariableType::Float:
+		var.Get<float>() = ReadFloatAttr("ValueFloat");
+		break;
+	case VariableType::Float2:
+		var.Get<Float2>() = ReadFloat2Attr("ValueFloat2");
+		break;
+	case VariableType::Float3:
+		var.Get<Float3>() = ReadFloat3Attr("ValueFloat3");
+		break;
+	case VariableType::Float4:
+		var.Get<Float4>() = ReadFloat4Attr("ValueFloat4");
+		break;
+	case VariableType::Float4x4:
+		var.Get<Float4x4>() = ReadFloat4x4Attr("ValueFloat4x4");
+		break;
+	case VariableType::Shader:
+		var.Get<ShaderData>() = ReadShaderDataAttr("ValueShaderData");
+		break;
+	case VariableType::Texture:
+		var.Get<TextureData>() = ReadTextureDataAttr("ValueTextureData");
+		break;
+	case VariableType::Scene:
+		var.Get<SceneData>() = ReadSceneDataAttr("ValueSceneData");
+		break;
+	case VariableType::Sampler:
+		var.Get<SamplerData>() = ReadSamplerDataAttr("ValueSamplerData");
+		break;
+	case VariableType::Buffer:
+		var.Get<BufferData>() = ReadBufferDataAttr("ValueBufferData");
+		break;
+	case VariableType::Count:
+	case VariableType::Invalid:
+		break;
+	default:
+		NOT_IMPLEMENTED;
+		break;
 	}
-	EatToken(END_VARIABLE_POOL_TOKEN);
+
+	EatToken(END_VARIABLE_TOKEN);
 }
 
 void NodeGraphSerializer::ReadNodeGraph(NodeGraph& nodeGraph, const std::vector<CustomEditorNode*>& customNodes)
@@ -621,32 +1028,38 @@ void NodeGraphSerializer::ReadNodeGraph(NodeGraph& nodeGraph, const std::vector<
 	ReadNodeList(nodeGraph, customNodes);
 	ReadLinkList(nodeGraph);
 	ReadNodePositions(nodeGraph);
-	CleanupDeprecatedNodes(nodeGraph);
 
 	EatToken(END_NODE_GRAPH_TOKEN);
 }
 
 void NodeGraphSerializer::ReadNodeList(NodeGraph& nodeGraph, const std::vector<CustomEditorNode*>& customNodes)
 {
+	BeginChunk(BinaryChunk::Nodes);
 	EatToken(BEGIN_NODE_LIST_TOKEN);
 
 	unsigned nodeCount = ReadIntAttr("Count");
+	std::vector<EditorNode*> nodes;
+	nodes.reserve(nodeCount);
 	for (unsigned i = 0; i < nodeCount; i++)
 	{
 		EditorNode* node = ReadNode(nodeGraph, customNodes);
-		nodeGraph.AddNode(node);
+		nodes.push_back(node);
 	}
+	nodeGraph.AddNodes(nodes);
 
 	EatToken(END_NODE_LIST_TOKEN);
+	EndChunk();
 }
 
 void NodeGraphSerializer::ReadNodePositions(NodeGraph& nodeGraph)
 {
+	BeginChunk(BinaryChunk::NodePositions);
 	EatToken(BEGIN_NODE_POSITIONS_TOKEN);
 
-	std::unordered_map<NodeID, ImVec2> nodePositions;
+	std::vector<IDMap<ImVec2>::Entry> positionEntries;
 
 	const unsigned n = ReadIntAttr("Count");
+	positionEntries.reserve(n);
 	for (unsigned i = 0; i < n; i++)
 	{
 		const NodeID nodeID = ReadIntAttr("ID");
@@ -654,74 +1067,196 @@ void NodeGraphSerializer::ReadNodePositions(NodeGraph& nodeGraph)
 		nodePos.x = ReadFloatAttr("Pos.X");
 		nodePos.y = ReadFloatAttr("Pos.Y");
 
-		nodePositions[nodeID] = nodePos;
+		positionEntries.emplace_back(nodeID, nodePos);
 	}
 
-	nodeGraph.SetNodePositions(nodePositions);
+	IDMap<ImVec2> nodePositions;
+	nodePositions.Assign(std::move(positionEntries));
+	nodeGraph.SetNodePositions(std::move(nodePositions));
 
 	EatToken(END_NODE_POSITIONS_TOKEN);
-}
-
-void NodeGraphSerializer::CleanupDeprecatedNodes(NodeGraph& nodeGraph)
-{
-	std::vector<NodeID> deprecatedNodes{};
-	const auto fn = [&deprecatedNodes](EditorNode* node) {
-		if (node->GetType() == EditorNodeType::Deprecated)
-		{
-			deprecatedNodes.push_back(node->GetID());
-		}
-	};
-	nodeGraph.ForEachNode(fn);
-
-	for (const auto node : deprecatedNodes)
-	{
-		nodeGraph.RemoveAllPins(node);
-	}
+	EndChunk();
 }
 
 std::vector<CustomEditorNode*> NodeGraphSerializer::ReadCustomNodeList()
 {
 	std::vector<CustomEditorNode*> customNodes;
 
+	BeginChunk(BinaryChunk::CustomNodes);
 	EatToken(BEGIN_NODE_LIST_TOKEN);
 
 	const unsigned customNodeCount = ReadIntAttr("Count");
-	for (unsigned i = 0; i < customNodeCount; i++)
-		customNodes.push_back(ReadCustomNode(customNodes));
+	if (m_Binary && m_Version >= 14)
+	{
+		ReadCustomNodeIndex(customNodeCount, customNodes);
+	}
+	else
+	{
+		for (unsigned i = 0; i < customNodeCount; i++)
+			customNodes.push_back(ReadCustomNode(customNodes));
+	}
 
 	EatToken(END_NODE_LIST_TOKEN);
+	EndChunk();
 
 	return customNodes;
 }
 
-void NodeGraphSerializer::ReadLinkList(NodeGraph& nodeGraph)
+void NodeGraphSerializer::ReadCustomNodeIndex(unsigned customNodeCount, std::vector<CustomEditorNode*>& customNodes)
 {
-	EatToken(BEGIN_LINK_LIST_TOKEN);
+	m_DeferredDocument = std::make_shared<DeferredBinaryDocument>();
+	m_DeferredDocument->Version = m_Version;
+	std::copy(std::begin(m_InputChunks), std::end(m_InputChunks), m_DeferredDocument->Chunks);
+	m_DeferredDocument->Strings = m_InputStrings;
 
-	unsigned linkCount = ReadIntAttr("Count");
-	for (unsigned i = 0; i < linkCount; i++)
+	for (unsigned i = 0; i < customNodeCount && m_OperationSuccess; i++)
 	{
-		EditorNodeLink link = ReadLink();
-		nodeGraph.AddLink(link);
+		const std::string name = ReadStrAttr("Name");
+
+		// Pins come from the index so instances can be created and drawn without the graph
+		CustomEditorNode* customNode = new CustomEditorNode{ nullptr, name, new NodeGraph{}, false };
+		ReadCustomPinList(static_cast<EditorNode*>(customNode)->m_CustomPins);
+
+		m_DeferredDocument->GraphOffsets.push_back(ReadBinaryValue<GraphChunkOffsets>());
+		customNode->m_NodeGraph->SetDeferredLoad(DeferredGraphLoad{ m_DeferredDocument, i });
+
+		customNodes.push_back(customNode);
 	}
+	m_DeferredDocument->CustomNodes = customNodes;
 
-	EatToken(END_LINK_LIST_TOKEN);
+	m_DeferredDocument->GraphOffsets.push_back(ReadBinaryValue<GraphChunkOffsets>());
+	SeekGraphChunks(m_DeferredDocument->GraphOffsets.back());
 }
 
-#define INIT_NODE(NodeType) NodeType* newNode = new NodeType{}; node = newNode
-#define INIT_SIMPLE_NODE(NodeEnum, NodeClass) case EditorNodeType::NodeEnum: { INIT_NODE(NodeClass);  } break;
-#define INIT_FLOAT_NODE(NodeEnum, NodeClass) case EditorNodeType::NodeEnum: { INIT_NODE(NodeClass); const unsigned numFloats = ReadIntAttr("NumFloats"); for (unsigned i = 0; i < numFloats; i++) { newNode->m_Values[i] = ReadFloatAttr("Value" + std::to_string(i)); }  } break;
-#define INIT_FLOAT_MATRIX_NODE(NodeEnum, NodeClass) case EditorNodeType::NodeEnum: { INIT_NODE(NodeClass); const unsigned numFloatsX = ReadIntAttr("NumFloatsX"); const unsigned numFloatsY = ReadIntAttr("NumFloatsY"); for (unsigned i = 0; i < numFloatsX; i++) { for(unsigned j = 0; j < numFloatsY; j++) { newNode->m_Values[i][j] = ReadFloatAttr("Value" + std::to_string(i) + std::to_string(j)); } }  } break;
-#define INIT_BIN_OP_NODE(NodeEnum, NodeClass) case EditorNodeType::NodeEnum: { INIT_NODE(NodeClass); newNode->m_Op = ReadStrAttr("OP"); } break;
-#define INIT_INPUT_NODE(NodeEnum, NodeClass) case EditorNodeType::NodeEnum: { INIT_NODE(NodeClass); newNode->m_Key = ReadIntAttr("Key"); newNode->m_Mods = ReadIntAttr("Mods"); } break
-
-EditorNode* NodeGraphSerializer::ReadNode(NodeGraph& nodeGraph, const std::vector<CustomEditorNode*>& customNodes)
+bool NodeGraphSerializer::SeekGraphChunks(const GraphChunkOffsets& offsets)
 {
-	EatToken(BEGIN_NODE_TOKEN);
+	if (!m_OperationSuccess) return false;
+
+	for (size_t i = 0; i < offsets.size(); i++)
+	{
+		BinaryChunkReader& chunk = m_InputChunks[EnumToInt(GRAPH_CHUNKS[i])];
+		if (offsets[i] > (size_t)(chunk.End - chunk.Begin))
+		{
+			LOAD_ASSERT();
+			m_OperationSuccess = false;
+			return false;
+		}
+		chunk.Data = chunk.Begin + offsets[i];
+	}
+	return true;
+}
+
+// Custom node graphs that are not read yet keep the mapping alive after the file is closed
+void NodeGraphSerializer::KeepDeferredMapping(MappedFile& file)
+{
+	if (m_DeferredDocument && !m_DeferredDocument->Mapping) m_DeferredDocument->Mapping = file.Release();
+}
+
+bool NodeGraphSerializer::ReadDeferredNodeGraph(const DeferredBinaryDocument& document, const GraphChunkOffsets& offsets, NodeGraph& nodeGraph)
+{
+	m_OperationSuccess = true;
+	m_Binary = true;
+	m_UseTokens = false;
+	m_Version = document.Version;
+	m_ChunkStack.clear();
+
+	std::copy(std::begin(document.Chunks), std::end(document.Chunks), m_InputChunks);
+	m_InputStrings = document.Strings;
+
+	if (SeekGraphChunks(offsets)) ReadNodeGraph(nodeGraph, document.CustomNodes);
+
+	for (BinaryChunkReader& chunk : m_InputChunks) chunk = {};
+	m_InputStrings.clear();
+
+	return m_OperationSuccess;
+}
+
+void NodeGraphSerializer::LoadCustomNodeGraphs(const std::vector<CustomEditorNode*>& customNodes)
+{
+	struct PendingGraph
+	{
+		CustomEditorNode* Node;
+		bool Loaded;
+	};
+
+	std::vector<PendingGraph> pendingGraphs;
+	std::unordered_set<NodeGraph*> visitedGraphs;
+	for (CustomEditorNode* customNode : customNodes)
+	{
+		NodeGraph* nodeGraph = customNode->m_NodeGraph.get();
+		if (nodeGraph->HasDeferredLoad() && visitedGraphs.insert(nodeGraph).second)
+			pendingGraphs.push_back({ customNode, false });
+	}
+
+	// Graphs reach other custom nodes only through definition pointers, so they don't depend on each other while reading
+	std::for_each(std::execution::par, pendingGraphs.begin(), pendingGraphs.end(), [](PendingGraph& pendingGraph) {
+		IDGen::ScopedProvisionalIDs provisionalIDs;
+		pendingGraph.Loaded = pendingGraph.Node->m_NodeGraph->ResolveDeferredLoad();
+	});
+
+	for (const PendingGraph& pendingGraph : pendingGraphs)
+	{
+		if (!pendingGraph.Loaded) App::Get()->GetConsole().Log("Custom node " + pendingGraph.Node->GetName() + " is corrupted");
+		ReplaceProvisionalIDs(*pendingGraph.Node->m_NodeGraph);
+	}
+}
+
+void NodeGraphSerializer::LoadInstancedCustomNodeGraphs(const NodeGraph& nodeGraph)
+{
+	std::vector<CustomEditorNode*> instances;
+	const auto fn = [&instances](EditorNode* node) {
+		if (node->GetType() == EditorNodeType::Custom)
+			instances.push_back(static_cast<CustomEditorNode*>(node));
+	};
+	nodeGraph.ForEachNode(fn);
+
+	LoadCustomNodeGraphs(instances);
+}
+
+void NodeGraphSerializer::ReplaceProvisionalIDs(NodeGraph& nodeGraph)
+{
+	// Pins read from the file already have their IDs, only pins the file doesn't have keep generated ones
+	const auto fn = [](EditorNode* node) {
+		for (EditorNodePin& pin : node->m_Pins)
+		{
+			if (IDGen::IsProvisional(pin.ID)) pin.ID = IDGen::Generate();
+		}
+	};
+	nodeGraph.ForEachNode(fn);
+}
+
+void NodeGraphSerializer::ReadLinkList(NodeGraph& nodeGraph)
+{
+	BeginChunk(BinaryChunk::Links);
+	EatToken(BEGIN_LINK_LIST_TOKEN);
+
+	unsigned linkCount = ReadIntAttr("Count");
+	for (unsigned i = 0; i < linkCount; i++)
+	{
+		EditorNodeLink link = ReadLink();
+		if (!IsRemovedPinLink(link)) nodeGraph.AddLink(link);
+	}
+	m_RemovedPins.clear();
+
+	EatToken(END_LINK_LIST_TOKEN);
+	EndChunk();
+}
+
+#define INIT_NODE(NodeType) NodeType* newNode = new NodeType{}; node = newNode
+#define INIT_SIMPLE_NODE(NodeEnum, NodeClass) case EditorNodeType::NodeEnum: { INIT_NODE(NodeClass);  } break;
+#define INIT_FLOAT_NODE(NodeEnum, NodeClass) case EditorNodeType::NodeEnum: { INIT_NODE(NodeClass); const unsigned numFloats = ReadIntAttr("NumFloats"); for (unsigned i = 0; i < numFloats; i++) { newNode->m_Values[i] = ReadFloatAttr("Value" + std::to_string(i)); }  } break;
+#define INIT_FLOAT_MATRIX_NODE(NodeEnum, NodeClass) case EditorNodeType::NodeEnum: { INIT_NODE(NodeClass); const unsigned numFloatsX = ReadIntAttr("NumFloatsX"); const unsigned numFloatsY = ReadIntAttr("NumFloatsY"); for (unsigned i = 0; i < numFloatsX; i++) { for(unsigned j = 0; j < numFloatsY; j++) { newNode->m_Values[i][j] = ReadFloatAttr("Value" + std::to_string(i) + std::to_string(j)); } }  } break;
+#define INIT_BIN_OP_NODE(NodeEnum, NodeClass) case EditorNodeType::NodeEnum: { INIT_NODE(NodeClass); newNode->m_Op = ReadStrAttr("OP"); } break;
+#define INIT_INPUT_NODE(NodeEnum, NodeClass) case EditorNodeType::NodeEnum: { INIT_NODE(NodeClass); newNode->m_Key = ReadIntAttr("Key"); newNode->m_Mods = ReadIntAttr("Mods"); } break
+
+EditorNode* NodeGraphSerializer::ReadNode(NodeGraph& nodeGraph, const std::vector<CustomEditorNode*>& customNodes)
+{
+	EatToken(BEGIN_NODE_TOKEN);
 
 	EditorNode* node = nullptr;
 	
 	EditorNodeType nodeType = IntToEnum<EditorNodeType>(ReadIntAttr("Type"));
+	const RemovedNodeType* removedType = nullptr;
 	switch (nodeType)
 	{
 		INIT_SIMPLE_NODE(CreateFloat2, CreateFloat2EditorNode);
@@ -735,8 +1270,15 @@ EditorNode* NodeGraphSerializer::ReadNode(NodeGraph& nodeGraph, const std::vecto
 		INIT_SIMPLE_NODE(OnUpdate, OnUpdateEditorNode);
 		INIT_SIMPLE_NODE(OnStart, OnStartEditorNode);
 		INIT_SIMPLE_NODE(GetCubeMesh, GetCubeMeshEditorNode);
+		INIT_SIMPLE_NODE(GetSkinPalette, GetSkinPaletteEditorNode);
+		INIT_SIMPLE_NODE(GetObjectTransform, GetObjectTransformEditorNode);
 		INIT_SIMPLE_NODE(ClearRenderTarget, ClearRenderTargetEditorNode);
 		INIT_SIMPLE_NODE(DrawMesh, DrawMeshEditorNode);
+		INIT_SIMPLE_NODE(DispatchCompute, DispatchComputeEditorNode);
+		INIT_SIMPLE_NODE(CullScene, CullSceneEditorNode);
+		INIT_SIMPLE_NODE(DrawSceneIndirect, DrawSceneIndirectEditorNode);
+		INIT_SIMPLE_NODE(SetSceneNodeTransform, SetSceneNodeTransformEditorNode);
+		INIT_SIMPLE_NODE(AnimateScene, AnimateSceneEditorNode);
 		INIT_SIMPLE_NODE(BindTable, BindTableEditorNode);
 		INIT_SIMPLE_NODE(PresentTexture, PresentTextureEditorNode);
 		INIT_SIMPLE_NODE(Transform_Rotate_Float4x4, Float4x4RotationTransformEditorNode);
@@ -749,6 +1291,7 @@ EditorNode* NodeGraphSerializer::ReadNode(NodeGraph& nodeGraph, const std::vecto
 		INIT_SIMPLE_NODE(NormalizeFloat4, NormalizeFloat4EditorNode);
 		INIT_SIMPLE_NODE(CrossProductOperation, CrossProductOperationEditorNode);
 		INIT_SIMPLE_NODE(ForEachSceneObject, ForEachSceneObjectEditorNode);
+		INIT_SIMPLE_NODE(ForEachVisibleSceneObject, ForEachVisibleSceneObjectEditorNode);
 
 		INIT_FLOAT_NODE(Float, FloatEditorNode);
 		INIT_FLOAT_NODE(Float2, Float2EditorNode);
@@ -793,6 +1336,7 @@ EditorNode* NodeGraphSerializer::ReadNode(NodeGraph& nodeGraph, const std::vecto
 		newNode->m_TexcoordBit = ReadBoolAttr("TexcoordBit");
 		newNode->m_NormalBit = ReadBoolAttr("NormalBit");
 		newNode->m_TangentBit = ReadBoolAttr("TangentBit");
+		if (m_Version >= 13) newNode->m_SkinningBit = ReadBoolAttr("SkinningBit");
 	} break;
 	case EditorNodeType::RenderState:
 	{
@@ -839,38 +1383,22 @@ EditorNode* NodeGraphSerializer::ReadNode(NodeGraph& nodeGraph, const std::vecto
 			m_OperationSuccess = false;
 			return nullptr;
 		}
-		node = new CustomEditorNode(&nodeGraph, customNodeName, customNodeClass->GetNodeGraph(), false);
+		// Graph pointer is enough for the instance, reading the definition waits until it is used
+		node = new CustomEditorNode(&nodeGraph, customNodeName, customNodeClass->m_NodeGraph.get(), false);
 	} break;
-	case EditorNodeType::DEPRECATED_VarBool:
-	case EditorNodeType::DEPRECATED_VarInt:
-	case EditorNodeType::DEPRECATED_VarFloat:
-	case EditorNodeType::DEPRECATED_VarFloat2:
-	case EditorNodeType::DEPRECATED_VarFloat3:
-	case EditorNodeType::DEPRECATED_VarFloat4:
-	case EditorNodeType::DEPRECATED_VarFloat4x4:
-	case EditorNodeType::DEPRECATED_GetScene:
-	case EditorNodeType::DEPRECATED_GetTexture:
-	case EditorNodeType::DEPRECATED_GetShader:
-	case EditorNodeType::DEPRECATED_AsignBool:
-	case EditorNodeType::DEPRECATED_AsignInt:
-	case EditorNodeType::DEPRECATED_AsignFloat:
-	case EditorNodeType::DEPRECATED_AsignFloat2:
-	case EditorNodeType::DEPRECATED_AsignFloat3:
-	case EditorNodeType::DEPRECATED_AsignFloat4:
-	case EditorNodeType::DEPRECATED_AsignFloat4x4:
-	case EditorNodeType::DEPRECATED_CreateTexture:
 	case EditorNodeType::Deprecated:
 	{
 		node = new DeprecatedEditorNode(nodeType);
 	} break;
-	case EditorNodeType::DEPRECATED_LoadScene:
-	case EditorNodeType::DEPRECATED_LoadTexture:
-	case EditorNodeType::DEPRECATED_LoadShader:
-	{
-		ReadStrAttr("Path");
-		node = new DeprecatedEditorNode(nodeType);
-	} break;
 	default:
+		removedType = FindRemovedNodeType(nodeType);
+		if (removedType)
+		{
+			for (const std::string& attribute : removedType->Attributes) ReadStrAttr(attribute);
+			node = new DeprecatedEditorNode(nodeType);
+			break;
+		}
+
 		NOT_IMPLEMENTED;
 		m_OperationSuccess = false;
 		node = new FloatEditorNode{}; // Just some random node to prevent crash
@@ -878,97 +1406,49 @@ EditorNode* NodeGraphSerializer::ReadNode(NodeGraph& nodeGraph, const std::vecto
 
 	node->m_ID = ReadIntAttr("ID");
 	
-	const auto readConstantValue = [this](EditorNodePin& pin)
-	{
-		switch (pin.Type)
-		{
-		case PinType::Bool:
-			pin.ConstantValue.B = ReadBoolAttr("ConstantValueB");
-			break;
-		case PinType::Int:
-			pin.ConstantValue.I = ReadIntAttr("ConstantValueI");
-			break;
-		case PinType::Float:
-			pin.ConstantValue.F = ReadFloatAttr("ConstantValueF");
-			break;
-		case PinType::Float2:
-			pin.ConstantValue.F2 = ReadFloat2Attr("ConstantValueF2");
-			break;
-		case PinType::Float3:
-			pin.ConstantValue.F3 = ReadFloat3Attr("ConstantValueF3");
-			break;
-		case PinType::Float4:
-			pin.ConstantValue.F4 = ReadFloat4Attr("ConstantValueF4");
-			break;
-		case PinType::String:
-			pin.ConstantValue.STR = ReadStrAttr("ConstantValueSTR");
-			break;
-		default:
-			NOT_IMPLEMENTED;
-		}
-	};
 
 	// Read pins
 	{
+		BeginChunk(BinaryChunk::Pins);
 		EatToken(BEGIN_PIN_LIST_TOKEN);
 
 		unsigned pinCount = ReadIntAttr("Count");
-		if (pinCount > node->m_Pins.size())
+		if (pinCount > (removedType ? removedType->Pins.size() : node->m_Pins.size()))
 		{
 			LOAD_ASSERT();
 			m_OperationSuccess = false;
+			EndChunk();
 			return node;
 		}
-		for (unsigned i = 0; i < pinCount; i++)
-		{
-			node->m_Pins[i].ID = ReadIntAttr("ID");
-
-			if (m_Version > 7)
-			{
-				node->m_Pins[i].HasConstantValue = ReadBoolAttr("HasConstantValue");
-				if (node->m_Pins[i].HasConstantValue) readConstantValue(node->m_Pins[i]);
-			}
-			else
-			{
-				node->m_Pins[i].HasConstantValue = false;
-			}
-
-		}
-
-		EatToken(END_PIN_LIST_TOKEN);
-	}
-
-	// Read custom pins
-	{
-		EatToken(BEGIN_PIN_LIST_TOKEN);
 
-		unsigned pinCount = ReadIntAttr("Count");
-		node->m_CustomPins.resize(pinCount);
+		// Pins of removed node types are read into a scratch pin and dropped, ReadLinkList skips links to them
+		EditorNodePin removedPin{};
 		for (unsigned i = 0; i < pinCount; i++)
 		{
-			EditorNodePin pin;
+			EditorNodePin& pin = removedType ? removedPin : node->m_Pins[i];
+			if (removedType) pin.Type = removedType->Pins[i];
+
 			pin.ID = ReadIntAttr("ID");
-			pin.IsInput = ReadBoolAttr("IsInput");
-			pin.Type = IntToEnum<PinType>(ReadIntAttr("Type"));
-			pin.Label = ReadStrAttr("Label");
-			pin.LinkedNode = ReadIntAttr("LinkedNode");
 
 			if (m_Version > 7)
 			{
 				pin.HasConstantValue = ReadBoolAttr("HasConstantValue");
-				if (pin.HasConstantValue) readConstantValue(pin);
+				if (pin.HasConstantValue) ReadPinConstantValue(pin);
 			}
 			else
 			{
 				pin.HasConstantValue = false;
 			}
 
-			node->m_CustomPins[i] = pin;
+			if (removedType) m_RemovedPins.insert(pin.ID);
 		}
 
 		EatToken(END_PIN_LIST_TOKEN);
+		EndChunk();
 	}
 
+	ReadCustomPinList(node->m_CustomPins);
+
 	EatToken(END_NODE_TOKEN);
 
 	return node;
@@ -988,6 +1468,12 @@ EditorNodeLink NodeGraphSerializer::ReadLink()
 	return link;
 }
 
+bool NodeGraphSerializer::IsRemovedPinLink(const EditorNodeLink& link) const
+{
+	if (m_RemovedPins.empty()) return false;
+	return m_RemovedPins.count(link.Start) || m_RemovedPins.count(link.End);
+}
+
 CustomEditorNode* NodeGraphSerializer::ReadCustomNode(const std::vector<CustomEditorNode*>& customNodes)
 {
 	EatToken(BEGIN_NODE_TOKEN);
@@ -1002,6 +1488,69 @@ CustomEditorNode* NodeGraphSerializer::ReadCustomNode(const std::vector<CustomEd
 	return new CustomEditorNode{ nullptr, name, nodeGraph };
 }
 
+void NodeGraphSerializer::ReadCustomPinList(std::vector<EditorNodePin>& pins)
+{
+	BeginChunk(BinaryChunk::Pins);
+	EatToken(BEGIN_PIN_LIST_TOKEN);
+
+	unsigned pinCount = ReadIntAttr("Count");
+	pins.resize(pinCount);
+	for (unsigned i = 0; i < pinCount; i++)
+	{
+		EditorNodePin pin;
+		pin.ID = ReadIntAttr("ID");
+		pin.IsInput = ReadBoolAttr("IsInput");
+		pin.Type = IntToEnum<PinType>(ReadIntAttr("Type"));
+		pin.Label = ReadStrAttr("Label");
+		pin.LinkedNode = ReadIntAttr("LinkedNode");
+
+		if (m_Version > 7)
+		{
+			pin.HasConstantValue = ReadBoolAttr("HasConstantValue");
+			if (pin.HasConstantValue) ReadPinConstantValue(pin);
+		}
+		else
+		{
+			pin.HasConstantValue = false;
+		}
+
+		pins[i] = pin;
+	}
+
+	EatToken(END_PIN_LIST_TOKEN);
+	EndChunk();
+}
+
+void NodeGraphSerializer::ReadPinConstantValue(EditorNodePin& pin)
+{
+	switch (pin.Type)
+	{
+	case PinType::Bool:
+		pin.ConstantValue.B = ReadBoolAttr("ConstantValueB");
+		break;
+	case PinType::Int:
+		pin.ConstantValue.I = ReadIntAttr("ConstantValueI");
+		break;
+	case PinType::Float:
+		pin.ConstantValue.F = ReadFloatAttr("ConstantValueF");
+		break;
+	case PinType::Float2:
+		pin.ConstantValue.F2 = ReadFloat2Attr("ConstantValueF2");
+		break;
+	case PinType::Float3:
+		pin.ConstantValue.F3 = ReadFloat3Attr("ConstantValueF3");
+		break;
+	case PinType::Float4:
+		pin.ConstantValue.F4 = ReadFloat4Attr("ConstantValueF4");
+		break;
+	case PinType::String:
+		pin.ConstantValue.STR = ReadStrAttr("ConstantValueSTR");
+		break;
+	default:
+		NOT_IMPLEMENTED;
+	}
+}
+
 void NodeGraphSerializer::ReadFloatNode(FloatNEditorNode* floatNode)
 {
 	const unsigned numFloats = ReadIntAttr("NumFloats");
@@ -1016,17 +1565,458 @@ void NodeGraphSerializer::ReadBinaryOperatorNode(BinaryOperatorEditorNode* binOp
 	binOpNode->m_Op = ReadStrAttr("OP");
 }
 
+unsigned NodeGraphSerializer::BeginListRead(BinaryChunk chunk)
+{
+	BeginChunk(chunk);
+	switch (chunk)
+	{
+	case BinaryChunk::Variables:
+		EatToken(BEGIN_VARIABLE_POOL_TOKEN);
+		break;
+	case BinaryChunk::Nodes:
+		EatToken(BEGIN_NODE_GRAPH_TOKEN);
+		EatToken(BEGIN_NODE_LIST_TOKEN);
+		break;
+	case BinaryChunk::Links:
+		EatToken(BEGIN_LINK_LIST_TOKEN);
+		break;
+	case BinaryChunk::NodePositions:
+		EatToken(BEGIN_NODE_POSITIONS_TOKEN);
+		break;
+	default:
+		NOT_IMPLEMENTED;
+	}
+	const unsigned count = ReadIntAttr("Count");
+	EndChunk();
+	return count;
+}
+
+void NodeGraphSerializer::EndListRead(BinaryChunk chunk)
+{
+	BeginChunk(chunk);
+	switch (chunk)
+	{
+	case BinaryChunk::Variables:
+		EatToken(END_VARIABLE_POOL_TOKEN);
+		break;
+	case BinaryChunk::Nodes:
+		EatToken(END_NODE_LIST_TOKEN);
+		break;
+	case BinaryChunk::Links:
+		EatToken(END_LINK_LIST_TOKEN);
+		break;
+	case BinaryChunk::NodePositions:
+		EatToken(END_NODE_POSITIONS_TOKEN);
+		EatToken(END_NODE_GRAPH_TOKEN);
+		break;
+	default:
+		NOT_IMPLEMENTED;
+	}
+	EndChunk();
+}
+
 #pragma endregion // READING
 
+//////////////////////////////
+///			JOURNAL			//
+//////////////////////////////
+
+#pragma region JOURNAL
+
+void NodeGraphSerializer::SerializeJournal(const std::string& path, UniqueID firstID, const NodeGraph& nodeGraph, const VariablePool& variablePool, const CustomNodeList& customNodes)
+{
+	const std::vector<JournalRecordData> records = BuildJournalRecords(nodeGraph, variablePool, customNodes);
+
+	if (CanAppendToJournal(path))
+	{
+		// Only records whose contents changed since the last save are appended, removed ones get a marker
+		std::string update;
+		uint64_t liveSize = sizeof(JournalHeader) + sizeof(JournalEntryHeader);
+		std::unordered_map<uint64_t, uint64_t> hashes[EnumToInt(JournalRecord::Count)];
+		for (const JournalRecordData& record : records)
+		{
+			liveSize += sizeof(JournalEntryHeader) + record.Data.size();
+
+			const auto& savedHashes = m_Journal.Hashes[EnumToInt(record.Record)];
+			const auto it = savedHashes.find(record.Key);
+			if (it == savedHashes.end() || it->second != record.Hash)
+				WriteJournalEntry(update, JournalEntry::Put, record.Record, record.Key, record.Hash, record.Data);
+
+			hashes[EnumToInt(record.Record)][record.Key] = record.Hash;
+		}
+
+		for (uint32_t i = 0; i < EnumToInt(JournalRecord::Count); i++)
+		{
+			for (const auto& it : m_Journal.Hashes[i])
+			{
+				if (hashes[i].count(it.first) == 0)
+					WriteJournalEntry(update, JournalEntry::Remove, IntToEnum<JournalRecord>(i), it.first, 0, {});
+			}
+		}
+
+		if (m_Journal.FileSize + update.size() + sizeof(JournalEntryHeader) <= JOURNAL_COMPACTION_RATIO * liveSize)
+		{
+			const uint64_t commitOffset = m_Journal.FileSize + update.size();
+			const JournalEntryHeader commit = WriteJournalCommit(update, 0, firstID);
+			if (!AtomicFile::Append(path, update.data(), update.size()))
+			{
+				// File can end with a torn update now, next save rewrites it
+				m_Journal = {};
+				App::Get()->GetConsole().Log("Failed to write " + path);
+				return;
+			}
+
+			m_Journal.FileSize += update.size();
+			m_Journal.LiveSize = liveSize;
+			m_Journal.LastCommitOffset = commitOffset;
+			m_Journal.LastCommit = commit;
+			for (uint32_t i = 0; i < EnumToInt(JournalRecord::Count); i++)
+				m_Journal.Hashes[i] = std::move(hashes[i]);
+			return;
+		}
+	}
+
+	const std::string journal = WriteCompactedJournal(path, firstID, records);
+	if (!AtomicFile::Write(path, journal.data(), journal.size()))
+	{
+		m_Journal = {};
+		App::Get()->GetConsole().Log("Failed to write " + path);
+	}
+}
+
+std::vector<NodeGraphSerializer::JournalRecordData> NodeGraphSerializer::BuildJournalRecords(const NodeGraph& nodeGraph, const VariablePool& variablePool, const CustomNodeList& customNodes)
+{
+	// Nothing is written to the disk here
+	BeginJournalRecords();
+
+	std::vector<JournalRecordData> records;
+	const auto addRecord = [this, &records](JournalRecord record, uint64_t key) {
+		records.push_back(TakeJournalRecord(record, key));
+	};
+
+	std::vector<CustomEditorNode*> customNodeOrder;
+	GetCustomNodeWriteOrder(customNodes, customNodeOrder);
+
+	WriteAttribute("Count", customNodeOrder.size());
+	for (CustomEditorNode* customNode : customNodeOrder)
+		WriteAttribute("Name", customNode->GetName());
+	addRecord(JournalRecord::Document, 0);
+
+	const auto writeVariable = [this, &addRecord](VariableID id, const Variable& variable) {
+		WriteVariable(id, variable);
+		addRecord(JournalRecord::Variable, id);
+	};
+	variablePool.ForEachVariable(writeVariable);
+
+	for (CustomEditorNode* customNode : customNodeOrder)
+	{
+		WriteCustomNode(customNode);
+		addRecord(JournalRecord::CustomNode, Hash::Fnv1a64(customNode->GetName()));
+	}
+
+	const auto& nodePositions = nodeGraph.GetNodePositions();
+	const auto writeNode = [this, &addRecord, &nodePositions](EditorNode* node) {
+		const auto it = nodePositions.find(node->GetID());
+		WriteJournalNode(node, it != nodePositions.end() ? &it->second : nullptr);
+		addRecord(JournalRecord::Node, node->GetID());
+	};
+	nodeGraph.ForEachNode(writeNode);
+
+	const auto writeLink = [this, &addRecord](const EditorNodeLink& link) {
+		WriteLink(link);
+		addRecord(JournalRecord::Link, link.ID);
+	};
+	nodeGraph.ForEachLink(writeLink);
+
+	return records;
+}
+
+void NodeGraphSerializer::BeginJournalRecords()
+{
+	// Records are in text format
+	m_Binary = false;
+	m_UseTokens = false;
+	m_Version = VERSION;
+	m_ChunkStack.clear();
+
+	m_Output.clear();
+}
+
+NodeGraphSerializer::JournalRecordData NodeGraphSerializer::TakeJournalRecord(JournalRecord record, uint64_t key)
+{
+	std::string data = m_Output;
+	m_Output.clear();
+
+	const uint64_t hash = Hash::Fnv1a64(data);
+	return JournalRecordData{ record, key, hash, std::move(data) };
+}
+
+void NodeGraphSerializer::WriteJournalNode(EditorNode* node, const ImVec2* position)
+{
+	// Position goes with its node so moving a node rewrites only that node
+	WriteNode(node);
+	WriteAttribute("HasPosition", position != nullptr);
+	if (position)
+	{
+		WriteAttribute("Pos.X", position->x);
+		WriteAttribute("Pos.Y", position->y);
+	}
+}
+
+std::string NodeGraphSerializer::WriteCompactedJournal(const std::string& path, UniqueID firstID, const std::vector<JournalRecordData>& records)
+{
+	size_t journalSize = sizeof(JournalHeader) + sizeof(JournalEntryHeader);
+	for (const JournalRecordData& record : records)
+		journalSize += sizeof(JournalEntryHeader) + record.Data.size();
+
+	std::string journal;
+	journal.reserve(journalSize);
+
+	const JournalHeader header{ JOURNAL_MAGIC, VERSION };
+	journal.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	m_Journal = {};
+	for (const JournalRecordData& record : records)
+	{
+		WriteJournalEntry(journal, JournalEntry::Put, record.Record, record.Key, record.Hash, record.Data);
+		m_Journal.Hashes[EnumToInt(record.Record)][record.Key] = record.Hash;
+	}
+
+	m_Journal.LastCommitOffset = journal.size();
+	m_Journal.LastCommit = WriteJournalCommit(journal, sizeof(header), firstID);
+
+	// Assumes the contents reach the disk, if they don't the file won't end with the commit and the next save compacts again
+	m_Journal.Path = path;
+	m_Journal.Version = VERSION;
+	m_Journal.FileSize = journal.size();
+	m_Journal.LiveSize = journal.size();
+
+	return journal;
+}
+
+void NodeGraphSerializer::WriteJournalEntry(std::string& output, JournalEntry type, JournalRecord record, uint64_t key, uint64_t hash, std::string_view data)
+{
+	const JournalEntryHeader entry{ EnumToInt(type), EnumToInt(record), key, hash, data.size() };
+	output.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+	output.append(data);
+}
+
+NodeGraphSerializer::JournalEntryHeader NodeGraphSerializer::WriteJournalCommit(std::string& output, size_t commitBegin, UniqueID firstID)
+{
+	const uint32_t checksum = Hash::Crc32(reinterpret_cast<const uint8_t*>(output.data()) + commitBegin, output.size() - commitBegin);
+	const JournalEntryHeader commit{ EnumToInt(JournalEntry::Commit), 0, (uint64_t)firstID, checksum, 0 };
+	output.append(reinterpret_cast<const char*>(&commit), sizeof(commit));
+	return commit;
+}
+
+bool NodeGraphSerializer::CanAppendToJournal(const std::string& path) const
+{
+	if (m_Journal.Path.empty() || m_Journal.Path != path || m_Journal.Version != VERSION) return false;
+
+	// File could have been replaced since the last save, it has to still end with our last commit
+	std::error_code error;
+	const uintmax_t fileSize = std::filesystem::file_size(path, error);
+	if (error || fileSize != m_Journal.FileSize) return false;
+
+	std::ifstream file{ path, std::ios::binary };
+	file.seekg(m_Journal.LastCommitOffset);
+
+	JournalEntryHeader lastCommit{};
+	file.read(reinterpret_cast<char*>(&lastCommit), sizeof(lastCommit));
+	return file && memcmp(&lastCommit, &m_Journal.LastCommit, sizeof(lastCommit)) == 0;
+}
+
+bool NodeGraphSerializer::ReadJournal(const std::string& path, const void* data, size_t size, NodeGraph& nodeGraph, VariablePool& variablePool, std::vector<CustomEditorNode*>& customNodes, UniqueID& firstID)
+{
+	JournalContents contents;
+	if (!ReplayJournal(data, size, contents)) return false;
+
+	m_Binary = false;
+	m_UseTokens = false;
+	m_Version = contents.Version;
+
+	for (const auto& it : GetSortedJournalRecords(contents, JournalRecord::Variable))
+	{
+		SetTextInput(it.second);
+		ReadVariable(variablePool);
+	}
+
+	customNodes.clear();
+	ReadJournalCustomNodes(contents, customNodes);
+
+	std::vector<EditorNode*> nodes;
+	std::vector<IDMap<ImVec2>::Entry> positionEntries;
+	for (const auto& it : GetSortedJournalRecords(contents, JournalRecord::Node))
+	{
+		if (!m_OperationSuccess) break;
+
+		SetTextInput(it.second);
+		EditorNode* node = ReadNode(nodeGraph, customNodes);
+		nodes.push_back(node);
+
+		if (ReadBoolAttr("HasPosition"))
+		{
+			ImVec2 nodePos{};
+			nodePos.x = ReadFloatAttr("Pos.X");
+			nodePos.y = ReadFloatAttr("Pos.Y");
+			positionEntries.emplace_back(node->GetID(), nodePos);
+		}
+	}
+	nodeGraph.AddNodes(nodes);
+
+	for (const auto& it : GetSortedJournalRecords(contents, JournalRecord::Link))
+	{
+		if (!m_OperationSuccess) break;
+
+		SetTextInput(it.second);
+		const EditorNodeLink link = ReadLink();
+		if (!IsRemovedPinLink(link)) nodeGraph.AddLink(link);
+	}
+	m_RemovedPins.clear();
+
+	IDMap<ImVec2> nodePositions;
+	nodePositions.Assign(std::move(positionEntries));
+	nodeGraph.SetNodePositions(std::move(nodePositions));
+
+	if (!m_OperationSuccess) return false;
+
+	firstID = contents.FirstID;
+
+	// Next save appends to what was read, records past a torn tail make the file size differ so that one compacts instead
+	JournalState journal;
+	journal.Path = path;
+	journal.Version = contents.Version;
+	journal.FileSize = contents.FileSize;
+	journal.LastCommitOffset = contents.LastCommitOffset;
+	journal.LastCommit = contents.LastCommit;
+	journal.LiveSize = sizeof(JournalHeader) + sizeof(JournalEntryHeader);
+	for (uint32_t i = 0; i < EnumToInt(JournalRecord::Count); i++)
+	{
+		for (const auto& it : contents.Records[i])
+		{
+			journal.Hashes[i][it.first] = it.second.Hash;
+			journal.LiveSize += sizeof(JournalEntryHeader) + it.second.Data.size();
+		}
+	}
+	m_Journal = std::move(journal);
+
+	return true;
+}
+
+bool NodeGraphSerializer::ReplayJournal(const void* data, size_t size, JournalContents& contents)
+{
+	const char* bytes = static_cast<const char*>(data);
+
+	JournalHeader header{};
+	if (size < sizeof(header)) return false;
+	memcpy(&header, bytes, sizeof(header));
+	contents.Version = header.Version;
+
+	struct PendingEntry
+	{
+		JournalEntryHeader Header;
+		std::string_view Data;
+	};
+
+	// Entries take effect at the commit after them, anything past the last valid commit is a torn save and is dropped
+	std::vector<PendingEntry> pendingEntries;
+	size_t offset = sizeof(header);
+	size_t commitBegin = offset;
+	bool committed = false;
+	while (size - offset >= sizeof(JournalEntryHeader))
+	{
+		const size_t entryOffset = offset;
+		JournalEntryHeader entry{};
+		memcpy(&entry, bytes + offset, sizeof(entry));
+		offset += sizeof(entry);
+
+		if (entry.ByteSize > size - offset) break;
+		const std::string_view entryData{ bytes + offset, (size_t)entry.ByteSize };
+		offset += (size_t)entry.ByteSize;
+
+		if (entry.Type == EnumToInt(JournalEntry::Commit))
+		{
+			if (entry.Hash != Hash::Crc32(reinterpret_cast<const uint8_t*>(bytes) + commitBegin, entryOffset - commitBegin)) break;
+
+			for (const PendingEntry& pendingEntry : pendingEntries)
+			{
+				auto& recordsOfType = contents.Records[pendingEntry.Header.Record];
+				if (pendingEntry.Header.Type == EnumToInt(JournalEntry::Put))
+					recordsOfType[pendingEntry.Header.Key] = JournalLiveRecord{ pendingEntry.Header.Hash, pendingEntry.Data };
+				else
+					recordsOfType.erase(pendingEntry.Header.Key);
+			}
+			pendingEntries.clear();
+
+			contents.FirstID = (UniqueID)entry.Key;
+			contents.FileSize = offset;
+			contents.LastCommitOffset = entryOffset;
+			contents.LastCommit = entry;
+			commitBegin = offset;
+			committed = true;
+		}
+		else if (entry.Type <= EnumToInt(JournalEntry::Remove) && entry.Record < EnumToInt(JournalRecord::Count))
+		{
+			pendingEntries.push_back(PendingEntry{ entry, entryData });
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	return committed && contents.Records[EnumToInt(JournalRecord::Document)].count(0) > 0;
+}
+
+std::vector<std::pair<uint64_t, std::string_view>> NodeGraphSerializer::GetSortedJournalRecords(const JournalContents& contents, JournalRecord record)
+{
+	// Keys of variables, nodes and links are their IDs, reading in key order appends them to the ID maps
+	const auto& records = contents.Records[EnumToInt(record)];
+	std::vector<std::pair<uint64_t, std::string_view>> sortedRecords;
+	sortedRecords.reserve(records.size());
+	for (const auto& it : records)
+		sortedRecords.emplace_back(it.first, it.second.Data);
+	std::sort(sortedRecords.begin(), sortedRecords.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	return sortedRecords;
+}
+
+bool NodeGraphSerializer::ReadJournalCustomNodes(const JournalContents& contents, std::vector<CustomEditorNode*>& customNodes)
+{
+	// Custom nodes are read in the saved order so the ones they use are already there
+	SetTextInput(contents.Records[EnumToInt(JournalRecord::Document)].at(0).Data);
+	std::vector<std::string> customNodeNames;
+	const unsigned customNodeCount = ReadIntAttr("Count");
+	for (unsigned i = 0; i < customNodeCount && m_OperationSuccess; i++)
+		customNodeNames.push_back(ReadStrAttr("Name"));
+
+	const auto& customNodeRecords = contents.Records[EnumToInt(JournalRecord::CustomNode)];
+	for (const std::string& name : customNodeNames)
+	{
+		const auto it = customNodeRecords.find(Hash::Fnv1a64(name));
+		if (it == customNodeRecords.end())
+		{
+			LOAD_ASSERT();
+			m_OperationSuccess = false;
+		}
+		if (!m_OperationSuccess) break;
+
+		SetTextInput(it->second.Data);
+		customNodes.push_back(ReadCustomNode(customNodes));
+	}
+	return m_OperationSuccess;
+}
+
+#pragma endregion // JOURNAL
+
 //////////////////////////////
 ///			UTILITY			//
 //////////////////////////////
 
 void NodeGraphSerializer::WriteToken(const std::string& token)
 {
-#ifdef ENABLE_TOKEN_VERIFICATION
-	m_Output << token << "\n";
-#endif
+	if (!m_UseTokens) return;
+
+	m_Output.append(token).append("\n");
 }
 
 void NodeGraphSerializer::EatToken(const std::string& token)
@@ -1036,212 +2026,354 @@ void NodeGraphSerializer::EatToken(const std::string& token)
 
 	if (!m_OperationSuccess) return;
 
-	std::string line;
-	if (!std::getline(m_Input, line) || token != line)
+	std::string_view line;
+	if (!ReadLine(line) || token != line)
 	{
 		LOAD_ASSERT();
 		m_OperationSuccess = false;
 	}
 }
 
-std::string NodeGraphSerializer::ReadAttribute(const std::string& name)
+void NodeGraphSerializer::BeginChunk(BinaryChunk chunk)
 {
-	// Optimize this
-	if (!m_OperationSuccess) return "";
+	if (m_Binary) m_ChunkStack.push_back(chunk);
+}
 
-	// Read line from stream
-	std::string line;
-	if (!std::getline(m_Input, line))
+void NodeGraphSerializer::EndChunk()
+{
+	if (m_Binary) m_ChunkStack.pop_back();
+}
+
+template<typename T>
+T NodeGraphSerializer::ReadBinaryValue()
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	T value{};
+	if (!m_OperationSuccess) return value;
+
+	BinaryChunkReader& chunk = m_InputChunks[EnumToInt(m_ChunkStack.back())];
+	if ((size_t)(chunk.End - chunk.Data) < sizeof(T))
 	{
 		LOAD_ASSERT();
 		m_OperationSuccess = false;
-		return "";
+		return value;
 	}
-	
-	// Read attribute name
-	std::string attrName;
-	unsigned it = 0;
-	while (line[it] != ' ' && it < line.size())
-		attrName += line[it++];
 
-	if (attrName != name)
+	memcpy(&value, chunk.Data, sizeof(T));
+	chunk.Data += sizeof(T);
+	return value;
+}
+
+void NodeGraphSerializer::WriteBinaryString(const std::string& value)
+{
+	const auto it = m_OutputStringIndices.find(value);
+	if (it != m_OutputStringIndices.end())
 	{
-		LOAD_ASSERT();
-		// m_OperationSuccess = false;
-		// return "";
+		WriteBinaryValue(it->second);
+		return;
 	}
 
-	// Skip before separator space
-	it++;
+	const uint32_t index = (uint32_t)m_OutputStrings.size();
+	m_OutputStrings.push_back(value);
+	m_OutputStringIndices.emplace(value, index);
+	WriteBinaryValue(index);
+}
+
+std::string_view NodeGraphSerializer::ReadBinaryString()
+{
+	const uint32_t index = ReadBinaryValue<uint32_t>();
+	if (!m_OperationSuccess) return {};
 
-	// Validate separator
-	m_OperationSuccess = line[it++] == ':';
-	if (!m_OperationSuccess)
+	if (index >= m_InputStrings.size())
 	{
 		LOAD_ASSERT();
-		return "";
+		m_OperationSuccess = false;
+		return {};
 	}
+	return m_InputStrings[index];
+}
 
-	// Skip after separator space
-	it++;
+void NodeGraphSerializer::WriteBinaryDocument(UniqueID firstID)
+{
+	// String table is known only after everything else is written
+	BeginChunk(BinaryChunk::Strings);
+	m_OutputChunks[EnumToInt(BinaryChunk::Strings)].clear();
+	WriteBinaryValue((uint32_t)m_OutputStrings.size());
+	for (const std::string& str : m_OutputStrings)
+	{
+		WriteBinaryValue((uint32_t)str.size());
+		std::vector<uint8_t>& chunk = m_OutputChunks[EnumToInt(BinaryChunk::Strings)];
+		chunk.insert(chunk.end(), str.begin(), str.end());
+	}
+	EndChunk();
 
-	// Read value
-	std::string value;
-	while (it < line.size())
-		value += line[it++];
+	const BinaryHeader header{ BINARY_MAGIC, VERSION, (uint32_t)firstID, EnumToInt(BinaryChunk::Count) };
+	m_Output.append(reinterpret_cast<const char*>(&header), sizeof(header));
 
-	return value;
+	for (uint32_t i = 0; i < EnumToInt(BinaryChunk::Count); i++)
+	{
+		const std::vector<uint8_t>& chunk = m_OutputChunks[i];
+		const BinaryChunkHeader chunkHeader{ i, (uint32_t)chunk.size() };
+		m_Output.append(reinterpret_cast<const char*>(&chunkHeader), sizeof(chunkHeader));
+		m_Output.append(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+	}
 }
 
-static bool ValidateIntStr(const std::string& intStr)
+bool NodeGraphSerializer::ReadBinaryDocument(const void* data, size_t size, UniqueID& firstID)
 {
-	if (intStr.empty()) return false;
-	for (unsigned i = (intStr[0] == '-') ? 1 : 0; i < intStr.size(); i++)
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	const uint8_t* end = bytes + size;
+
+	BinaryHeader header{};
+	if (size < sizeof(header)) return false;
+	memcpy(&header, bytes, sizeof(header));
+	bytes += sizeof(header);
+
+	m_Version = header.Version;
+	m_UseTokens = false;
+	firstID = header.FirstID;
+
+	for (BinaryChunkReader& chunk : m_InputChunks) chunk = {};
+	for (uint32_t i = 0; i < header.ChunkCount; i++)
 	{
-		if (!std::isdigit(intStr[i]))
+		BinaryChunkHeader chunkHeader{};
+		if ((size_t)(end - bytes) < sizeof(chunkHeader)) return false;
+		memcpy(&chunkHeader, bytes, sizeof(chunkHeader));
+		bytes += sizeof(chunkHeader);
+
+		if ((size_t)(end - bytes) < chunkHeader.ByteSize) return false;
+
+		// Chunks from newer versions are skipped
+		if (chunkHeader.Type < EnumToInt(BinaryChunk::Count))
+			m_InputChunks[chunkHeader.Type] = BinaryChunkReader{ bytes, bytes, bytes + chunkHeader.ByteSize };
+		bytes += chunkHeader.ByteSize;
+	}
+
+	BeginChunk(BinaryChunk::Strings);
+	BinaryChunkReader& strings = m_InputChunks[EnumToInt(BinaryChunk::Strings)];
+	const uint32_t stringCount = ReadBinaryValue<uint32_t>();
+	m_InputStrings.clear();
+	m_InputStrings.reserve(std::min<size_t>(stringCount, (strings.End - strings.Data) / sizeof(uint32_t)));
+	for (uint32_t i = 0; i < stringCount && m_OperationSuccess; i++)
+	{
+		const uint32_t length = ReadBinaryValue<uint32_t>();
+		if ((size_t)(strings.End - strings.Data) < length)
 		{
-			return false;
+			m_OperationSuccess = false;
+			break;
 		}
+		m_InputStrings.emplace_back(reinterpret_cast<const char*>(strings.Data), length);
+		strings.Data += length;
 	}
-	return true;
+	EndChunk();
+
+	return m_OperationSuccess;
 }
 
-static bool ValidateFloatStr(const std::string& floatStr)
+void NodeGraphSerializer::SetTextInput(std::string_view text)
 {
-	if (floatStr.empty()) return false;
+	m_TextCursor = text.data();
+	m_TextEnd = text.data() + text.size();
+}
 
-	unsigned numDots = 0;
-	for (unsigned i = (floatStr[0] == '-') ? 1 : 0; i < floatStr.size(); i++)
-	{
-		if (floatStr[i] == '.')
-		{
-			numDots++;
-			if (numDots > 1)
-				return false;
+bool NodeGraphSerializer::ReadLine(std::string_view& line)
+{
+	if (m_TextCursor >= m_TextEnd) return false;
 
-			continue;
-		}
-		if (!std::isdigit(floatStr[i]))
-		{
-			return false;
-		}
-	}
+	const char* lineEnd = static_cast<const char*>(memchr(m_TextCursor, '\n', m_TextEnd - m_TextCursor));
+	if (!lineEnd) lineEnd = m_TextEnd;
+
+	line = std::string_view{ m_TextCursor, (size_t)(lineEnd - m_TextCursor) };
+	m_TextCursor = lineEnd == m_TextEnd ? m_TextEnd : lineEnd + 1;
+
+	// Files saved on Windows keep \r since the mapping isn't translated like text streams
+	if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
 	return true;
 }
 
-int NodeGraphSerializer::ReadIntAttr(const std::string& name)
+std::string_view NodeGraphSerializer::ReadAttribute(std::string_view name, std::string_view suffix)
 {
-	const std::string intStr = ReadAttribute(name);
-	if (!ValidateIntStr(intStr))
+	if (m_Binary) return ReadBinaryString();
+
+	if (!m_OperationSuccess) return {};
+
+	std::string_view line;
+	if (!ReadLine(line))
+	{
+		LOAD_ASSERT();
+		m_OperationSuccess = false;
+		return {};
+	}
+
+	// Line is "<name> : <value>", names have no spaces so the first separator is the right one
+	static constexpr std::string_view separator = " : ";
+	const size_t separatorPosition = line.find(separator);
+	if (separatorPosition == std::string_view::npos)
 	{
 		LOAD_ASSERT();
 		m_OperationSuccess = false;
+		return {};
 	}
-	return m_OperationSuccess ? std::stoi(intStr) : 0;
+
+	const std::string_view attrName = line.substr(0, separatorPosition);
+	if (attrName.size() != name.size() + suffix.size() || attrName.substr(0, name.size()) != name || attrName.substr(name.size()) != suffix)
+	{
+		LOAD_ASSERT();
+	}
+
+	return line.substr(separatorPosition + separator.size());
 }
 
-float NodeGraphSerializer::ReadFloatAttr(const std::string& name)
+template<typename T>
+T NodeGraphSerializer::ParseNumber(std::string_view str)
 {
-	const std::string floatStr = ReadAttribute(name);
-	if (!ValidateFloatStr(floatStr))
+	T value{};
+	if (!m_OperationSuccess) return value;
+
+	const char* end = str.data() + str.size();
+	const std::from_chars_result result = std::from_chars(str.data(), end, value);
+	if (str.empty() || result.ec != std::errc{} || result.ptr != end)
 	{
 		LOAD_ASSERT();
 		m_OperationSuccess = false;
+		return T{};
 	}
-	return m_OperationSuccess ? std::stof(floatStr) : 0.0f;
+	return value;
 }
 
-char NodeGraphSerializer::ReadCharAttr(const std::string& name)
+int NodeGraphSerializer::ReadIntAttr(std::string_view name, std::string_view suffix)
 {
-	const std::string charStr = ReadAttribute(name);
+	if (m_Binary) return ReadBinaryValue<int32_t>();
+
+	return ParseNumber<int>(ReadAttribute(name, suffix));
+}
+
+float NodeGraphSerializer::ReadFloatAttr(std::string_view name, std::string_view suffix)
+{
+	if (m_Binary) return ReadBinaryValue<float>();
+
+	return ParseNumber<float>(ReadAttribute(name, suffix));
+}
+
+char NodeGraphSerializer::ReadCharAttr(std::string_view name, std::string_view suffix)
+{
+	const std::string_view charStr = ReadAttribute(name, suffix);
 	m_OperationSuccess = m_OperationSuccess && charStr.size() == 1;
 	if (!m_OperationSuccess) LOAD_ASSERT();
 	return m_OperationSuccess ? charStr[0] : 0;
 }
 
-bool NodeGraphSerializer::ReadBoolAttr(const std::string& name)
+bool NodeGraphSerializer::ReadBoolAttr(std::string_view name, std::string_view suffix)
 {
-	const int val = ReadIntAttr(name);
+	const int val = ReadIntAttr(name, suffix);
 	m_OperationSuccess = m_OperationSuccess && (val == 0 || val == 1);
 	if (!m_OperationSuccess) LOAD_ASSERT();
 	return m_OperationSuccess ? val != 0 : false;
 }
 
-std::string NodeGraphSerializer::ReadStrAttr(const std::string& name)
+std::string NodeGraphSerializer::ReadStrAttr(std::string_view name, std::string_view suffix)
 {
-	return ReadAttribute(name);
+	return std::string{ ReadAttribute(name, suffix) };
 }
 
-Float2 NodeGraphSerializer::ReadFloat2Attr(const std::string& name)
+Float2 NodeGraphSerializer::ReadFloat2Attr(std::string_view name)
 {
+	if (m_Binary) return ReadBinaryValue<Float2>();
+
 	Float2 value;
-	value.x = ReadFloatAttr(name + ".X");
-	value.y = ReadFloatAttr(name + ".Y");
+	value.x = ReadFloatAttr(name, ".X");
+	value.y = ReadFloatAttr(name, ".Y");
 	return value;
 }
 
-Float3 NodeGraphSerializer::ReadFloat3Attr(const std::string& name)
+Float3 NodeGraphSerializer::ReadFloat3Attr(std::string_view name)
 {
+	if (m_Binary) return ReadBinaryValue<Float3>();
+
 	Float3 value;
-	value.x = ReadFloatAttr(name + ".X");
-	value.y = ReadFloatAttr(name + ".Y");
-	value.z = ReadFloatAttr(name + ".Z");
+	value.x = ReadFloatAttr(name, ".X");
+	value.y = ReadFloatAttr(name, ".Y");
+	value.z = ReadFloatAttr(name, ".Z");
 	return value;
 }
 
-Float4 NodeGraphSerializer::ReadFloat4Attr(const std::string& name)
+Float4 NodeGraphSerializer::ReadFloat4Attr(std::string_view name)
 {
+	if (m_Binary) return ReadBinaryValue<Float4>();
+
 	Float4 value;
-	value.x = ReadFloatAttr(name + ".X");
-	value.y = ReadFloatAttr(name + ".Y");
-	value.z = ReadFloatAttr(name + ".Z");
-	value.w = ReadFloatAttr(name + ".W");
+	value.x = ReadFloatAttr(name, ".X");
+	value.y = ReadFloatAttr(name, ".Y");
+	value.z = ReadFloatAttr(name, ".Z");
+	value.w = ReadFloatAttr(name, ".W");
 	return value;
 }
 
-Float4x4 NodeGraphSerializer::ReadFloat4x4Attr(const std::string& name)
+Float4x4 NodeGraphSerializer::ReadFloat4x4Attr(std::string_view name)
 {
+	if (m_Binary) return ReadBinaryValue<Float4x4>();
+
 	Float4x4 value;
-	value[0][0] = ReadFloatAttr(name + ".00");
-	value[0][1] = ReadFloatAttr(name + ".01");
-	value[0][2] = ReadFloatAttr(name + ".02");
-	value[0][3] = ReadFloatAttr(name + ".03");
-	value[1][0] = ReadFloatAttr(name + ".10");
-	value[1][1] = ReadFloatAttr(name + ".11");
-	value[1][2] = ReadFloatAttr(name + ".12");
-	value[1][3] = ReadFloatAttr(name + ".13");
-	value[2][0] = ReadFloatAttr(name + ".20");
-	value[2][1] = ReadFloatAttr(name + ".21");
-	value[2][2] = ReadFloatAttr(name + ".22");
-	value[2][3] = ReadFloatAttr(name + ".23");
-	value[3][0] = ReadFloatAttr(name + ".30");
-	value[3][1] = ReadFloatAttr(name + ".31");
-	value[3][2] = ReadFloatAttr(name + ".32");
-	value[3][3] = ReadFloatAttr(name + ".33");
+	value[0][0] = ReadFloatAttr(name, ".00");
+	value[0][1] = ReadFloatAttr(name, ".01");
+	value[0][2] = ReadFloatAttr(name, ".02");
+	value[0][3] = ReadFloatAttr(name, ".03");
+	value[1][0] = ReadFloatAttr(name, ".10");
+	value[1][1] = ReadFloatAttr(name, ".11");
+	value[1][2] = ReadFloatAttr(name, ".12");
+	value[1][3] = ReadFloatAttr(name, ".13");
+	value[2][0] = ReadFloatAttr(name, ".20");
+	value[2][1] = ReadFloatAttr(name, ".21");
+	value[2][2] = ReadFloatAttr(name, ".22");
+	value[2][3] = ReadFloatAttr(name, ".23");
+	value[3][0] = ReadFloatAttr(name, ".30");
+	value[3][1] = ReadFloatAttr(name, ".31");
+	value[3][2] = ReadFloatAttr(name, ".32");
+	value[3][3] = ReadFloatAttr(name, ".33");
 	return value;
 }
 
-TextureData NodeGraphSerializer::ReadTextureDataAttr(const std::string& name)
+TextureData NodeGraphSerializer::ReadTextureDataAttr(std::string_view name)
 {
 	TextureData value;
-	value.Path = ReadStrAttr(name + ".Path");
-	value.Width = ReadIntAttr(name + ".Width");
-	value.Height = ReadIntAttr(name + ".Height");
-	value.Framebuffer = ReadBoolAttr(name + ".Framebuffer");
-	value.DepthStencil = ReadBoolAttr(name + ".DepthStencil");
+	value.Path = ReadStrAttr(name, ".Path");
+	value.Width = ReadIntAttr(name, ".Width");
+	value.Height = ReadIntAttr(name, ".Height");
+	value.Framebuffer = ReadBoolAttr(name, ".Framebuffer");
+	value.DepthStencil = ReadBoolAttr(name, ".DepthStencil");
+	if (m_Version >= 11) value.Format = IntToEnum<TextureFormat>(ReadIntAttr(name, ".Format"));
 	return value;
 }
 
-SceneData NodeGraphSerializer::ReadSceneDataAttr(const std::string& name)
+SceneData NodeGraphSerializer::ReadSceneDataAttr(std::string_view name)
 {
 	SceneData value;
-	value.Path = ReadStrAttr(name + ".Path");
+	value.Path = ReadStrAttr(name, ".Path");
+	if (m_Version >= 10) value.OptimizeMeshes = ReadBoolAttr(name, ".OptimizeMeshes");
+	if (m_Version >= 12) value.GPUDriven = ReadBoolAttr(name, ".GPUDriven");
+	return value;
+}
+
+SamplerData NodeGraphSerializer::ReadSamplerDataAttr(std::string_view name)
+{
+	SamplerData value;
+	value.Filter = IntToEnum<SamplerFilter>(ReadIntAttr(name, ".Filter"));
+	value.Wrap = IntToEnum<SamplerWrap>(ReadIntAttr(name, ".Wrap"));
+	return value;
+}
+
+BufferData NodeGraphSerializer::ReadBufferDataAttr(std::string_view name)
+{
+	BufferData value;
+	value.ByteSize = (unsigned) ReadIntAttr(name, ".ByteSize");
+	value.Stride = (unsigned) ReadIntAttr(name, ".Stride");
 	return value;
 }
 
-ShaderData NodeGraphSerializer::ReadShaderDataAttr(const std::string& name)
+ShaderData NodeGraphSerializer::ReadShaderDataAttr(std::string_view name)
 {
 	ShaderData value;
-	value.Path = ReadStrAttr(name + ".Path");
+	value.Path = ReadStrAttr(name, ".Path");
 	return value;
 }
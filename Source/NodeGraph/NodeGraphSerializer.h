@@ -3,10 +3,17 @@
 #include "../Common.h"
 #include "../IDGen.h"
 
+#include "../App/App.h"
 #include "../NodeGraph/VariablePool.h"
 
+#include <array>
+#include <charconv>
+#include <iterator>
 #include <string>
-#include <fstream>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class NodeGraph;
@@ -20,21 +27,179 @@ class NameAndPathExecutionEditorNode;
 class CustomEditorNode;
 struct EditorNodeLink;
 struct EditorNodePin;
+class MappedFile;
 
+// Documents are saved as text (.rn) or binary (.rnb), format of the written file is picked by the extension
+// Both formats carry the same attribute stream, binary one stores values raw in length prefixed chunks
+// with strings deduplicated in a string table, so loading it is a walk over the mapped file
+// Binary documents index custom nodes by their chunk offsets, so a custom node graph is read only when it is first used
+// Journal documents (.rnj) are an append only log of text records for variables, custom nodes, nodes and links
+// keyed by ID and content hash, a save appends only the records that changed and the log is compacted once it grows
 class NodeGraphSerializer
 {
-	static constexpr unsigned VERSION = 9;
+	friend class NodeGraphWriter;
+	friend class NodeGraphReader;
+
+	static constexpr unsigned VERSION = 14;
+
+	static constexpr uint32_t BINARY_MAGIC = 0x00424E52; // "RNB"
+
+	enum class BinaryChunk : uint32_t
+	{
+		Strings,
+		Variables,
+		CustomNodes,
+		Nodes,
+		Pins,
+		Links,
+		NodePositions,
+
+		Count
+	};
+
+	struct BinaryHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t FirstID;
+		uint32_t ChunkCount;
+	};
+
+	struct BinaryChunkHeader
+	{
+		uint32_t Type;
+		uint32_t ByteSize;
+	};
+
+	struct BinaryChunkReader
+	{
+		const uint8_t* Begin = nullptr;
+		const uint8_t* Data = nullptr;
+		const uint8_t* End = nullptr;
+	};
+
+	// Chunks a node graph is written to, custom node index stores where each graph starts in them
+	static constexpr BinaryChunk GRAPH_CHUNKS[] = { BinaryChunk::Nodes, BinaryChunk::Pins, BinaryChunk::Links, BinaryChunk::NodePositions };
+	using GraphChunkOffsets = std::array<uint32_t, STATIC_ARRAY_SIZE(GRAPH_CHUNKS)>;
+
+	// Binary document kept mapped while some of its custom node graphs are not read yet
+	struct DeferredBinaryDocument;
+
+	// Deferred load of the custom node graph at Index in the document index
+	// Binary saves copy the graph bytes from the document while it is still unread, so saving doesn't read it
+	struct DeferredGraphLoad
+	{
+		SharedPtr<DeferredBinaryDocument> Document;
+		uint32_t Index;
+
+		bool operator()(NodeGraph& nodeGraph) const;
+	};
+
+	static constexpr uint32_t JOURNAL_MAGIC = 0x004A4E52; // "RNJ"
+
+	// Journal is rewritten compacted once it is this many times bigger than its live records
+	static constexpr uint64_t JOURNAL_COMPACTION_RATIO = 2;
+
+	enum class JournalEntry : uint32_t
+	{
+		Put,
+		Remove,
+		Commit,
+	};
+
+	enum class JournalRecord : uint32_t
+	{
+		Document, // Custom node order, there is only one
+		Variable,
+		CustomNode,
+		Node,
+		Link,
+
+		Count
+	};
+
+	struct JournalHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+	};
+
+	// Put is followed by ByteSize bytes of the record in text format
+	// Commit has first ID as the key and crc32 of the entries since the previous commit as the hash
+	struct JournalEntryHeader
+	{
+		uint32_t Type;
+		uint32_t Record;
+		uint64_t Key;
+		uint64_t Hash;
+		uint64_t ByteSize;
+	};
+
+	struct JournalRecordData
+	{
+		JournalRecord Record;
+		uint64_t Key;
+		uint64_t Hash;
+		std::string Data;
+	};
+
+	struct JournalLiveRecord
+	{
+		uint64_t Hash;
+		std::string_view Data;
+	};
+
+	// Live records of a journal after its committed entries are applied, data points into the file
+	struct JournalContents
+	{
+		unsigned Version = 0;
+		UniqueID FirstID = 0;
+		uint64_t FileSize = 0;
+		uint64_t LastCommitOffset = 0;
+		JournalEntryHeader LastCommit{};
+		std::unordered_map<uint64_t, JournalLiveRecord> Records[EnumToInt(JournalRecord::Count)];
+	};
+
+	// Journal file as of the last save or load, appending is safe only while the file still ends with that commit
+	struct JournalState
+	{
+		std::string Path;
+		unsigned Version = 0;
+		uint64_t FileSize = 0;
+		uint64_t LiveSize = 0;
+		uint64_t LastCommitOffset = 0;
+		JournalEntryHeader LastCommit{};
+		std::unordered_map<uint64_t, uint64_t> Hashes[EnumToInt(JournalRecord::Count)];
+	};
 
 public:
+	static constexpr const char* BINARY_EXTENSION = ".rnb";
+	static constexpr const char* TEXT_EXTENSION = ".rn";
+	static constexpr const char* JOURNAL_EXTENSION = ".rnj";
+
 	void Serialize(const std::string& path, const NodeGraph& nodeGraph, const VariablePool& variablePool);
+
+	// Builds the file contents Serialize would write without touching the disk
+	std::string SerializeToMemory(const std::string& path, const NodeGraph& nodeGraph, const VariablePool& variablePool);
 	UniqueID Deserialize(const std::string& path, NodeGraph& nodeGraph, VariablePool& variablePool, std::vector<CustomEditorNode*>& customNodes);
 
+	// Rewrites the document in the format of the destination extension, custom nodes are taken from the source file
+	bool Convert(const std::string& sourcePath, const std::string& destinationPath);
+
+	// Reads deferred graphs of the custom nodes in parallel, instances and their definition share one graph
+	// IDs generated while reading come from the global allocator afterwards, so it has to be initialized for the document
+	static void LoadCustomNodeGraphs(const std::vector<CustomEditorNode*>& customNodes);
+	static void LoadInstancedCustomNodeGraphs(const NodeGraph& nodeGraph);
+
 	// Hack since I need to use it in lambda
 public:
 	void WriteNode(EditorNode* node);
 	void WriteLink(const EditorNodeLink& link);
 	
 private:
+	void Serialize(const std::string& path, UniqueID firstID, const NodeGraph& nodeGraph, const VariablePool& variablePool, const CustomNodeList& customNodes);
+	std::string SerializeToMemory(const std::string& path, UniqueID firstID, const NodeGraph& nodeGraph, const VariablePool& variablePool, const CustomNodeList& customNodes);
+
 	// Writes
 	void WriteVariablePool(const VariablePool& variablePool);
 	void WriteVariable(VariableID id, const Variable& variable);
@@ -42,31 +207,96 @@ private:
 	void WriteNodeList(const NodeGraph& nodeGraph);
 	void WriteLinkList(const NodeGraph& nodeGraph);
 	void WriteNodePositions(const NodeGraph& nodeGraph);
-	void WriteCustomNodeList();
+	void WriteCustomNodeList(const CustomNodeList& customNodes);
+	bool GetCustomNodeWriteOrder(const CustomNodeList& customNodes, std::vector<CustomEditorNode*>& writeOrder);
 	void WriteCustomNode(CustomEditorNode* node);
+	void WriteCustomNodeIndex(const std::vector<CustomEditorNode*>& nodes);
+	void BeginDeferredGraphCopies(const CustomNodeList& customNodes);
+	const DeferredGraphLoad* GetCopyableDeferredGraph(const CustomEditorNode* node) const;
+	void CopyDeferredGraph(const DeferredGraphLoad& load);
+	GraphChunkOffsets GetGraphChunkOffsets() const;
 	void WritePinList(const std::vector<EditorNodePin>& pins, bool custom);
 	void WritePin(const EditorNodePin& pin, bool custom);
 
+	// Journal
+	void SerializeJournal(const std::string& path, UniqueID firstID, const NodeGraph& nodeGraph, const VariablePool& variablePool, const CustomNodeList& customNodes);
+	std::vector<JournalRecordData> BuildJournalRecords(const NodeGraph& nodeGraph, const VariablePool& variablePool, const CustomNodeList& customNodes);
+	void BeginJournalRecords();
+	JournalRecordData TakeJournalRecord(JournalRecord record, uint64_t key);
+	void WriteJournalNode(EditorNode* node, const ImVec2* position);
+	std::string WriteCompactedJournal(const std::string& path, UniqueID firstID, const std::vector<JournalRecordData>& records);
+	static void WriteJournalEntry(std::string& output, JournalEntry type, JournalRecord record, uint64_t key, uint64_t hash, std::string_view data);
+	static JournalEntryHeader WriteJournalCommit(std::string& output, size_t commitBegin, UniqueID firstID);
+	bool CanAppendToJournal(const std::string& path) const;
+	bool ReadJournal(const std::string& path, const void* data, size_t size, NodeGraph& nodeGraph, VariablePool& variablePool, std::vector<CustomEditorNode*>& customNodes, UniqueID& firstID);
+	static bool ReplayJournal(const void* data, size_t size, JournalContents& contents);
+	static std::vector<std::pair<uint64_t, std::string_view>> GetSortedJournalRecords(const JournalContents& contents, JournalRecord record);
+	bool ReadJournalCustomNodes(const JournalContents& contents, std::vector<CustomEditorNode*>& customNodes);
+
 	// Reads
 	void ReadVariablePool(VariablePool& variablePool);
+	void ReadVariable(VariablePool& variablePool);
+	void ReadVariable(VariableID& id, Variable& variable);
 	void ReadNodeGraph(NodeGraph& nodeGraph, const std::vector<CustomEditorNode*>& customNodes);
 	void ReadNodeList(NodeGraph& nodeGraph, const std::vector<CustomEditorNode*>& customNodes);
 	void ReadNodePositions(NodeGraph& nodeGraph);
-	void CleanupDeprecatedNodes(NodeGraph& nodeGraph);
 	std::vector<CustomEditorNode*> ReadCustomNodeList();
+	void ReadCustomNodeIndex(unsigned customNodeCount, std::vector<CustomEditorNode*>& customNodes);
+	bool SeekGraphChunks(const GraphChunkOffsets& offsets);
+	bool ReadDeferredNodeGraph(const DeferredBinaryDocument& document, const GraphChunkOffsets& offsets, NodeGraph& nodeGraph);
+	void KeepDeferredMapping(MappedFile& file);
+	static void ReplaceProvisionalIDs(NodeGraph& nodeGraph);
 	void ReadLinkList(NodeGraph& nodeGraph);
 	EditorNode* ReadNode(NodeGraph& nodeGraph, const std::vector<CustomEditorNode*>& customNodes);
 	EditorNodeLink ReadLink();
+	bool IsRemovedPinLink(const EditorNodeLink& link) const;
 	CustomEditorNode* ReadCustomNode(const std::vector<CustomEditorNode*>& customNodes);
+	void ReadCustomPinList(std::vector<EditorNodePin>& pins);
+	void ReadPinConstantValue(EditorNodePin& pin);
 	
 	void ReadFloatNode(FloatNEditorNode* floatNode);
 	void ReadBinaryOperatorNode(BinaryOperatorEditorNode* binOpNode);
 
+	// Lists of the main graph read one element at a time, begin returns the element count
+	unsigned BeginListRead(BinaryChunk chunk);
+	void EndListRead(BinaryChunk chunk);
+
 private:
 	template<typename T>
 	void WriteAttribute(const std::string& name, const T& value)
 	{
-		m_Output << name << " : " << value << "\n";
+		if (m_Binary)
+		{
+			if constexpr (std::is_floating_point_v<T>) WriteBinaryValue((float)value);
+			else if constexpr (std::is_arithmetic_v<T>) WriteBinaryValue((int32_t)value);
+			else WriteBinaryString(value);
+			return;
+		}
+		m_Output.append(name).append(" : ");
+		WriteTextValue(value);
+		m_Output += '\n';
+	}
+
+	// Same text a default formatted stream writes, without going through the locale
+	template<typename T>
+	void WriteTextValue(const T& value)
+	{
+		if constexpr (std::is_same_v<T, char>)
+		{
+			m_Output += value;
+		}
+		else if constexpr (std::is_arithmetic_v<T>)
+		{
+			char buffer[32];
+			std::to_chars_result result;
+			if constexpr (std::is_floating_point_v<T>) result = std::to_chars(buffer, std::end(buffer), value, std::chars_format::general, 6);
+			else result = std::to_chars(buffer, std::end(buffer), value);
+			m_Output.append(buffer, result.ptr);
+		}
+		else
+		{
+			m_Output += value;
+		}
 	}
 
 	template<>
@@ -78,6 +308,12 @@ private:
 	template<>
 	void WriteAttribute(const std::string& name, const Float2& value)
 	{
+		if (m_Binary)
+		{
+			WriteBinaryValue(value);
+			return;
+		}
+
 		WriteAttribute(name + ".X", value.x);
 		WriteAttribute(name + ".Y", value.y);
 	}
@@ -85,6 +321,12 @@ private:
 	template<>
 	void WriteAttribute(const std::string& name, const Float3& value)
 	{
+		if (m_Binary)
+		{
+			WriteBinaryValue(value);
+			return;
+		}
+
 		WriteAttribute(name + ".X", value.x);
 		WriteAttribute(name + ".Y", value.y);
 		WriteAttribute(name + ".Z", value.z);
@@ -93,6 +335,12 @@ private:
 	template<>
 	void WriteAttribute(const std::string& name, const Float4& value)
 	{
+		if (m_Binary)
+		{
+			WriteBinaryValue(value);
+			return;
+		}
+
 		WriteAttribute(name + ".X", value.x);
 		WriteAttribute(name + ".Y", value.y);
 		WriteAttribute(name + ".Z", value.z);
@@ -102,6 +350,12 @@ private:
 	template<>
 	void WriteAttribute(const std::string& name, const Float4x4& value)
 	{
+		if (m_Binary)
+		{
+			WriteBinaryValue(value);
+			return;
+		}
+
 		WriteAttribute(name + ".00", value[0][0]);
 		WriteAttribute(name + ".01", value[0][1]);
 		WriteAttribute(name + ".02", value[0][2]);
@@ -128,6 +382,7 @@ private:
 		WriteAttribute(name + ".Height", value.Height);
 		WriteAttribute(name + ".Framebuffer", value.Framebuffer);
 		WriteAttribute(name + ".DepthStencil", value.DepthStencil);
+		WriteAttribute(name + ".Format", EnumToInt(value.Format));
 	}
 
 	template<>
@@ -136,35 +391,108 @@ private:
 		WriteAttribute(name + ".Path", value.Path);
 	}
 
+	template<>
+	void WriteAttribute(const std::string& name, const SamplerData& value)
+	{
+		WriteAttribute(name + ".Filter", EnumToInt(value.Filter));
+		WriteAttribute(name + ".Wrap", EnumToInt(value.Wrap));
+	}
+
+	template<>
+	void WriteAttribute(const std::string& name, const BufferData& value)
+	{
+		WriteAttribute(name + ".ByteSize", value.ByteSize);
+		WriteAttribute(name + ".Stride", value.Stride);
+	}
+
 	template<>
 	void WriteAttribute(const std::string& name, const SceneData& value)
 	{
 		WriteAttribute(name + ".Path", value.Path);
+		WriteAttribute(name + ".OptimizeMeshes", value.OptimizeMeshes);
+		WriteAttribute(name + ".GPUDriven", value.GPUDriven);
 	}
 
 	void WriteToken(const std::string& token);
 	void EatToken(const std::string& token);
 
-	std::string ReadAttribute(const std::string& name);
-	int ReadIntAttr(const std::string& name);
-	float ReadFloatAttr(const std::string& name);
-	char ReadCharAttr(const std::string& name);
-	bool ReadBoolAttr(const std::string& name);
-	std::string ReadStrAttr(const std::string& name);
-	Float2 ReadFloat2Attr(const std::string& name);
-	Float3 ReadFloat3Attr(const std::string& name);
-	Float4 ReadFloat4Attr(const std::string& name);
-	Float4x4 ReadFloat4x4Attr(const std::string& name);
-	TextureData ReadTextureDataAttr(const std::string& name);
-	SceneData ReadSceneDataAttr(const std::string& name);
-	ShaderData ReadShaderDataAttr(const std::string& name);
+	// Binary values go to the chunk on top of the stack, text format ignores chunks
+	void BeginChunk(BinaryChunk chunk);
+	void EndChunk();
+
+	template<typename T>
+	void WriteBinaryValue(const T& value)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		std::vector<uint8_t>& chunk = m_OutputChunks[EnumToInt(m_ChunkStack.back())];
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+		chunk.insert(chunk.end(), bytes, bytes + sizeof(T));
+	}
+
+	template<typename T>
+	T ReadBinaryValue();
+
+	void WriteBinaryString(const std::string& value);
+	std::string_view ReadBinaryString();
+
+	void WriteBinaryDocument(UniqueID firstID);
+	bool ReadBinaryDocument(const void* data, size_t size, UniqueID& firstID);
+
+	// Text reads go line by line over the mapped file, values are views into it until they are converted
+	// Attribute name is checked as name + suffix so compound values don't build names
+	void SetTextInput(std::string_view text);
+	bool ReadLine(std::string_view& line);
+	std::string_view ReadAttribute(std::string_view name, std::string_view suffix = {});
+
+	template<typename T>
+	T ParseNumber(std::string_view str);
+
+	int ReadIntAttr(std::string_view name, std::string_view suffix = {});
+	float ReadFloatAttr(std::string_view name, std::string_view suffix = {});
+	char ReadCharAttr(std::string_view name, std::string_view suffix = {});
+	bool ReadBoolAttr(std::string_view name, std::string_view suffix = {});
+	std::string ReadStrAttr(std::string_view name, std::string_view suffix = {});
+	Float2 ReadFloat2Attr(std::string_view name);
+	Float3 ReadFloat3Attr(std::string_view name);
+	Float4 ReadFloat4Attr(std::string_view name);
+	Float4x4 ReadFloat4x4Attr(std::string_view name);
+	TextureData ReadTextureDataAttr(std::string_view name);
+	SceneData ReadSceneDataAttr(std::string_view name);
+	SamplerData ReadSamplerDataAttr(std::string_view name);
+	BufferData ReadBufferDataAttr(std::string_view name);
+	ShaderData ReadShaderDataAttr(std::string_view name);
 
 private:
 	bool m_UseTokens = false;
+	bool m_Binary = false;
 	unsigned m_Version = VERSION;
 
-	std::ifstream m_Input;
-	std::ofstream m_Output;
+	std::string m_Output;
+
+	// Text document being read
+	const char* m_TextCursor = nullptr;
+	const char* m_TextEnd = nullptr;
+
+	std::vector<BinaryChunk> m_ChunkStack;
+
+	std::vector<uint8_t> m_OutputChunks[EnumToInt(BinaryChunk::Count)];
+	std::vector<std::string> m_OutputStrings;
+	std::unordered_map<std::string, uint32_t> m_OutputStringIndices;
+
+	// Point into the mapped binary document while it is being read
+	BinaryChunkReader m_InputChunks[EnumToInt(BinaryChunk::Count)];
+	std::vector<std::string_view> m_InputStrings;
+
+	// Set while a binary document with custom node index is read, deferred graphs share it
+	SharedPtr<DeferredBinaryDocument> m_DeferredDocument;
+
+	// Set while a binary document is written, output string table starts with its strings so copied graphs stay valid
+	const DeferredBinaryDocument* m_CopiedDocument = nullptr;
+
+	// Pins of removed node types in the graph being read, links to them are not added
+	std::unordered_set<PinID> m_RemovedPins;
+
+	JournalState m_Journal;
 
 	bool m_OperationSuccess;
 };
\ No newline at end of file
@@ -0,0 +1,391 @@
+#include "NodeGraphStream.h"
+
+#include <cstring>
+
+#include "../Util/AtomicFile.h"
+#include "../Util/Hash.h"
+
+//////////////////////////////
+///			WRITER			//
+//////////////////////////////
+
+NodeGraphWriter::~NodeGraphWriter()
+{
+	if (IsOpen()) Close();
+}
+
+bool NodeGraphWriter::Open(const std::string& path)
+{
+	ASSERT(!IsOpen());
+
+	const NodeGraphSerializer::JournalHeader header{ NodeGraphSerializer::JOURNAL_MAGIC, NodeGraphSerializer::VERSION };
+	if (!AtomicFile::Write(path, &header, sizeof(header))) return false;
+
+	m_Serializer.BeginJournalRecords();
+	m_Path = path;
+	m_Pending.clear();
+	m_Failed = false;
+	m_CustomNodeNames.clear();
+	m_DocumentChanged = true;
+	return true;
+}
+
+bool NodeGraphWriter::Close()
+{
+	ASSERT(IsOpen());
+
+	Flush();
+	m_Path.clear();
+	m_Pending = {};
+	return !m_Failed;
+}
+
+VariableID NodeGraphWriter::AddVariable(const Variable& variable)
+{
+	ASSERT(IsOpen());
+
+	const VariableID id = IDGen::Generate();
+	AddVariable(id, variable);
+	return id;
+}
+
+void NodeGraphWriter::AddVariable(VariableID id, const Variable& variable)
+{
+	ASSERT(IsOpen());
+
+	m_Serializer.WriteVariable(id, variable);
+	AddRecord(NodeGraphSerializer::JournalRecord::Variable, id);
+}
+
+void NodeGraphWriter::AddCustomNode(CustomEditorNode* customNode)
+{
+	ASSERT(IsOpen());
+
+	m_Serializer.WriteCustomNode(customNode);
+	AddRecord(NodeGraphSerializer::JournalRecord::CustomNode, Hash::Fnv1a64(customNode->GetName()));
+
+	m_CustomNodeNames.push_back(customNode->GetName());
+	m_DocumentChanged = true;
+}
+
+void NodeGraphWriter::AddNode(EditorNode* node)
+{
+	ASSERT(IsOpen());
+
+	m_Serializer.WriteJournalNode(node, nullptr);
+	AddRecord(NodeGraphSerializer::JournalRecord::Node, node->GetID());
+}
+
+void NodeGraphWriter::AddNode(EditorNode* node, const ImVec2& position)
+{
+	ASSERT(IsOpen());
+
+	m_Serializer.WriteJournalNode(node, &position);
+	AddRecord(NodeGraphSerializer::JournalRecord::Node, node->GetID());
+}
+
+void NodeGraphWriter::AddLink(const EditorNodeLink& link)
+{
+	ASSERT(IsOpen());
+
+	m_Serializer.WriteLink(link);
+	AddRecord(NodeGraphSerializer::JournalRecord::Link, link.ID);
+}
+
+void NodeGraphWriter::AddRecord(NodeGraphSerializer::JournalRecord record, uint64_t key)
+{
+	const NodeGraphSerializer::JournalRecordData data = m_Serializer.TakeJournalRecord(record, key);
+	NodeGraphSerializer::WriteJournalEntry(m_Pending, NodeGraphSerializer::JournalEntry::Put, record, key, data.Hash, data.Data);
+
+	if (m_Pending.size() >= FLUSH_SIZE) Flush();
+}
+
+bool NodeGraphWriter::Flush()
+{
+	if (m_DocumentChanged)
+	{
+		m_Serializer.WriteAttribute("Count", m_CustomNodeNames.size());
+		for (const std::string& name : m_CustomNodeNames)
+			m_Serializer.WriteAttribute("Name", name);
+
+		const NodeGraphSerializer::JournalRecordData data = m_Serializer.TakeJournalRecord(NodeGraphSerializer::JournalRecord::Document, 0);
+		NodeGraphSerializer::WriteJournalEntry(m_Pending, NodeGraphSerializer::JournalEntry::Put, NodeGraphSerializer::JournalRecord::Document, 0, data.Hash, data.Data);
+		m_DocumentChanged = false;
+	}
+
+	if (m_Pending.empty()) return !m_Failed;
+
+	// Each batch is committed on its own, readers stop at the last commit that made it to the disk
+	NodeGraphSerializer::WriteJournalCommit(m_Pending, 0, IDGen::Generate());
+	if (!AtomicFile::Append(m_Path, m_Pending.data(), m_Pending.size())) m_Failed = true;
+	m_Pending.clear();
+
+	return !m_Failed;
+}
+
+//////////////////////////////
+///			READER			//
+//////////////////////////////
+
+bool NodeGraphReader::Open(const std::string& path)
+{
+	m_Serializer.m_OperationSuccess = true;
+	m_Serializer.m_ChunkStack.clear();
+
+	if (!m_File.Open(path))
+	{
+		m_Serializer.m_OperationSuccess = false;
+		return false;
+	}
+
+	uint32_t magic = 0;
+	if (m_File.GetSize() >= sizeof(magic)) memcpy(&magic, m_File.GetData(), sizeof(magic));
+
+	m_IsJournal = magic == NodeGraphSerializer::JOURNAL_MAGIC;
+	m_Serializer.m_Binary = magic == NodeGraphSerializer::BINARY_MAGIC;
+	const bool opened = m_IsJournal ? OpenJournal() : OpenDocument();
+	if (!opened) m_Serializer.m_OperationSuccess = false;
+	return opened;
+}
+
+bool NodeGraphReader::OpenDocument()
+{
+	NodeGraphSerializer& s = m_Serializer;
+
+	if (s.m_Binary)
+	{
+		if (!s.ReadBinaryDocument(m_File.GetData(), m_File.GetSize(), m_FirstID)) return false;
+	}
+	else
+	{
+		s.SetTextInput({ static_cast<const char*>(m_File.GetData()), m_File.GetSize() });
+		s.m_Version = s.ReadIntAttr("Version");
+	}
+
+	if (s.m_Version < 7) return false;
+
+	if (!s.m_Binary)
+	{
+		s.m_UseTokens = s.ReadIntAttr("UseTokens");
+		m_FirstID = s.ReadIntAttr("FirstID");
+	}
+
+	const char* variablesCursor = nullptr;
+	unsigned variableCount = 0;
+	if (s.m_Version >= 9)
+	{
+		variableCount = s.BeginListRead(NodeGraphSerializer::BinaryChunk::Variables);
+		variablesCursor = s.m_TextCursor;
+
+		// Binary variables have their own chunk, only text ones are in the way of custom nodes
+		if (!s.m_Binary)
+		{
+			for (unsigned i = 0; i < variableCount && s.m_OperationSuccess; i++)
+			{
+				VariableID id = 0;
+				Variable variable{};
+				s.ReadVariable(id, variable);
+			}
+			s.EndListRead(NodeGraphSerializer::BinaryChunk::Variables);
+		}
+	}
+
+	m_CustomNodePointers = s.ReadCustomNodeList();
+	for (CustomEditorNode* customNode : m_CustomNodePointers)
+		m_CustomNodes.push_back(Ptr<CustomEditorNode>(customNode));
+
+	// Graph sections are read from the same mapping, reader keeps the deferred document alive until it is destroyed
+	s.KeepDeferredMapping(m_File);
+
+	if (!s.m_OperationSuccess) return false;
+
+	m_GraphCursor = s.m_TextCursor;
+	if (s.m_Version >= 9)
+	{
+		if (!s.m_Binary) s.m_TextCursor = variablesCursor;
+		m_Section = Section::Variables;
+		m_Remaining = variableCount;
+	}
+	else
+	{
+		BeginSection(Section::Nodes);
+	}
+	return s.m_OperationSuccess;
+}
+
+bool NodeGraphReader::OpenJournal()
+{
+	NodeGraphSerializer& s = m_Serializer;
+
+	// Whole log is replayed before the first event, unlike documents a journal can't be streamed in file order
+	if (!NodeGraphSerializer::ReplayJournal(m_File.GetData(), m_File.GetSize(), m_Journal)) return false;
+
+	s.m_Binary = false;
+	s.m_UseTokens = false;
+	s.m_Version = m_Journal.Version;
+	m_FirstID = m_Journal.FirstID;
+
+	s.ReadJournalCustomNodes(m_Journal, m_CustomNodePointers);
+	for (CustomEditorNode* customNode : m_CustomNodePointers)
+		m_CustomNodes.push_back(Ptr<CustomEditorNode>(customNode));
+
+	BeginSection(Section::Variables);
+	return s.m_OperationSuccess;
+}
+
+bool NodeGraphReader::Next(NodeGraphEvent& event)
+{
+	if (m_Section == Section::End || !m_Serializer.m_OperationSuccess) return false;
+
+	event.Node = nullptr;
+
+	// Links to pins of removed node types are dropped, same as when the whole document is read
+	bool hasEvent = false;
+	do
+	{
+		hasEvent = m_IsJournal ? NextInJournal(event) : NextInDocument(event);
+	} while (hasEvent && event.Type == NodeGraphEventType::Link && m_Serializer.IsRemovedPinLink(event.Link));
+
+	return hasEvent && m_Serializer.m_OperationSuccess;
+}
+
+bool NodeGraphReader::NextInDocument(NodeGraphEvent& event)
+{
+	NodeGraphSerializer& s = m_Serializer;
+
+	while (m_Remaining == 0)
+	{
+		if (!s.m_OperationSuccess) return false;
+
+		switch (m_Section)
+		{
+		case Section::Variables:
+			s.EndListRead(NodeGraphSerializer::BinaryChunk::Variables);
+			if (!s.m_Binary) s.m_TextCursor = m_GraphCursor;
+			BeginSection(Section::Nodes);
+			break;
+		case Section::Nodes:
+			s.EndListRead(NodeGraphSerializer::BinaryChunk::Nodes);
+			BeginSection(Section::Links);
+			break;
+		case Section::Links:
+			s.EndListRead(NodeGraphSerializer::BinaryChunk::Links);
+			BeginSection(Section::NodePositions);
+			break;
+		case Section::NodePositions:
+			s.EndListRead(NodeGraphSerializer::BinaryChunk::NodePositions);
+			m_Section = Section::End;
+			return false;
+		default:
+			return false;
+		}
+	}
+	m_Remaining--;
+
+	switch (m_Section)
+	{
+	case Section::Variables:
+		event.Type = NodeGraphEventType::Variable;
+		s.BeginChunk(NodeGraphSerializer::BinaryChunk::Variables);
+		s.ReadVariable(event.ID, event.Value);
+		s.EndChunk();
+		break;
+	case Section::Nodes:
+		event.Type = NodeGraphEventType::Node;
+		s.BeginChunk(NodeGraphSerializer::BinaryChunk::Nodes);
+		event.Node = Ptr<EditorNode>(s.ReadNode(m_ParentGraph, m_CustomNodePointers));
+		s.EndChunk();
+		break;
+	case Section::Links:
+		event.Type = NodeGraphEventType::Link;
+		s.BeginChunk(NodeGraphSerializer::BinaryChunk::Links);
+		event.Link = s.ReadLink();
+		s.EndChunk();
+		break;
+	case Section::NodePositions:
+		event.Type = NodeGraphEventType::NodePosition;
+		s.BeginChunk(NodeGraphSerializer::BinaryChunk::NodePositions);
+		event.ID = s.ReadIntAttr("ID");
+		event.Position.x = s.ReadFloatAttr("Pos.X");
+		event.Position.y = s.ReadFloatAttr("Pos.Y");
+		s.EndChunk();
+		break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+bool NodeGraphReader::NextInJournal(NodeGraphEvent& event)
+{
+	NodeGraphSerializer& s = m_Serializer;
+
+	// Position is stored with its node and comes right after it
+	if (m_PendingPosition)
+	{
+		event.Type = NodeGraphEventType::NodePosition;
+		event.ID = m_PendingPositionNode;
+		event.Position = m_PendingPositionValue;
+		m_PendingPosition = false;
+		return true;
+	}
+
+	while (m_JournalRecordIndex == m_JournalRecords.size())
+	{
+		switch (m_Section)
+		{
+		case Section::Variables:
+			BeginSection(Section::Nodes);
+			break;
+		case Section::Nodes:
+			BeginSection(Section::Links);
+			break;
+		default:
+			m_Section = Section::End;
+			return false;
+		}
+	}
+
+	s.SetTextInput(m_JournalRecords[m_JournalRecordIndex++].second);
+	switch (m_Section)
+	{
+	case Section::Variables:
+		event.Type = NodeGraphEventType::Variable;
+		s.ReadVariable(event.ID, event.Value);
+		break;
+	case Section::Nodes:
+		event.Type = NodeGraphEventType::Node;
+		event.Node = Ptr<EditorNode>(s.ReadNode(m_ParentGraph, m_CustomNodePointers));
+		if (s.ReadBoolAttr("HasPosition"))
+		{
+			m_PendingPosition = true;
+			m_PendingPositionNode = event.Node->GetID();
+			m_PendingPositionValue.x = s.ReadFloatAttr("Pos.X");
+			m_PendingPositionValue.y = s.ReadFloatAttr("Pos.Y");
+		}
+		break;
+	case Section::Links:
+		event.Type = NodeGraphEventType::Link;
+		event.Link = s.ReadLink();
+		break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+void NodeGraphReader::BeginSection(Section section)
+{
+	m_Section = section;
+
+	if (m_IsJournal)
+	{
+		static constexpr NodeGraphSerializer::JournalRecord SECTION_RECORDS[] = { NodeGraphSerializer::JournalRecord::Variable, NodeGraphSerializer::JournalRecord::Node, NodeGraphSerializer::JournalRecord::Link };
+		m_JournalRecords = NodeGraphSerializer::GetSortedJournalRecords(m_Journal, SECTION_RECORDS[EnumToInt(section)]);
+		m_JournalRecordIndex = 0;
+		return;
+	}
+
+	static constexpr NodeGraphSerializer::BinaryChunk SECTION_CHUNKS[] = { NodeGraphSerializer::BinaryChunk::Variables, NodeGraphSerializer::BinaryChunk::Nodes, NodeGraphSerializer::BinaryChunk::Links, NodeGraphSerializer::BinaryChunk::NodePositions };
+	m_Remaining = m_Serializer.BeginListRead(SECTION_CHUNKS[EnumToInt(section)]);
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../Common.h"
+#include "../IDGen.h"
+#include "../Editor/EditorNode.h"
+#include "../Util/MappedFile.h"
+#include "NodeGraph.h"
+#include "NodeGraphSerializer.h"
+#include "VariablePool.h"
+
+// Streaming access to documents for tools that generate or scan graphs too big to hold in memory
+
+// Builds a journal document (.rnj) record by record, nothing is kept after a record is written
+// Records are appended to the file in batches and every batch is committed, so a document cut short by a crash
+// still opens with everything up to the last batch. Convert turns the result into a text or binary document
+class NodeGraphWriter
+{
+	// Pending records are appended once they reach this size
+	static constexpr size_t FLUSH_SIZE = 1 << 20;
+
+public:
+	NodeGraphWriter() = default;
+	~NodeGraphWriter();
+
+	NodeGraphWriter(const NodeGraphWriter&) = delete;
+	NodeGraphWriter& operator=(const NodeGraphWriter&) = delete;
+
+	bool Open(const std::string& path);
+
+	// Commits what is pending, returns false if any write since Open failed
+	bool Close();
+
+	VariableID AddVariable(const Variable& variable);
+
+	// Keeps the ID the variable has in another document, nodes that reference it don't have to be remapped
+	void AddVariable(VariableID id, const Variable& variable);
+
+	// Definition has to be added before nodes that use it, custom node stays owned by the caller
+	void AddCustomNode(CustomEditorNode* customNode);
+
+	// Node is written right away and stays owned by the caller, it can be deleted once this returns
+	void AddNode(EditorNode* node);
+	void AddNode(EditorNode* node, const ImVec2& position);
+
+	void AddLink(const EditorNodeLink& link);
+
+	bool IsOpen() const { return !m_Path.empty(); }
+
+private:
+	void AddRecord(NodeGraphSerializer::JournalRecord record, uint64_t key);
+	bool Flush();
+
+private:
+	NodeGraphSerializer m_Serializer;
+
+	std::string m_Path;
+	std::string m_Pending;
+	bool m_Failed = false;
+
+	// Document record lists custom nodes in the order they are read, it is written again when it changes
+	std::vector<std::string> m_CustomNodeNames;
+	bool m_DocumentChanged = false;
+};
+
+enum class NodeGraphEventType
+{
+	Variable,
+	Node,
+	Link,
+	NodePosition,
+};
+
+struct NodeGraphEvent
+{
+	NodeGraphEventType Type = NodeGraphEventType::Variable;
+
+	// Variable ID for variables, node ID for node positions
+	UniqueID ID = 0;
+	Variable Value{};
+	Ptr<EditorNode> Node;
+	EditorNodeLink Link{};
+	ImVec2 Position{ 0.0f, 0.0f };
+};
+
+// Reads a document of any format as a sequence of events: variables, nodes, links and node positions of the main graph
+// Only one element is alive at a time, custom node definitions are the exception since instances need them
+// Nodes of removed types come as pinless Deprecated placeholders and links to their pins are skipped
+// Opening a journal is O(records): a record is final only once the whole log is replayed, since any later entry can
+// overwrite or remove its key, so the index of live records is built up front and each section is sorted by ID
+// The index holds views into the mapping, not copies, and saving compacts the log once it is twice the live size,
+// so opening costs a pass over at most twice the document plus a small entry per live record
+class NodeGraphReader
+{
+	enum class Section
+	{
+		Variables,
+		Nodes,
+		Links,
+		NodePositions,
+		End,
+	};
+
+public:
+	NodeGraphReader() = default;
+
+	NodeGraphReader(const NodeGraphReader&) = delete;
+	NodeGraphReader& operator=(const NodeGraphReader&) = delete;
+
+	bool Open(const std::string& path);
+
+	// Fills in the next event, returns false once the document ends or fails to read
+	bool Next(NodeGraphEvent& event);
+
+	bool Failed() const { return !m_Serializer.m_OperationSuccess; }
+
+	// IDs generated while reading start after this one, same as Deserialize returns
+	UniqueID GetFirstID() const { return m_FirstID; }
+
+	// Instances of custom nodes point to these, they live as long as the reader
+	const CustomNodeList& GetCustomNodes() const { return m_CustomNodes; }
+
+private:
+	bool OpenDocument();
+	bool OpenJournal();
+	bool NextInDocument(NodeGraphEvent& event);
+	bool NextInJournal(NodeGraphEvent& event);
+	void BeginSection(Section section);
+
+private:
+	NodeGraphSerializer m_Serializer;
+	MappedFile m_File;
+
+	UniqueID m_FirstID = 0;
+	CustomNodeList m_CustomNodes;
+	std::vector<CustomEditorNode*> m_CustomNodePointers;
+
+	// Custom node instances read from the stream point to this graph as their parent, it stays empty
+	NodeGraph m_ParentGraph;
+
+	Section m_Section = Section::End;
+	unsigned m_Remaining = 0;
+
+	// Text documents have variables before custom nodes, Open skips them to read custom nodes and goes back,
+	// once variables are read the cursor jumps to the main graph
+	const char* m_GraphCursor = nullptr;
+
+	// Journal records are read in ID order from the replayed log
+	bool m_IsJournal = false;
+	NodeGraphSerializer::JournalContents m_Journal;
+	std::vector<std::pair<uint64_t, std::string_view>> m_JournalRecords;
+	size_t m_JournalRecordIndex = 0;
+	bool m_PendingPosition = false;
+	NodeID m_PendingPositionNode = 0;
+	ImVec2 m_PendingPositionValue{ 0.0f, 0.0f };
+};
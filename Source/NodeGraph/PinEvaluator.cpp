@@ -235,6 +235,7 @@ Float4x4ValueNode* PinEvaluator::EvaluateFloat4x4(EditorNodePin pin)
 	case EditorNodeType::Transform_Scale_Float4x4: return EvaluateFloat4x4Scale(static_cast<Float4x4ScaleTransformEditorNode*>(node));
 	case EditorNodeType::Transform_LookAt_Float4x4: return EvaluateFloat4x4LookAt(static_cast<Float4x4LookAtTransformEditorNode*>(node));
 	case EditorNodeType::Transform_PerspectiveProjection_Float4x4: return EvaluateFloat4x4Perspective(static_cast<Float4x4PerspectiveTransformEditorNode*>(node));
+	case EditorNodeType::GetObjectTransform: return EvaluateGetObjectTransform(static_cast<GetObjectTransformEditorNode*>(node));
 	case EditorNodeType::Pin: return EvaluatePinNode<Float4x4ValueNode>(static_cast<PinEditorNode*>(node));
 	case EditorNodeType::Custom: return EvaluateCustomNode<Float4x4ValueNode>(static_cast<CustomEditorNode*>(node), pin);
 	default:
@@ -257,7 +258,12 @@ TextureValueNode* PinEvaluator::EvaluateTexture(EditorNodePin pin)
 	EditorNode* node = GetNodeGraph()->GetPinOwner(pin.ID);
 	switch (node->GetType())
 	{
-	case EditorNodeType::Variable: return EvaluateRenderResourceVariable<Texture*>(static_cast<VariableEditorNode*>(node));
+	case EditorNodeType::Variable:
+	{
+		VariableEditorNode* variableNode = static_cast<VariableEditorNode*>(node);
+		m_EvaluatedTextures.push_back(variableNode->GetVariableID());
+		return EvaluateRenderResourceVariable<Texture*>(variableNode);
+	}
 	case EditorNodeType::Pin: return EvaluatePinNode<TextureValueNode>(static_cast<PinEditorNode*>(node));
 	case EditorNodeType::Custom: return EvaluateCustomNode<TextureValueNode>(static_cast<CustomEditorNode*>(node), pin);
 	default:
@@ -280,6 +286,8 @@ BufferValueNode* PinEvaluator::EvaluateBuffer(EditorNodePin pin)
 	EditorNode* node = GetNodeGraph()->GetPinOwner(pin.ID);
 	switch (node->GetType())
 	{
+	case EditorNodeType::Variable: return EvaluateRenderResourceVariable<Buffer*>(static_cast<VariableEditorNode*>(node));
+	case EditorNodeType::GetSkinPalette: return EvaluateGetSkinPalette(static_cast<GetSkinPaletteEditorNode*>(node));
 	case EditorNodeType::Pin: return EvaluatePinNode<BufferValueNode>(static_cast<PinEditorNode*>(node));
 	case EditorNodeType::Custom: return EvaluateCustomNode<BufferValueNode>(static_cast<CustomEditorNode*>(node), pin);
 	default:
@@ -391,20 +399,21 @@ SceneObjectValueNode* PinEvaluator::EvaluateSceneObject(EditorNodePin pin)
 	if (pin.Type == PinType::Invalid)
 	{
 		m_ErrorMessages.push_back("SceneObject pin input not linked!");
-		return new ConstantValueNode<SceneObject*>({});
+		return new ConstantValueNode<SceneObject>({});
 	}
 
 	EditorNode* node = GetNodeGraph()->GetPinOwner(pin.ID);
 	switch (node->GetType())
 	{
 	case EditorNodeType::ForEachSceneObject: return EvaluateForEachSceneObject(static_cast<ForEachSceneObjectEditorNode*>(node));
+	case EditorNodeType::ForEachVisibleSceneObject: return EvaluateForEachVisibleSceneObject(static_cast<ForEachVisibleSceneObjectEditorNode*>(node));
 	case EditorNodeType::Pin: return EvaluatePinNode<SceneObjectValueNode>(static_cast<PinEditorNode*>(node));
 	case EditorNodeType::Custom: return EvaluateCustomNode<SceneObjectValueNode>(static_cast<CustomEditorNode*>(node), pin);
 	default:
 		NOT_IMPLEMENTED;
 		m_ErrorMessages.push_back("[NodeGraphCompiler::EvaluateRenderState] internal error!");
 	}
-	return new ConstantValueNode<SceneObject*>({});
+	return new ConstantValueNode<SceneObject>({});
 }
 
 SceneValueNode* PinEvaluator::EvaluateScene(EditorNodePin pin)
@@ -430,6 +439,29 @@ SceneValueNode* PinEvaluator::EvaluateScene(EditorNodePin pin)
 	return new ConstantValueNode<Scene*>({});
 }
 
+SamplerValueNode* PinEvaluator::EvaluateSampler(EditorNodePin pin)
+{
+	pin = GetOutputPinIfInput(*GetNodeGraph(), pin);
+	if (pin.Type == PinType::Invalid)
+	{
+		m_ErrorMessages.push_back("Sampler pin input not linked!");
+		return new ConstantValueNode<Sampler*>(nullptr);
+	}
+	ASSERT(pin.Type == PinType::Sampler);
+
+	EditorNode* node = GetNodeGraph()->GetPinOwner(pin.ID);
+	switch (node->GetType())
+	{
+	case EditorNodeType::Variable: return EvaluateRenderResourceVariable<Sampler*>(static_cast<VariableEditorNode*>(node));
+	case EditorNodeType::Pin: return EvaluatePinNode<SamplerValueNode>(static_cast<PinEditorNode*>(node));
+	case EditorNodeType::Custom: return EvaluateCustomNode<SamplerValueNode>(static_cast<CustomEditorNode*>(node), pin);
+	default:
+		NOT_IMPLEMENTED;
+		m_ErrorMessages.push_back("[NodeGraphCompiler::EvaluateSampler] internal error!");
+	}
+	return new ConstantValueNode<Sampler*>(nullptr);
+}
+
 IntValueNode* PinEvaluator::EvaluateInt(IntEditorNode* node)
 {
 	return new ConstantValueNode<int>(node->GetValue());
@@ -664,6 +696,7 @@ MeshValueNode* PinEvaluator::EvaluateGetCubeMesh(GetCubeMeshEditorNode* node)
 	extraInfo.MeshVertexBits.Texcoord = false;
 	extraInfo.MeshVertexBits.Normal = false;
 	extraInfo.MeshVertexBits.Tangent = false;
+	extraInfo.MeshVertexBits.Skinning = false;
 	return new StaticResourceNode<Mesh*, ExecutorStaticResource::CubeMesh>(extraInfo);
 }
 
@@ -676,9 +709,22 @@ MeshValueNode* PinEvaluator::EvaluateGetMesh(GetMeshEditorNode* node)
 	extraInfo.MeshVertexBits.Texcoord = node->GetTexcoordBit();
 	extraInfo.MeshVertexBits.Normal = node->GetNormalBit();
 	extraInfo.MeshVertexBits.Tangent = node->GetTangentBit();
+	extraInfo.MeshVertexBits.Skinning = node->GetSkinningBit();
 	return new GetMeshValueNode(sceneObjectNode, extraInfo);
 }
 
+BufferValueNode* PinEvaluator::EvaluateGetSkinPalette(GetSkinPaletteEditorNode* node)
+{
+	SceneObjectValueNode* sceneObjectNode = EvaluateSceneObject(node->GetSceneObjectPin());
+	return new GetSkinPaletteValueNode(sceneObjectNode);
+}
+
+Float4x4ValueNode* PinEvaluator::EvaluateGetObjectTransform(GetObjectTransformEditorNode* node)
+{
+	SceneObjectValueNode* sceneObjectNode = EvaluateSceneObject(node->GetSceneObjectPin());
+	return new GetObjectTransformValueNode(sceneObjectNode);
+}
+
 BindTableValueNode* PinEvaluator::EvaluateBindTable(BindTableEditorNode* node)
 {
 	BindTable* bindTable = new BindTable{};
@@ -690,6 +736,12 @@ BindTableValueNode* PinEvaluator::EvaluateBindTable(BindTableEditorNode* node)
 		case PinType::Texture:
 			bindTable->Textures.push_back(BindTable::Binding<Texture*>{ pin.Label, Ptr<TextureValueNode>(EvaluateTexture(pin)) });
 			break;
+		case PinType::Sampler:
+			bindTable->Samplers.push_back(BindTable::Binding<Sampler*>{ pin.Label, Ptr<SamplerValueNode>(EvaluateSampler(pin)) });
+			break;
+		case PinType::Buffer:
+			bindTable->Buffers.push_back(BindTable::Binding<Buffer*>{ pin.Label, Ptr<BufferValueNode>(EvaluateBuffer(pin)) });
+			break;
 		case PinType::Float:
 			bindTable->Floats.push_back(BindTable::Binding<float>{pin.Label, Ptr<FloatValueNode>(EvaluateFloat(pin))});
 			break;
@@ -735,5 +787,11 @@ RenderStateValueNode* PinEvaluator::EvaluateRenderState(RenderStateEditorNode* n
 SceneObjectValueNode* PinEvaluator::EvaluateForEachSceneObject(ForEachSceneObjectEditorNode* node)
 {
 	const PinID sceneObjectiteratorPin = node->GetSceneObjectPin().ID;
-	return new IteratorValueNode<SceneObject*>{ sceneObjectiteratorPin };
+	return new IteratorValueNode<SceneObject>{ sceneObjectiteratorPin };
+}
+
+SceneObjectValueNode* PinEvaluator::EvaluateForEachVisibleSceneObject(ForEachVisibleSceneObjectEditorNode* node)
+{
+	const PinID sceneObjectiteratorPin = node->GetSceneObjectPin().ID;
+	return new IteratorValueNode<SceneObject>{ sceneObjectiteratorPin };
 }
\ No newline at end of file
@@ -108,6 +108,7 @@ public:
 	RenderStateValueNode* EvaluateRenderState(EditorNodePin pin);
 	SceneObjectValueNode* EvaluateSceneObject(EditorNodePin pin);
 	SceneValueNode* EvaluateScene(EditorNodePin pin);
+	SamplerValueNode* EvaluateSampler(EditorNodePin pin);
 
 	template<typename ReturnType> ReturnType* EvaluatePin(EditorNodePin pin);
 	template<> BoolValueNode* EvaluatePin<BoolValueNode>(EditorNodePin pin) { return EvaluateBool(pin); }
@@ -126,6 +127,15 @@ public:
 	template<> RenderStateValueNode* EvaluatePin<RenderStateValueNode>(EditorNodePin pin) { return EvaluateRenderState(pin); }
 	template<> SceneObjectValueNode* EvaluatePin<SceneObjectValueNode>(EditorNodePin pin) { return EvaluateSceneObject(pin); }
 	template<> SceneValueNode* EvaluatePin<SceneValueNode>(EditorNodePin pin) { return EvaluateScene(pin); }
+	template<> SamplerValueNode* EvaluatePin<SamplerValueNode>(EditorNodePin pin) { return EvaluateSampler(pin); }
+
+	// Texture variables referenced by pins evaluated since the last call
+	std::vector<VariableID> TakeEvaluatedTextures()
+	{
+		std::vector<VariableID> textures;
+		textures.swap(m_EvaluatedTextures);
+		return textures;
+	}
 
 private:
 	BoolValueNode* EvaluateBool(BoolEditorNode* node);
@@ -171,12 +181,15 @@ private:
 
 	MeshValueNode* EvaluateGetMesh(GetMeshEditorNode* node);
 	MeshValueNode* EvaluateGetCubeMesh(GetCubeMeshEditorNode* node);
+	BufferValueNode* EvaluateGetSkinPalette(GetSkinPaletteEditorNode* node);
+	Float4x4ValueNode* EvaluateGetObjectTransform(GetObjectTransformEditorNode* node);
 
 	BindTableValueNode* EvaluateBindTable(BindTableEditorNode* node);
 
 	RenderStateValueNode* EvaluateRenderState(RenderStateEditorNode* node);
 
 	SceneObjectValueNode* EvaluateForEachSceneObject(ForEachSceneObjectEditorNode* node);
+	SceneObjectValueNode* EvaluateForEachVisibleSceneObject(ForEachVisibleSceneObjectEditorNode* node);
 
 private:
 	const NodeGraph* GetNodeGraph() const { return m_ContextStack.top().Graph; }
@@ -186,4 +199,5 @@ private:
 private:
 	NodeGraphCompilerContextStack m_ContextStack;
 	std::vector<std::string> m_ErrorMessages;
+	std::vector<VariableID> m_EvaluatedTextures;
 };
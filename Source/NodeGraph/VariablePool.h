@@ -1,10 +1,12 @@
 #pragma once
 
 #include <variant>
-#include <unordered_map>
 
 #include "../IDGen.h"
 #include "../Common.h"
+#include "../Util/IDMap.h"
+#include "../Render/Sampler.h"
+#include "../Render/Texture.h"
 
 struct TextureData
 {
@@ -13,6 +15,7 @@ struct TextureData
 	int Height = 0;
 	bool Framebuffer = false;
 	bool DepthStencil = false;
+	TextureFormat Format = TextureFormat::RGBA8;
 };
 
 struct ShaderData
@@ -20,9 +23,25 @@ struct ShaderData
 	std::string Path = "";
 };
 
+struct SamplerData
+{
+	SamplerFilter Filter = SamplerFilter::Trilinear;
+	SamplerWrap Wrap = SamplerWrap::Repeat;
+};
+
+struct BufferData
+{
+	unsigned ByteSize = 0;
+	unsigned Stride = 4;
+};
+
 struct SceneData
 {
 	std::string Path = "";
+	bool OptimizeMeshes = false;
+
+	// Merges scene geometry and creates buffers for GPU culling and indirect drawing
+	bool GPUDriven = false;
 };
 
 // DO NOT CHANGE ORDER OF VALUES
@@ -41,6 +60,8 @@ enum class VariableType
 	Shader,
 	Texture,
 	Scene,
+	Sampler,
+	Buffer,
 
 	Count,
 };
@@ -55,7 +76,9 @@ using VariableData = std::variant<
 	Float4x4,
 	TextureData,
 	ShaderData,
-	SceneData
+	SceneData,
+	SamplerData,
+	BufferData
 >;
 
 struct Variable
@@ -113,6 +136,12 @@ struct Variable
 		case VariableType::Scene:
 			Data = SceneData{};
 			break;
+		case VariableType::Sampler:
+			Data = SamplerData{};
+			break;
+		case VariableType::Buffer:
+			Data = BufferData{};
+			break;
 		default:
 			NOT_IMPLEMENTED;
 		}
@@ -229,7 +258,7 @@ public:
 		}
 	}
 private:
-	std::unordered_map<VariableID, Variable> m_Pool{};
+	IDMap<Variable> m_Pool{};
 };
 
 inline const char* ToString(VariableType variableType)
@@ -247,6 +276,8 @@ inline const char* ToString(VariableType variableType)
 		ENUM_STR_CASE(VariableType, Shader);
 		ENUM_STR_CASE(VariableType, Texture);
 		ENUM_STR_CASE(VariableType, Scene);
+		ENUM_STR_CASE(VariableType, Sampler);
+		ENUM_STR_CASE(VariableType, Buffer);
 	default:
 		NOT_IMPLEMENTED;
 	}
@@ -0,0 +1,16 @@
+#pragma once
+
+// Node property written by an animation channel
+enum class AnimationPath
+{
+	Translation,
+	Rotation,
+	Scale,
+};
+
+enum class AnimationInterpolation
+{
+	Step,
+	Linear,
+	CubicSpline,
+};
@@ -0,0 +1,66 @@
+#include "Bounds.h"
+
+#include <algorithm>
+
+namespace Bounds
+{
+	BoundingSphere ComputeBoundingSphere(const Float3* positions, uint32_t count)
+	{
+		BoundingSphere sphere{};
+		if (!positions || count == 0) return sphere;
+
+		Float3 minPosition = positions[0];
+		Float3 maxPosition = positions[0];
+		for (uint32_t i = 1; i < count; i++)
+		{
+			minPosition = glm::min(minPosition, positions[i]);
+			maxPosition = glm::max(maxPosition, positions[i]);
+		}
+
+		sphere.Center = (minPosition + maxPosition) * 0.5f;
+
+		float radiusSquared = 0.0f;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const Float3 offset = positions[i] - sphere.Center;
+			radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+		}
+		sphere.Radius = std::sqrt(radiusSquared);
+		return sphere;
+	}
+
+	BoundingSphere TransformBoundingSphere(const BoundingSphere& sphere, const Float4x4& transform)
+	{
+		const float scaleX = glm::dot(Float3{ transform[0] }, Float3{ transform[0] });
+		const float scaleY = glm::dot(Float3{ transform[1] }, Float3{ transform[1] });
+		const float scaleZ = glm::dot(Float3{ transform[2] }, Float3{ transform[2] });
+
+		BoundingSphere transformed{};
+		transformed.Center = Float3{ transform * Float4{ sphere.Center, 1.0f } };
+		transformed.Radius = sphere.Radius * std::sqrt(std::max(scaleX, std::max(scaleY, scaleZ)));
+		return transformed;
+	}
+
+	Frustum ExtractFrustum(const Float4x4& viewProjection)
+	{
+		// Gribb-Hartmann, glm is column major so rows are gathered across columns
+		const auto row = [&viewProjection](int index) {
+			return Float4{ viewProjection[0][index], viewProjection[1][index], viewProjection[2][index], viewProjection[3][index] };
+		};
+
+		Frustum frustum{};
+		frustum.Planes[0] = row(3) + row(0); // Left
+		frustum.Planes[1] = row(3) - row(0); // Right
+		frustum.Planes[2] = row(3) + row(1); // Bottom
+		frustum.Planes[3] = row(3) - row(1); // Top
+		frustum.Planes[4] = row(3) + row(2); // Near
+		frustum.Planes[5] = row(3) - row(2); // Far
+
+		for (Float4& plane : frustum.Planes)
+		{
+			const float length = glm::length(Float3{ plane });
+			if (length > 0.0f) plane /= length;
+		}
+		return frustum;
+	}
+}
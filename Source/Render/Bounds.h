@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../Common.h"
+
+struct BoundingSphere
+{
+	Float3 Center{ 0.0f, 0.0f, 0.0f };
+	float Radius = 0.0f;
+};
+
+// Planes are stored as (normal, distance) with normals pointing inside the frustum
+struct Frustum
+{
+	Float4 Planes[6];
+};
+
+namespace Bounds
+{
+	// Sphere around the axis aligned box of the points, not minimal but stable and cheap
+	BoundingSphere ComputeBoundingSphere(const Float3* positions, uint32_t count);
+
+	// Radius is scaled by the largest axis scale so the sphere stays conservative under non uniform scale
+	BoundingSphere TransformBoundingSphere(const BoundingSphere& sphere, const Float4x4& transform);
+
+	// Extracts planes from matrix taking world space to clip space (projection * view)
+	Frustum ExtractFrustum(const Float4x4& viewProjection);
+}
@@ -16,6 +16,19 @@ GLenum GetGLBufferType(BufferType type)
 	return GL_INVALID_ENUM;
 }
 
+GLenum GetGLIndexFormat(IndexFormat format)
+{
+	switch (format)
+	{
+	case IndexFormat::Uint16: return GL_UNSIGNED_SHORT;
+	case IndexFormat::Uint32: return GL_UNSIGNED_INT;
+	default:
+		NOT_IMPLEMENTED;
+		break;
+	}
+	return GL_INVALID_ENUM;
+}
+
 Ptr<Buffer> Buffer::Create(BufferType type, unsigned byteSize, unsigned stride, unsigned flags, const void* data)
 {
 	Buffer* buffer = new Buffer{};
@@ -31,6 +44,14 @@ Ptr<Buffer> Buffer::Create(BufferType type, unsigned byteSize, unsigned stride,
 	return Ptr<Buffer>{buffer};
 }
 
+void Buffer::Upload(const void* data, unsigned byteSize, unsigned byteOffset)
+{
+	ASSERT(byteOffset + byteSize <= ByteSize);
+
+	GL_CALL(glBindBuffer(GetGLBufferType(Type), Handle));
+	GL_CALL(glBufferSubData(GetGLBufferType(Type), byteOffset, byteSize, data));
+}
+
 Buffer::~Buffer()
 {
 	GL_CALL(glDeleteBuffers(1, &Handle));
@@ -18,9 +18,19 @@ enum class BufferType
 	Storage,
 };
 
+enum class IndexFormat
+{
+	Uint16,
+	Uint32,
+};
+
+GLenum GetGLIndexFormat(IndexFormat format);
+
 struct Buffer
 {
 	static Ptr<Buffer> Create(BufferType type, unsigned byteSize, unsigned stride, unsigned flags, const void* data = nullptr);
+
+	void Upload(const void* data, unsigned byteSize, unsigned byteOffset = 0);
 	
 	~Buffer();
 
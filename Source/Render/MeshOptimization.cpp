@@ -0,0 +1,177 @@
+#include "MeshOptimization.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MeshOptimization
+{
+	namespace Forsyth
+	{
+		static constexpr uint32_t CacheSize = 32;
+		static constexpr float CacheDecayPower = 1.5f;
+		static constexpr float LastTriangleScore = 0.75f;
+		static constexpr float ValenceBoostScale = 2.0f;
+		static constexpr float ValenceBoostPower = 0.5f;
+
+		static float ScoreVertex(int cachePosition, uint32_t remainingValence)
+		{
+			// Vertex isn't used by any triangle that is left
+			if (remainingValence == 0) return -1.0f;
+
+			float score = 0.0f;
+			if (cachePosition >= 0)
+			{
+				if (cachePosition < 3)
+				{
+					// Vertices of the last emitted triangle get a fixed score so we don't favor them too much
+					score = LastTriangleScore;
+				}
+				else
+				{
+					const float scaler = 1.0f / (CacheSize - 3);
+					score = std::pow(1.0f - (cachePosition - 3) * scaler, CacheDecayPower);
+				}
+			}
+
+			// Boost vertices with few triangles left so we don't leave lonely triangles behind
+			score += ValenceBoostScale * std::pow((float)remainingValence, -ValenceBoostPower);
+			return score;
+		}
+	}
+
+	float ComputeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0) return 0.0f;
+
+		std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+		uint32_t timestamp = cacheSize + 1;
+		uint32_t misses = 0;
+		for (const uint32_t index : indices)
+		{
+			if (timestamp - cacheTimestamps[index] > cacheSize)
+			{
+				cacheTimestamps[index] = timestamp++;
+				misses++;
+			}
+		}
+		return (float)misses / triangleCount;
+	}
+
+	void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0) return;
+
+		// Vertex -> triangle adjacency
+		// Live triangles of vertex v are adjacency[offsets[v], offsets[v] + valence[v])
+		std::vector<uint32_t> valence(vertexCount, 0);
+		for (const uint32_t index : indices) valence[index]++;
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (uint32_t v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] = adjacencyOffsets[v] + valence[v];
+
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> fillOffsets{ adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 };
+			for (size_t i = 0; i < indices.size(); i++) adjacency[fillOffsets[indices[i]]++] = (uint32_t)(i / 3);
+		}
+
+		std::vector<int> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++) vertexScores[v] = Forsyth::ScoreVertex(-1, valence[v]);
+
+		std::vector<bool> triangleEmitted(triangleCount, false);
+
+		std::vector<uint32_t> cache{};
+		std::vector<uint32_t> newCache{};
+		cache.reserve(Forsyth::CacheSize + 3);
+		newCache.reserve(Forsyth::CacheSize + 3);
+
+		std::vector<uint32_t> output{};
+		output.reserve(indices.size());
+
+		size_t scanCursor = 0;
+		uint32_t bestTriangle = InvalidIndex;
+		while (output.size() < triangleCount * 3)
+		{
+			// No candidate in the cache, take next triangle that isn't emitted
+			if (bestTriangle == InvalidIndex)
+			{
+				while (triangleEmitted[scanCursor]) scanCursor++;
+				bestTriangle = (uint32_t)scanCursor;
+			}
+
+			const uint32_t triangle = bestTriangle;
+			triangleEmitted[triangle] = true;
+
+			newCache.clear();
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				const uint32_t v = indices[3 * triangle + i];
+				output.push_back(v);
+
+				// Remove triangle from vertex's live adjacency
+				uint32_t* begin = adjacency.data() + adjacencyOffsets[v];
+				uint32_t* end = begin + valence[v];
+				std::iter_swap(std::find(begin, end, triangle), end - 1);
+				valence[v]--;
+
+				if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+					newCache.push_back(v);
+			}
+
+			for (const uint32_t v : cache)
+			{
+				if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+					newCache.push_back(v);
+			}
+
+			for (size_t i = 0; i < newCache.size(); i++)
+			{
+				const uint32_t v = newCache[i];
+				cachePositions[v] = i < Forsyth::CacheSize ? (int)i : -1;
+				vertexScores[v] = Forsyth::ScoreVertex(cachePositions[v], valence[v]);
+			}
+
+			// Rescore triangles touched by the cache (including evicted vertices) and pick the best one
+			float bestScore = -1.0f;
+			bestTriangle = InvalidIndex;
+			for (const uint32_t v : newCache)
+			{
+				const uint32_t* begin = adjacency.data() + adjacencyOffsets[v];
+				const uint32_t* end = begin + valence[v];
+				for (const uint32_t* it = begin; it != end; it++)
+				{
+					const uint32_t t = *it;
+					const float score = vertexScores[indices[3 * t]] + vertexScores[indices[3 * t + 1]] + vertexScores[indices[3 * t + 2]];
+					if (score > bestScore)
+					{
+						bestScore = score;
+						bestTriangle = t;
+					}
+				}
+			}
+
+			if (newCache.size() > Forsyth::CacheSize) newCache.resize(Forsyth::CacheSize);
+			std::swap(cache, newCache);
+		}
+
+		// Leftover indices that don't form a full triangle stay on the end
+		output.insert(output.end(), indices.begin() + triangleCount * 3, indices.end());
+		indices = std::move(output);
+	}
+
+	std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t& newVertexCount)
+	{
+		std::vector<uint32_t> remap(vertexCount, InvalidIndex);
+		newVertexCount = 0;
+		for (uint32_t& index : indices)
+		{
+			if (remap[index] == InvalidIndex)
+				remap[index] = newVertexCount++;
+			index = remap[index];
+		}
+		return remap;
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+#include "../Common.h"
+
+namespace MeshOptimization
+{
+	static constexpr uint32_t InvalidIndex = ~0u;
+
+	// Average cache miss ratio (misses per triangle) simulated on a FIFO post-transform cache
+	float ComputeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = 16);
+
+	// Reorders triangles for post-transform vertex cache locality (Tom Forsyth's linear-speed algorithm)
+	void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+	// Renumbers vertices in the order they are first referenced by the index buffer.
+	// Returns remap table (old index -> new index), unreferenced vertices are mapped to InvalidIndex.
+	std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t& newVertexCount);
+
+	template<typename T>
+	std::vector<T> RemapVertices(const T* vertices, const std::vector<uint32_t>& remap, uint32_t newVertexCount)
+	{
+		std::vector<T> remapped{};
+		if (!vertices) return remapped;
+
+		remapped.resize(newVertexCount);
+		for (size_t i = 0; i < remap.size(); i++)
+		{
+			if (remap[i] != InvalidIndex)
+				remapped[remap[i]] = vertices[i];
+		}
+		return remapped;
+	}
+}
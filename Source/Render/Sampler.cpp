@@ -0,0 +1,64 @@
+#include "Sampler.h"
+
+static GLenum GetGLMinFilter(SamplerFilter filter)
+{
+	switch (filter)
+	{
+	case SamplerFilter::Point: return GL_NEAREST_MIPMAP_NEAREST;
+	case SamplerFilter::Bilinear: return GL_LINEAR_MIPMAP_NEAREST;
+	case SamplerFilter::Trilinear: return GL_LINEAR_MIPMAP_LINEAR;
+	default:
+		NOT_IMPLEMENTED;
+		break;
+	}
+	return GL_INVALID_ENUM;
+}
+
+static GLenum GetGLMagFilter(SamplerFilter filter)
+{
+	switch (filter)
+	{
+	case SamplerFilter::Point: return GL_NEAREST;
+	case SamplerFilter::Bilinear:
+	case SamplerFilter::Trilinear: return GL_LINEAR;
+	default:
+		NOT_IMPLEMENTED;
+		break;
+	}
+	return GL_INVALID_ENUM;
+}
+
+static GLenum GetGLWrap(SamplerWrap wrap)
+{
+	switch (wrap)
+	{
+	case SamplerWrap::Repeat: return GL_REPEAT;
+	case SamplerWrap::MirroredRepeat: return GL_MIRRORED_REPEAT;
+	case SamplerWrap::Clamp: return GL_CLAMP_TO_EDGE;
+	default:
+		NOT_IMPLEMENTED;
+		break;
+	}
+	return GL_INVALID_ENUM;
+}
+
+Ptr<Sampler> Sampler::Create(SamplerFilter filter, SamplerWrap wrap)
+{
+	Sampler* sampler = new Sampler{};
+	sampler->Filter = filter;
+	sampler->Wrap = wrap;
+
+	GL_CALL(glGenSamplers(1, &sampler->Handle));
+	GL_CALL(glSamplerParameteri(sampler->Handle, GL_TEXTURE_MIN_FILTER, GetGLMinFilter(filter)));
+	GL_CALL(glSamplerParameteri(sampler->Handle, GL_TEXTURE_MAG_FILTER, GetGLMagFilter(filter)));
+	GL_CALL(glSamplerParameteri(sampler->Handle, GL_TEXTURE_WRAP_S, GetGLWrap(wrap)));
+	GL_CALL(glSamplerParameteri(sampler->Handle, GL_TEXTURE_WRAP_T, GetGLWrap(wrap)));
+	GL_CALL(glSamplerParameteri(sampler->Handle, GL_TEXTURE_WRAP_R, GetGLWrap(wrap)));
+
+	return Ptr<Sampler>(sampler);
+}
+
+Sampler::~Sampler()
+{
+	GL_CALL(glDeleteSamplers(1, &Handle));
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../Common.h"
+
+// DO NOT CHANGE ORDER OF VALUES
+// IT WILL AFFECT HOW WE LOAD OLD SAVE FILES
+// ALWAYS APPEND ON END
+enum class SamplerFilter
+{
+	Point,
+	Bilinear,
+	Trilinear,
+
+	Count,
+};
+
+// DO NOT CHANGE ORDER OF VALUES
+// IT WILL AFFECT HOW WE LOAD OLD SAVE FILES
+// ALWAYS APPEND ON END
+enum class SamplerWrap
+{
+	Repeat,
+	MirroredRepeat,
+	Clamp,
+
+	Count,
+};
+
+struct Sampler
+{
+	static Ptr<Sampler> Create(SamplerFilter filter, SamplerWrap wrap);
+
+	~Sampler();
+
+	SamplerFilter Filter = SamplerFilter::Trilinear;
+	SamplerWrap Wrap = SamplerWrap::Repeat;
+
+	unsigned Handle = 0;
+};
+
+inline const char* ToString(SamplerFilter filter)
+{
+	switch (filter)
+	{
+		ENUM_STR_CASE(SamplerFilter, Point);
+		ENUM_STR_CASE(SamplerFilter, Bilinear);
+		ENUM_STR_CASE(SamplerFilter, Trilinear);
+	default:
+		NOT_IMPLEMENTED;
+	}
+	return "Invalid";
+}
+
+inline const char* ToString(SamplerWrap wrap)
+{
+	switch (wrap)
+	{
+		ENUM_STR_CASE(SamplerWrap, Repeat);
+		ENUM_STR_CASE(SamplerWrap, MirroredRepeat);
+		ENUM_STR_CASE(SamplerWrap, Clamp);
+	default:
+		NOT_IMPLEMENTED;
+	}
+	return "Invalid";
+}
@@ -1,5 +1,13 @@
 #include "SceneLoading.h"
 
+#include <algorithm>
+#include <cctype>
+
+#include "MeshOptimization.h"
+#include "TextureCompression.h"
+#include "TextureFile.h"
+#include "../Util/MappedFile.h"
+
 #pragma warning(disable : 4996)
 #ifndef CGLTF_IMPLEMENTATION
 #define CGLTF_IMPLEMENTATION
@@ -9,33 +17,27 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-#include <glm/gtx/matrix_decompose.hpp>
-#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_precision.hpp>
+#include <glm/gtc/type_ptr.hpp>
 
 #define CGTF_CALL(X) { cgltf_result result = X; ASSERT(result == cgltf_result_success); }
 
 namespace SceneLoading
 {
-	struct NodeTransform
-	{
-		Float3 Position{ 0.0f, 0.0f, 0.0f };
-		Quaternion Rotation{ 0.0f, 0.0f, 0.0f, 0.0f };
-		Float3 Scale{ 1.0f, 1.0f, 1.0f };
-	};
-
 	static std::string GetPathWitoutFile(const std::string& path)
 	{
 		return path.substr(0, 1 + path.find_last_of("\\/"));
 	}
 
-	static Float3 ToFloat3(cgltf_float color[3])
+	static bool HasExtension(const std::string& path, const std::string& extension)
 	{
-		return Float3{ color[0], color[1], color[2] };
+		if (path.size() < extension.size()) return false;
+		return std::equal(extension.rbegin(), extension.rend(), path.rbegin(), [](char a, char b) { return a == std::tolower((unsigned char)b); });
 	}
 
-	static Quaternion ToQuaternion(cgltf_float color[4])
+	static Float3 ToFloat3(cgltf_float color[3])
 	{
-		return Quaternion{ color[0], color[1], color[2], color[3] };
+		return Float3{ color[0], color[1], color[2] };
 	}
 
 	static Float4 ToFloat4(cgltf_float color[4])
@@ -43,70 +45,64 @@ namespace SceneLoading
 		return Float4{ color[0], color[1], color[2], color[3] };
 	}
 
-	static Float4x4 ToFloat4x4(cgltf_float matrix[16])
+	template<cgltf_type TYPE, cgltf_component_type COMPONENT_TYPE>
+	static void ValidateVertexAttribute(cgltf_attribute* attribute)
 	{
-		return Float4x4(matrix[0], matrix[1], matrix[2], matrix[3],
-						matrix[4], matrix[5], matrix[6], matrix[7], 
-						matrix[8], matrix[9], matrix[10], matrix[11],
-						matrix[12], matrix[13], matrix[14], matrix[15]);
+		ASSERT_M(attribute->data->type == TYPE, "[SceneLoading] ASSERT FAILED: attributeAccessor->type == TYPE");
+		ASSERT_M(attribute->data->component_type == COMPONENT_TYPE, "[SceneLoading] ASSERT FAILED: attributeAccessor->component_type == COMPONENT_TYPE");
 	}
 
-	static void DecomposeMatrix(const glm::mat4& m, glm::vec3& pos, glm::quat& rot, glm::vec3& scale)
+	// Buffers are read straight from the mapped files, nothing is copied to the heap on the way
+	static cgltf_result MapBufferFile(const cgltf_memory_options*, const cgltf_file_options*, const char* path, cgltf_size* size, void** data)
 	{
-		pos = m[3];
-		for (int i = 0; i < 3; i++)
-			scale[i] = glm::length(glm::vec3(m[i]));
-		const glm::mat3 rotMtx(
-			glm::vec3(m[0]) / scale[0],
-			glm::vec3(m[1]) / scale[1],
-			glm::vec3(m[2]) / scale[2]);
-		rot = glm::quat_cast(rotMtx);
+		MappedFile file;
+		if (!file.Open(path)) return cgltf_result_file_not_found;
+
+		*size = file.GetSize();
+		*data = const_cast<void*>(file.Release());
+		return cgltf_result_success;
 	}
 
-	NodeTransform GetTransform(cgltf_node* node)
+	static void UnmapBufferFile(const cgltf_memory_options*, const cgltf_file_options*, void* data)
 	{
-		NodeTransform t;
-		t.Position = node->has_translation ? ToFloat3(node->translation) : Float3{ 0.0f, 0.0f, 0.0f };
-		t.Rotation = node->has_rotation ? ToQuaternion(node->rotation) : Quaternion{ 0.0f, 0.0f, 0.0f, 0.0f };
-		t.Scale = node->has_scale ? ToFloat3(node->scale) : Float3{ 1.0f, 1.0f, 1.0f };
-
-		if (node->has_matrix)
-		{
-			const Float4x4 modelMatrix = ToFloat4x4(node->matrix);
-
-			NodeTransform matrixData;
-			DecomposeMatrix(modelMatrix, matrixData.Position, matrixData.Rotation, matrixData.Scale);
-
-			t.Position += matrixData.Position;
-			t.Rotation *= matrixData.Rotation;
-			t.Scale *= matrixData.Scale;
-		}
-		return t;
+		MappedFile::Unmap(data);
 	}
 
-	template<cgltf_type TYPE, cgltf_component_type COMPONENT_TYPE>
-	static void ValidateVertexAttribute(cgltf_attribute* attribute)
+	// Returns pointer into the loaded buffer when elements are tightly packed T, nullptr when they have to be unpacked
+	template<typename T>
+	static T* GetBufferData(cgltf_accessor* accessor)
 	{
-		ASSERT_M(attribute->data->type == TYPE, "[SceneLoading] ASSERT FAILED: attributeAccessor->type == TYPE");
-		ASSERT_M(attribute->data->component_type == COMPONENT_TYPE, "[SceneLoading] ASSERT FAILED: attributeAccessor->component_type == COMPONENT_TYPE");
+		if (accessor->is_sparse || !accessor->buffer_view || accessor->stride != sizeof(T)) return nullptr;
+
+		const uint8_t* buffer = cgltf_buffer_view_data(accessor->buffer_view);
+		if (!buffer) return nullptr;
+
+		const void* data = buffer + accessor->offset;
+		return static_cast<T*>(const_cast<void*>(data));
 	}
 
+	// Interleaved and sparse accessors are unpacked into the storage
 	template<typename T>
-	static T* GetBufferData(cgltf_accessor* accessor)
+	static T* GetAttributeData(cgltf_accessor* accessor, std::vector<T>& storage)
 	{
-		unsigned char* buffer = (unsigned char*)accessor->buffer_view->buffer->data + accessor->buffer_view->offset;
-		void* data = buffer + accessor->offset;
-		return static_cast<T*>(data);
+		if (T* data = GetBufferData<T>(accessor)) return data;
+
+		storage.resize(accessor->count);
+		cgltf_accessor_unpack_floats(accessor, glm::value_ptr(storage[0]), accessor->count * sizeof(T) / sizeof(float));
+		return storage.data();
 	}
 
 	template<typename T>
-	static void FetchIndexData(cgltf_accessor* indexAccessor, std::vector<uint32_t>& buffer)
+	static bool FetchIndexData(cgltf_accessor* indexAccessor, std::vector<uint32_t>& buffer)
 	{
 		T* indexData = GetBufferData<T>(indexAccessor);
+		if (!indexData) return false;
+
 		for (size_t i = 0; i < indexAccessor->count; i++)
 		{
 			buffer[i] = indexData[i];
 		}
+		return true;
 	}
 
 	static void LoadIB(cgltf_accessor* indexAccessor, std::vector<uint32_t>& buffer)
@@ -116,11 +112,18 @@ namespace SceneLoading
 
 		buffer.resize(indexAccessor->count);
 
+		bool fetched = false;
 		switch (indexAccessor->component_type)
 		{
-		case cgltf_component_type_r_16u: FetchIndexData<uint16_t>(indexAccessor, buffer); break;
-		case cgltf_component_type_r_32u: FetchIndexData<uint32_t>(indexAccessor, buffer); break;
-		default: NOT_IMPLEMENTED;
+		case cgltf_component_type_r_16u: fetched = FetchIndexData<uint16_t>(indexAccessor, buffer); break;
+		case cgltf_component_type_r_32u: fetched = FetchIndexData<uint32_t>(indexAccessor, buffer); break;
+		default: break;
+		}
+
+		if (!fetched)
+		{
+			for (size_t i = 0; i < indexAccessor->count; i++)
+				buffer[i] = (uint32_t)cgltf_accessor_read_index(indexAccessor, i);
 		}
 	}
 
@@ -132,6 +135,18 @@ namespace SceneLoading
 		Float2* Texcoords = nullptr;
 		Float3* Normals = nullptr;
 		Float4* Tangents = nullptr;
+
+		// Converted from any glTF component type, only the first set is used
+		glm::u16vec4* Joints = nullptr;
+		Float4* Weights = nullptr;
+
+		// Storage for attributes that can't be used in place
+		std::vector<Float3> PositionsData;
+		std::vector<Float2> TexcoordsData;
+		std::vector<Float3> NormalsData;
+		std::vector<Float4> TangentsData;
+		std::vector<glm::u16vec4> JointsData;
+		std::vector<Float4> WeightsData;
 	};
 
 	VertexAttributesData LoadAttributes(cgltf_attribute* attributes, cgltf_size attributesNumber)
@@ -147,37 +162,102 @@ namespace SceneLoading
 			{
 			case cgltf_attribute_type_position:
 				ValidateVertexAttribute<cgltf_type_vec3, cgltf_component_type_r_32f>(vertexAttribute);
-				attributesData.Positions = GetBufferData<Float3>(vertexAttribute->data);
+				attributesData.Positions = GetAttributeData(vertexAttribute->data, attributesData.PositionsData);
 				break;
 			case cgltf_attribute_type_texcoord:
 				ValidateVertexAttribute<cgltf_type_vec2, cgltf_component_type_r_32f>(vertexAttribute);
-				attributesData.Texcoords = GetBufferData<Float2>(vertexAttribute->data);
+				attributesData.Texcoords = GetAttributeData(vertexAttribute->data, attributesData.TexcoordsData);
 				break;
 			case cgltf_attribute_type_normal:
 				ValidateVertexAttribute<cgltf_type_vec3, cgltf_component_type_r_32f>(vertexAttribute);
-				attributesData.Normals = GetBufferData<Float3>(vertexAttribute->data);
+				attributesData.Normals = GetAttributeData(vertexAttribute->data, attributesData.NormalsData);
 				break;
 			case cgltf_attribute_type_tangent:
 				if (vertexAttribute->type != cgltf_type_vec4) continue; // Tmp hack: Find a way to fix this
 				ValidateVertexAttribute<cgltf_type_vec4, cgltf_component_type_r_32f>(vertexAttribute);
-				attributesData.Tangents = GetBufferData<Float4>(vertexAttribute->data);
+				attributesData.Tangents = GetAttributeData(vertexAttribute->data, attributesData.TangentsData);
 				break;
+			case cgltf_attribute_type_joints:
+			{
+				if (vertexAttribute->index != 0) continue;
+				cgltf_accessor* accessor = vertexAttribute->data;
+				if (accessor->component_type == cgltf_component_type_r_16u)
+					attributesData.Joints = GetBufferData<glm::u16vec4>(accessor);
+				if (attributesData.Joints) break;
+
+				attributesData.JointsData.resize(accessor->count);
+				for (cgltf_size v = 0; v < accessor->count; v++)
+				{
+					cgltf_uint joints[4] = {};
+					cgltf_accessor_read_uint(accessor, v, joints, 4);
+					attributesData.JointsData[v] = glm::u16vec4(joints[0], joints[1], joints[2], joints[3]);
+				}
+				attributesData.Joints = attributesData.JointsData.data();
+			} break;
+			case cgltf_attribute_type_weights:
+			{
+				if (vertexAttribute->index != 0) continue;
+				cgltf_accessor* accessor = vertexAttribute->data;
+				if (accessor->component_type == cgltf_component_type_r_32f)
+				{
+					attributesData.Weights = GetAttributeData(accessor, attributesData.WeightsData);
+					break;
+				}
+
+				attributesData.WeightsData.resize(accessor->count);
+				for (cgltf_size v = 0; v < accessor->count; v++)
+					cgltf_accessor_read_float(accessor, v, glm::value_ptr(attributesData.WeightsData[v]), 4);
+				attributesData.Weights = attributesData.WeightsData.data();
+			} break;
 			default:
-				NOT_IMPLEMENTED;
+				// Vertex colors and custom attributes are not used
 				break;
 			}
 		}
+
+		// Skinning needs both attributes
+		if (!attributesData.Joints || !attributesData.Weights)
+		{
+			attributesData.Joints = nullptr;
+			attributesData.Weights = nullptr;
+		}
 		return attributesData;
 	}
 
-	Ptr<Scene> Loader::Load(const std::string& scenePath)
+	template<typename T>
+	static void AppendVertices(std::vector<T>& merged, const T* vertices, uint32_t count)
+	{
+		if (vertices) merged.insert(merged.end(), vertices, vertices + count);
+		else merged.resize(merged.size() + count, T{});
+	}
+
+	Ptr<Scene> Loader::Load(const std::string& scenePath, bool optimizeMeshes, bool mergeGeometry)
 	{
 		m_ErrorMessages.clear();
 		m_DirectoryPath = GetPathWitoutFile(scenePath);
+		m_OptimizeMeshes = optimizeMeshes;
+		m_MergeGeometry = mergeGeometry;
+		m_NodeIndices.clear();
+		m_SkinIndices.clear();
+		m_Skins.clear();
+		m_MeshIndices.clear();
+		m_MaterialIndices.clear();
+
+		// Both .gltf and .glb are parsed from the mapped file, binary chunk of .glb is used in place
+		// Mapping has to outlive the GPU buffers creation since vertex data is uploaded directly from it
+		MappedFile sceneFile;
+		if (!sceneFile.Open(scenePath))
+		{
+			Error("Unable to open " + scenePath);
+			return Ptr<Scene>(nullptr);
+		}
 
 		cgltf_options options = {};
+		options.file.read = &MapBufferFile;
+		options.file.release = &UnmapBufferFile;
+
 		cgltf_data* data = NULL;
-		CGTF_CALL(cgltf_parse_file(&options, scenePath.c_str(), &data));
+		CGTF_CALL(cgltf_parse(&options, sceneFile.GetData(), sceneFile.GetSize(), &data));
 		CGTF_CALL(cgltf_load_buffers(&options, data, scenePath.c_str()));
 
 		if (data == nullptr || data->scene == nullptr)
@@ -187,6 +267,7 @@ namespace SceneLoading
 		}
 
 		Scene* scene = LoadScene(data->scene);
+		LoadAnimations(data, scene);
 
 		cgltf_free(data);
 
@@ -196,22 +277,60 @@ namespace SceneLoading
 	Scene* Loader::LoadScene(cgltf_scene* scene)
 	{
 		Scene* loadedScene = new Scene{};
-		for (unsigned i = 0; i < scene->nodes_count; i++)
-			LoadNode(*(scene->nodes + i), loadedScene, Float4x4{1.0f});
+
+		// Nodes are loaded in queue order so each node index matches its queue index
+		std::vector<std::pair<cgltf_node*, uint32_t>> nodeQueue;
+		for (cgltf_size i = 0; i < scene->nodes_count; i++)
+			nodeQueue.push_back({ scene->nodes[i], InvalidNode });
+
+		for (size_t i = 0; i < nodeQueue.size(); i++)
+		{
+			cgltf_node* nodeData = nodeQueue[i].first;
+			m_NodeIndices[nodeData] = (uint32_t)i;
+			LoadNode(nodeData, nodeQueue[i].second, loadedScene);
+
+			for (cgltf_size j = 0; j < nodeData->children_count; j++)
+				nodeQueue.push_back({ nodeData->children[j], (uint32_t)i });
+		}
+
+		// Joints can be anywhere in the hierarchy so skins are loaded once all nodes have indices
+		for (cgltf_skin* skin : m_Skins)
+			LoadSkin(skin, loadedScene);
+
+		if (m_MergeGeometry)
+		{
+			MeshData& geometry = loadedScene->Geometry;
+			const uint32_t vertCount = (uint32_t)m_MergedPositions.size();
+			geometry.Positions = Buffer::Create(BufferType::Vertex, vertCount * sizeof(Float3), sizeof(Float3), BF_None, m_MergedPositions.data());
+			geometry.Texcoords = Buffer::Create(BufferType::Vertex, vertCount * sizeof(Float2), sizeof(Float2), BF_None, m_MergedTexcoords.data());
+			geometry.Normals = Buffer::Create(BufferType::Vertex, vertCount * sizeof(Float3), sizeof(Float3), BF_None, m_MergedNormals.data());
+			geometry.Tangents = Buffer::Create(BufferType::Vertex, vertCount * sizeof(Float4), sizeof(Float4), BF_None, m_MergedTangents.data());
+			geometry.Indices = Buffer::Create(BufferType::Index, (unsigned)m_MergedIndices.size() * sizeof(uint32_t), sizeof(uint32_t), BF_None, m_MergedIndices.data());
+			geometry.IndexType = IndexFormat::Uint32;
+			geometry.PrimitiveCount = (unsigned)m_MergedIndices.size();
+
+			m_MergedPositions = {};
+			m_MergedTexcoords = {};
+			m_MergedNormals = {};
+			m_MergedTangents = {};
+			m_MergedIndices = {};
+		}
+
 		return loadedScene;
 	}
 
-	void Loader::LoadNode(cgltf_node* nodeData, Scene* scene, const Float4x4& parentMatrix)
+	void Loader::LoadNode(cgltf_node* nodeData, uint32_t parentIndex, Scene* scene)
 	{
-		// TODO: Determine order of operations since glm is column major
-		// Probably transforms are not working right now
-
-		const NodeTransform nodeTranform = GetTransform(nodeData);
-		Float4x4 localMatrix = glm::scale(Float4x4{}, nodeTranform.Scale);
-		localMatrix = localMatrix * glm::toMat4(nodeTranform.Rotation);
-		localMatrix = glm::translate(localMatrix, nodeTranform.Position);
+		const uint32_t nodeIndex = (uint32_t)scene->Nodes.size();
 
-		const Float4x4 nodeMatrix = localMatrix * parentMatrix;
+		SceneNode node{};
+		node.Name = nodeData->name ? nodeData->name : "";
+		node.Parent = parentIndex;
+		cgltf_node_transform_local(nodeData, glm::value_ptr(node.LocalTransform));
+		if (nodeData->has_translation) node.Translation = ToFloat3(nodeData->translation);
+		if (nodeData->has_rotation) node.Rotation = ToFloat4(nodeData->rotation);
+		if (nodeData->has_scale) node.Scale = ToFloat3(nodeData->scale);
+		scene->Nodes.push_back(std::move(node));
 
 		if (nodeData->mesh)
 		{
@@ -221,18 +340,131 @@ namespace SceneLoading
 				cgltf_primitive* primitive = mesh->primitives + i;
 
 				SceneObject object{};
-				object.ModelTransform = nodeMatrix;
-				object.Mesh = LoadMesh(primitive);
-				object.Material = LoadMaterial(primitive->material);
-				scene->Objects.push_back(std::move(object));
+				object.NodeIndex = nodeIndex;
+				object.MeshIndex = GetMeshIndex(primitive, scene);
+				object.MaterialIndex = GetMaterialIndex(primitive->material, scene);
+				object.SkinIndex = nodeData->skin ? GetSkinIndex(nodeData->skin) : InvalidSkin;
+				scene->Objects.push_back(object);
 			}
 		}
+	}
+
+	void Loader::LoadAnimations(cgltf_data* data, Scene* scene)
+	{
+		for (cgltf_size i = 0; i < data->animations_count; i++)
+		{
+			const cgltf_animation& animationData = data->animations[i];
+
+			AnimationData animation{};
+			animation.Name = animationData.name ? animationData.name : "Animation " + std::to_string(i);
+
+			for (cgltf_size j = 0; j < animationData.channels_count; j++)
+			{
+				const cgltf_animation_channel& channelData = animationData.channels[j];
+
+				// Channels of nodes outside of the loaded scene can't affect it
+				const auto nodeIt = m_NodeIndices.find(channelData.target_node);
+				if (nodeIt == m_NodeIndices.end()) continue;
+
+				AnimationChannelData channel{};
+				channel.Node = nodeIt->second;
+
+				unsigned componentCount = 3;
+				switch (channelData.target_path)
+				{
+				case cgltf_animation_path_type_translation: channel.Path = AnimationPath::Translation; break;
+				case cgltf_animation_path_type_rotation: channel.Path = AnimationPath::Rotation; componentCount = 4; break;
+				case cgltf_animation_path_type_scale: channel.Path = AnimationPath::Scale; break;
+				default:
+					// Morph target weights are not supported
+					continue;
+				}
+
+				const cgltf_animation_sampler* sampler = channelData.sampler;
+				switch (sampler->interpolation)
+				{
+				case cgltf_interpolation_type_step: channel.Interpolation = AnimationInterpolation::Step; break;
+				case cgltf_interpolation_type_cubic_spline: channel.Interpolation = AnimationInterpolation::CubicSpline; break;
+				default: channel.Interpolation = AnimationInterpolation::Linear; break;
+				}
+
+				const cgltf_size keyCount = sampler->input->count;
+				const cgltf_size valuesPerKey = channel.Interpolation == AnimationInterpolation::CubicSpline ? 3 : 1;
+				if (keyCount == 0 || sampler->output->count != keyCount * valuesPerKey)
+				{
+					Error("Animation " + animation.Name + " has channel with mismatched key and value count");
+					continue;
+				}
+
+				channel.Times.resize(keyCount);
+				cgltf_accessor_unpack_floats(sampler->input, channel.Times.data(), keyCount);
+
+				channel.Values.resize(sampler->output->count, Float4{ 0.0f });
+				for (cgltf_size k = 0; k < sampler->output->count; k++)
+					cgltf_accessor_read_float(sampler->output, k, glm::value_ptr(channel.Values[k]), componentCount);
+
+				animation.Channels.push_back(std::move(channel));
+			}
+
+			if (!animation.Channels.empty())
+				scene->Animations.push_back(std::move(animation));
+		}
+	}
+
+	uint32_t Loader::GetSkinIndex(cgltf_skin* skinData)
+	{
+		const auto it = m_SkinIndices.find(skinData);
+		if (it != m_SkinIndices.end()) return it->second;
+
+		const uint32_t skinIndex = (uint32_t)m_Skins.size();
+		m_Skins.push_back(skinData);
+		m_SkinIndices[skinData] = skinIndex;
+		return skinIndex;
+	}
+
+	void Loader::LoadSkin(cgltf_skin* skinData, Scene* scene)
+	{
+		SkinData skin{};
+		skin.Joints.resize(skinData->joints_count, 0);
+		skin.InverseBindMatrices.resize(skinData->joints_count, Float4x4{ 1.0f });
 
-		for (uint32_t i = 0; i < nodeData->children_count; i++)
+		for (cgltf_size i = 0; i < skinData->joints_count; i++)
 		{
-			LoadNode(*(nodeData->children + i), scene, nodeMatrix);
+			const auto nodeIt = m_NodeIndices.find(skinData->joints[i]);
+			if (nodeIt == m_NodeIndices.end())
+			{
+				Error("Skin joint is not part of the loaded scene");
+				continue;
+			}
+			skin.Joints[i] = nodeIt->second;
+
+			if (skinData->inverse_bind_matrices)
+				cgltf_accessor_read_float(skinData->inverse_bind_matrices, i, glm::value_ptr(skin.InverseBindMatrices[i]), 16);
 		}
 
+		scene->Skins.push_back(std::move(skin));
+	}
+
+	uint32_t Loader::GetMeshIndex(cgltf_primitive* meshData, Scene* scene)
+	{
+		const auto it = m_MeshIndices.find(meshData);
+		if (it != m_MeshIndices.end()) return it->second;
+
+		const uint32_t meshIndex = (uint32_t)scene->Meshes.size();
+		scene->Meshes.push_back(LoadMesh(meshData));
+		m_MeshIndices[meshData] = meshIndex;
+		return meshIndex;
+	}
+
+	uint32_t Loader::GetMaterialIndex(cgltf_material* materialData, Scene* scene)
+	{
+		const auto it = m_MaterialIndices.find(materialData);
+		if (it != m_MaterialIndices.end()) return it->second;
+
+		const uint32_t materialIndex = (uint32_t)scene->Materials.size();
+		scene->Materials.push_back(LoadMaterial(materialData));
+		m_MaterialIndices[materialData] = materialIndex;
+		return materialIndex;
 	}
 
 	MeshData Loader::LoadMesh(cgltf_primitive* meshData)
@@ -245,13 +477,69 @@ namespace SceneLoading
 
 		MeshData mesh;
 
-		const uint32_t vertCount = (uint32_t)meshData->attributes[0].data->count;
+		uint32_t vertCount = (uint32_t)meshData->attributes[0].data->count;
 
-		const VertexAttributesData vertices = LoadAttributes(meshData->attributes, meshData->attributes_count);
+		VertexAttributesData vertices = LoadAttributes(meshData->attributes, meshData->attributes_count);
+
+		// Indices that already have the uploaded format go to the GPU straight from the file
+		cgltf_accessor* indexAccessor = meshData->indices;
+		const void* sourceIndices = nullptr;
+		if (indexAccessor && !m_OptimizeMeshes && !m_MergeGeometry)
+		{
+			if (vertCount <= UINT16_MAX && indexAccessor->component_type == cgltf_component_type_r_16u) sourceIndices = GetBufferData<uint16_t>(indexAccessor);
+			if (vertCount > UINT16_MAX && indexAccessor->component_type == cgltf_component_type_r_32u) sourceIndices = GetBufferData<uint32_t>(indexAccessor);
+		}
 
 		std::vector<uint32_t> indices;
-		if (meshData->indices)
-			LoadIB(meshData->indices, indices);
+		if (indexAccessor && !sourceIndices)
+			LoadIB(indexAccessor, indices);
+		const uint32_t indexCount = indexAccessor ? (uint32_t)indexAccessor->count : 0;
+
+		// Optimized vertex data, attribute pointers are redirected here when meshes are optimized
+		std::vector<Float3> optimizedPositions;
+		std::vector<Float2> optimizedTexcoords;
+		std::vector<Float3> optimizedNormals;
+		std::vector<Float4> optimizedTangents;
+		std::vector<glm::u16vec4> optimizedJoints;
+		std::vector<Float4> optimizedWeights;
+
+		if (m_OptimizeMeshes && !indices.empty())
+		{
+			const float acmrBefore = MeshOptimization::ComputeACMR(indices, vertCount);
+
+			MeshOptimization::OptimizeVertexCache(indices, vertCount);
+
+			uint32_t optimizedVertCount = 0;
+			const std::vector<uint32_t> remap = MeshOptimization::OptimizeVertexFetch(indices, vertCount, optimizedVertCount);
+			optimizedPositions = MeshOptimization::RemapVertices(vertices.Positions, remap, optimizedVertCount);
+			optimizedTexcoords = MeshOptimization::RemapVertices(vertices.Texcoords, remap, optimizedVertCount);
+			optimizedNormals = MeshOptimization::RemapVertices(vertices.Normals, remap, optimizedVertCount);
+			optimizedTangents = MeshOptimization::RemapVertices(vertices.Tangents, remap, optimizedVertCount);
+			optimizedJoints = MeshOptimization::RemapVertices(vertices.Joints, remap, optimizedVertCount);
+			optimizedWeights = MeshOptimization::RemapVertices(vertices.Weights, remap, optimizedVertCount);
+
+			vertCount = optimizedVertCount;
+			vertices.NumVertices = optimizedVertCount;
+			vertices.Positions = vertices.Positions ? optimizedPositions.data() : nullptr;
+			vertices.Texcoords = vertices.Texcoords ? optimizedTexcoords.data() : nullptr;
+			vertices.Normals = vertices.Normals ? optimizedNormals.data() : nullptr;
+			vertices.Tangents = vertices.Tangents ? optimizedTangents.data() : nullptr;
+			vertices.Joints = vertices.Joints ? optimizedJoints.data() : nullptr;
+			vertices.Weights = vertices.Weights ? optimizedWeights.data() : nullptr;
+
+			const float acmrAfter = MeshOptimization::ComputeACMR(indices, vertCount);
+			App::Get()->GetConsole().Log("[SceneLoading] Optimized mesh ACMR: " + std::to_string(acmrBefore) + " -> " + std::to_string(acmrAfter));
+		}
+
+		// Keep 16 bit indices whenever all vertices are addressable with them
+		std::vector<uint16_t> indices16;
+		const bool use16BitIndices = vertCount <= UINT16_MAX;
+		if (use16BitIndices && !sourceIndices)
+		{
+			indices16.resize(indices.size());
+			for (size_t i = 0; i < indices.size(); i++)
+				indices16[i] = (uint16_t)indices[i];
+		}
 
 		const auto createBuffer = [this](const void* data, uint32_t stride, uint32_t numElements, BufferType bufferType = BufferType::Vertex)
 		{
@@ -268,8 +556,42 @@ namespace SceneLoading
 		mesh.Texcoords = createBuffer(vertices.Texcoords, sizeof(Float2), vertCount);
 		mesh.Normals = createBuffer(vertices.Normals, sizeof(Float3), vertCount);
 		mesh.Tangents = createBuffer(vertices.Tangents, sizeof(Float4), vertCount);
-		mesh.Indices = createBuffer(indices.empty() ? nullptr : indices.data(), sizeof(uint32_t), (uint32_t)indices.size(), BufferType::Index);
-		mesh.PrimitiveCount = mesh.Indices ? (uint32_t)indices.size() : vertices.NumVertices;
+		if (vertices.Joints)
+		{
+			mesh.Joints = createBuffer(vertices.Joints, sizeof(glm::u16vec4), vertCount);
+			mesh.Weights = createBuffer(vertices.Weights, sizeof(Float4), vertCount);
+		}
+		if (use16BitIndices)
+		{
+			mesh.IndexType = IndexFormat::Uint16;
+			mesh.Indices = createBuffer(sourceIndices ? sourceIndices : indices16.data(), sizeof(uint16_t), indexCount, BufferType::Index);
+		}
+		else
+		{
+			mesh.IndexType = IndexFormat::Uint32;
+			mesh.Indices = createBuffer(sourceIndices ? sourceIndices : indices.data(), sizeof(uint32_t), indexCount, BufferType::Index);
+		}
+		mesh.PrimitiveCount = mesh.Indices ? indexCount : vertices.NumVertices;
+		mesh.Bounds = Bounds::ComputeBoundingSphere(vertices.Positions, vertCount);
+
+		if (m_MergeGeometry)
+		{
+			mesh.FirstIndex = (uint32_t)m_MergedIndices.size();
+			mesh.BaseVertex = (uint32_t)m_MergedPositions.size();
+
+			AppendVertices(m_MergedPositions, vertices.Positions, vertCount);
+			AppendVertices(m_MergedTexcoords, vertices.Texcoords, vertCount);
+			AppendVertices(m_MergedNormals, vertices.Normals, vertCount);
+			AppendVertices(m_MergedTangents, vertices.Tangents, vertCount);
+			if (indices.empty())
+			{
+				for (uint32_t i = 0; i < vertCount; i++) m_MergedIndices.push_back(i);
+			}
+			else
+			{
+				m_MergedIndices.insert(m_MergedIndices.end(), indices.begin(), indices.end());
+			}
+		}
 
 		return mesh;
 	}
@@ -315,11 +637,52 @@ namespace SceneLoading
 	{
 		if (!textureData || !textureData->image) return LoadTexture("", defaultColor);
 
-		const std::string textureURI = textureData->image->uri;
+		// Images packed in .glb binary chunk
+		const cgltf_image* image = textureData->image;
+		if (image->buffer_view)
+			return LoadEmbeddedTexture(cgltf_buffer_view_data(image->buffer_view), image->buffer_view->size, defaultColor);
+
+		if (!image->uri) return LoadTexture("", defaultColor);
+
+		// Images in base64 data URIs
+		const std::string textureURI = image->uri;
+		const size_t base64Start = textureURI.find(";base64,");
+		if (textureURI.compare(0, 5, "data:") == 0 && base64Start != std::string::npos)
+		{
+			const char* base64 = image->uri + base64Start + 8;
+			const size_t base64Size = textureURI.size() - base64Start - 8;
+			size_t padding = 0;
+			while (padding < base64Size && base64[base64Size - padding - 1] == '=') padding++;
+
+			const size_t decodedSize = base64Size / 4 * 3 - padding;
+			cgltf_options options = {};
+			void* decodedData = nullptr;
+			if (cgltf_load_buffer_base64(&options, decodedSize, base64, &decodedData) != cgltf_result_success) return LoadTexture("", defaultColor);
+
+			Ptr<Texture> texture = LoadEmbeddedTexture(decodedData, decodedSize, defaultColor);
+			free(decodedData);
+			return texture;
+		}
+
 		const std::string texturePath = m_DirectoryPath + "/" + textureURI;
 		return LoadTexture(texturePath);
 	}
 
+	Ptr<Texture> Loader::LoadEmbeddedTexture(const void* encodedData, size_t encodedSize, Float4 defaultColor)
+	{
+		int width, height, bpp;
+		stbi_set_flip_vertically_on_load(true);
+		stbi_uc* data = encodedData ? stbi_load_from_memory((const stbi_uc*)encodedData, (int)encodedSize, &width, &height, &bpp, 4) : nullptr;
+
+		if (!data) return LoadTexture("", defaultColor);
+
+		Ptr<Texture> loadedTexture = Texture::Create(width, height, TF_GenerateMips, data);
+
+		stbi_image_free(data);
+
+		return loadedTexture;
+	}
+
 	Ptr<Texture> Loader::LoadTexture(const std::string& texturePath, Float4 defaultColor)
 	{
 		const auto toU8 = [](float x) { return (uint8_t)(255.0f * x); };
@@ -332,19 +695,63 @@ namespace SceneLoading
 
 		if (texturePath.empty()) return Texture::Create(1, 1, TF_None, &defaultColorUnorm);
 
+		if (HasExtension(texturePath, ".dds") || HasExtension(texturePath, ".ktx2"))
+		{
+			Ptr<Texture> compressedTexture = LoadCompressedTexture(texturePath);
+			if (!compressedTexture) return Texture::Create(1, 1, TF_None, &defaultColorUnorm);
+			return compressedTexture;
+		}
+
 		int width, height, bpp;
 		stbi_set_flip_vertically_on_load(true);
 		stbi_uc* data = stbi_load(texturePath.c_str(), &width, &height, &bpp, 4);
 
 		if(!data) return Texture::Create(1, 1, TF_None, &defaultColorUnorm);
 
-		Ptr<Texture> loadedTexture = Texture::Create(width, height, TF_None, data);
+		Ptr<Texture> loadedTexture = Texture::Create(width, height, TF_GenerateMips, data);
 
 		stbi_image_free(data);
 
 		return std::move(loadedTexture);
 	}
 
+	Ptr<Texture> Loader::LoadCompressedTexture(const std::string& texturePath)
+	{
+		TextureFile::CompressedTextureData textureData;
+		std::string errorMessage;
+		const bool loaded = HasExtension(texturePath, ".dds") ?
+			TextureFile::LoadDDS(texturePath, textureData, errorMessage) :
+			TextureFile::LoadKTX2(texturePath, textureData, errorMessage);
+
+		if (!loaded)
+		{
+			Error(errorMessage);
+			return nullptr;
+		}
+		return Texture::CreateCompressed(textureData.Format, textureData.Mips);
+	}
+
+	Ptr<Texture> Loader::LoadCookedTexture(const std::string& texturePath, TextureFormat format)
+	{
+		if (!IsCompressedFormat(format)) return LoadTexture(texturePath);
+
+		const std::string cookedPath = TextureCompression::GetCookedPath(texturePath, format);
+		if (!TextureCompression::IsCookUpToDate(texturePath, cookedPath))
+		{
+			std::string errorMessage;
+			if (!TextureCompression::CookTexture(texturePath, cookedPath, format, errorMessage))
+			{
+				Error(errorMessage);
+				return LoadTexture(texturePath);
+			}
+			App::Get()->GetConsole().Log("[SceneLoading] Cooked " + cookedPath);
+		}
+
+		Ptr<Texture> texture = LoadCompressedTexture(cookedPath);
+		if (!texture) return LoadTexture(texturePath);
+		return texture;
+	}
+
 }
 
 
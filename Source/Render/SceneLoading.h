@@ -1,16 +1,21 @@
 #pragma once
 
 #include <vector>
+#include <unordered_map>
 
 #include "../App/App.h"
 #include "../Common.h"
+#include "Animation.h"
+#include "Bounds.h"
 #include "Buffer.h"
 #include "Texture.h"
 
+struct cgltf_data;
 struct cgltf_scene;
 struct cgltf_node;
 struct cgltf_primitive;
 struct cgltf_material;
+struct cgltf_skin;
 struct cgltf_texture;
 
 namespace SceneLoading
@@ -18,13 +23,25 @@ namespace SceneLoading
 	struct MeshData
 	{
 		unsigned PrimitiveCount = 0;
+		IndexFormat IndexType = IndexFormat::Uint32;
 
 		Ptr<Buffer> Positions = nullptr;
 		Ptr<Buffer> Texcoords = nullptr;
 		Ptr<Buffer> Normals = nullptr;
 		Ptr<Buffer> Tangents = nullptr;
 
+		// Only for skinned meshes, four 16 bit joint indices and four float weights per vertex
+		Ptr<Buffer> Joints = nullptr;
+		Ptr<Buffer> Weights = nullptr;
+
 		Ptr<Buffer> Indices = nullptr;
+
+		// Local space bounds
+		BoundingSphere Bounds{};
+
+		// Offsets into Scene::Geometry when geometry is merged
+		uint32_t FirstIndex = 0;
+		uint32_t BaseVertex = 0;
 	};
 
 	enum class MaterialType
@@ -47,25 +64,80 @@ namespace SceneLoading
 		Ptr<Texture> MetallicRoughness = nullptr;
 	};
 
-	struct SceneObject
+	static constexpr uint32_t InvalidNode = ~0u;
+	static constexpr uint32_t InvalidSkin = ~0u;
+
+	struct SceneNode
 	{
-		Float4x4 ModelTransform;
+		std::string Name;
+		Float4x4 LocalTransform{ 1.0f };
+		uint32_t Parent = InvalidNode;
+
+		// Rest pose used by animation channels that leave some of the properties untouched
+		Float3 Translation{ 0.0f, 0.0f, 0.0f };
+		Float4 Rotation{ 0.0f, 0.0f, 0.0f, 1.0f }; // xyzw like glTF
+		Float3 Scale{ 1.0f, 1.0f, 1.0f };
+	};
 
-		MeshData Mesh;
-		MaterialData Material;
+	struct AnimationChannelData
+	{
+		uint32_t Node = InvalidNode;
+		AnimationPath Path = AnimationPath::Translation;
+		AnimationInterpolation Interpolation = AnimationInterpolation::Linear;
+
+		std::vector<float> Times;
+
+		// One value per key, cubic spline keys have three values (in tangent, value, out tangent)
+		std::vector<Float4> Values;
+	};
+
+	struct AnimationData
+	{
+		std::string Name;
+		std::vector<AnimationChannelData> Channels;
+	};
+
+	struct SkinData
+	{
+		std::vector<uint32_t> Joints;
+		std::vector<Float4x4> InverseBindMatrices;
+	};
+
+	struct SceneObject
+	{
+		uint32_t NodeIndex = 0;
+		uint32_t MeshIndex = 0;
+		uint32_t MaterialIndex = 0;
+		uint32_t SkinIndex = InvalidSkin;
 	};
 
 	struct Scene
 	{
+		// Breadth first, parents come before children and children of one node are next to each other
+		std::vector<SceneNode> Nodes;
+
 		std::vector<SceneObject> Objects;
+
+		// Shared between objects, glTF primitives and materials referenced by many nodes are loaded once
+		std::vector<MeshData> Meshes;
+		std::vector<MaterialData> Materials;
+
+		std::vector<SkinData> Skins;
+		std::vector<AnimationData> Animations;
+
+		// Vertices and 32 bit indices of all objects in shared buffers, only filled when geometry is merged
+		MeshData Geometry;
 	};
 
 	class Loader
 	{
 	public:
-		Ptr<Scene> Load(const std::string& scenePath);
+		Ptr<Scene> Load(const std::string& scenePath, bool optimizeMeshes = false, bool mergeGeometry = false);
 		Ptr<Texture> LoadTexture(const std::string& texturePath, Float4 defaultColor = Float4{ 0.0f });
 
+		// Cooks the texture into block compressed .dds if it is missing or stale and loads the cooked file
+		Ptr<Texture> LoadCookedTexture(const std::string& texturePath, TextureFormat format);
+
 		bool HasErrors() const { return !m_ErrorMessages.empty(); }
 		void PrintErrors()
 		{
@@ -77,12 +149,19 @@ namespace SceneLoading
 
 	private:
 		Scene* LoadScene(cgltf_scene* scene);
-		void LoadNode(cgltf_node* nodeData, Scene* scene, const Float4x4& transform);
+		void LoadNode(cgltf_node* nodeData, uint32_t parentIndex, Scene* scene);
+		void LoadAnimations(cgltf_data* data, Scene* scene);
+		uint32_t GetSkinIndex(cgltf_skin* skinData);
+		void LoadSkin(cgltf_skin* skinData, Scene* scene);
+		uint32_t GetMeshIndex(cgltf_primitive* meshData, Scene* scene);
+		uint32_t GetMaterialIndex(cgltf_material* materialData, Scene* scene);
 
 		MeshData LoadMesh(cgltf_primitive* meshData);
 		MaterialData LoadMaterial(cgltf_material* materialData);
 
 		Ptr<Texture> LoadTexture(cgltf_texture* textureData, Float4 defaultColor = Float4{0.0f});
+		Ptr<Texture> LoadEmbeddedTexture(const void* encodedData, size_t encodedSize, Float4 defaultColor);
+		Ptr<Texture> LoadCompressedTexture(const std::string& texturePath);
 
 	private:
 		void Error(const std::string& msg)
@@ -92,7 +171,22 @@ namespace SceneLoading
 
 	private:
 		std::string m_DirectoryPath = "";
+		bool m_OptimizeMeshes = false;
+		bool m_MergeGeometry = false;
 		std::vector<std::string> m_ErrorMessages;
+
+		std::unordered_map<const cgltf_node*, uint32_t> m_NodeIndices;
+		std::unordered_map<const cgltf_skin*, uint32_t> m_SkinIndices;
+		std::vector<cgltf_skin*> m_Skins;
+		std::unordered_map<const cgltf_primitive*, uint32_t> m_MeshIndices;
+		std::unordered_map<const cgltf_material*, uint32_t> m_MaterialIndices;
+
+		// Merged geometry gathered while loading meshes
+		std::vector<Float3> m_MergedPositions;
+		std::vector<Float2> m_MergedTexcoords;
+		std::vector<Float3> m_MergedNormals;
+		std::vector<Float4> m_MergedTangents;
+		std::vector<uint32_t> m_MergedIndices;
 	};
 }
 
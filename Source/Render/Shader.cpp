@@ -4,26 +4,15 @@
 #include <fstream>
 #include <string>
 #include <set>
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
 
 #include "../App/App.h"
+#include "../Util/Hash.h"
+#include "ShaderPreprocessor.h"
 
-static bool ReadFile(const std::string& path, std::vector<std::string>& content)
-{
-	std::ifstream fileStream(path, std::ios::in);
-
-	if (!fileStream.is_open()) {
-		return false;
-	}
-
-	std::string line = "";
-	while (!fileStream.eof()) {
-		std::getline(fileStream, line);
-		content.push_back(line);
-	}
-
-	fileStream.close();
-	return true;
-}
+#include <windows.h>
 
 static GLenum MacroToShaderType(const std::string macro)
 {
@@ -56,7 +45,7 @@ static void LogError(const std::string& err)
 	App::Get()->GetConsole().Log("[Shader compiler error] " + err);
 }
 
-static unsigned CompileShader(unsigned type, const char* source)
+static unsigned CompileShader(unsigned type, const char* source, const ShaderPreprocessor& preprocessor)
 {
 	GL_CALL(unsigned id = glCreateShader(type));
 	GL_CALL(glShaderSource(id, 1, &source, nullptr));
@@ -70,7 +59,7 @@ static unsigned CompileShader(unsigned type, const char* source)
 		GL_CALL(glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length));
 		char* message = (char*)alloca(length * sizeof(char));
 		GL_CALL(glGetShaderInfoLog(id, length, &length, message));
-		LogError(GetTag(type) + " " + message);
+		LogError(GetTag(type) + " " + preprocessor.MapErrorLocations(message));
 		GL_CALL(glDeleteShader(id));
 		return 0;
 	}
@@ -78,87 +67,199 @@ static unsigned CompileShader(unsigned type, const char* source)
 	return id;
 }
 
-static void ReplaceAll(std::string& str, const std::string& from, const std::string& to)
+namespace ProgramCache
 {
-	if (from.empty())
-		return;
-	size_t start_pos = 0;
-	while ((start_pos = str.find(from, start_pos)) != std::string::npos)
+	static constexpr uint32_t Magic = 0x48435052; // RPCH
+	static constexpr uint32_t Version = 2;
+
+	struct Header
+	{
+		uint32_t Magic = ProgramCache::Magic;
+		uint32_t Version = ProgramCache::Version;
+		uint64_t SourceHash = 0;
+		uint64_t DriverHash = 0;
+		uint32_t SourceSize = 0;
+		uint32_t BinaryFormat = 0;
+		uint32_t BinarySize = 0;
+	};
+
+	// Next to the executable, working directory depends on how the app was started
+	static const std::string& GetCacheDirectory()
 	{
-		str.replace(start_pos, from.length(), to);
-		start_pos += to.length();
+		static const std::string cacheDirectory = [] {
+			CHAR buffer[MAX_PATH] = { 0 };
+			GetModuleFileNameA(NULL, buffer, MAX_PATH);
+			return (std::filesystem::path{ buffer }.parent_path() / "ShaderCache").string();
+		}();
+		return cacheDirectory;
 	}
-}
 
-static void DecomposePath(const std::string& path, std::string& pathRoot, std::string& fileName)
-{
-	pathRoot = path.substr(0, 1 + path.find_last_of("\\/"));
-	fileName = path.substr(path.find_last_of("/\\") + 1);
-}
+	static bool IsSupported()
+	{
+		GLint numFormats = 0;
+		GL_CALL(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats));
+		return numFormats > 0;
+	}
 
-static bool ReadShaderFile(std::string& outputCode, const std::string& includeRoot, const std::string includePath)
-{
-	std::vector<std::string> shaderContent;
-	if (!ReadFile(includeRoot + includePath, shaderContent))
+	static uint64_t GetDriverHash()
 	{
-		LogError("Failed to load shader file: " + includeRoot + includePath);
-		return false;
+		const auto getString = [](GLenum name) {
+			const GLubyte* value = glGetString(name);
+			return value ? std::string{ (const char*)value } : std::string{};
+		};
+
+		return Hash::Fnv1a64(getString(GL_VENDOR) + "\n" + getString(GL_RENDERER) + "\n" + getString(GL_VERSION));
 	}
 
-	for (const std::string& line : shaderContent)
+	static Header CreateHeader(const std::string& source)
 	{
-		// Include directive
-		if (line.find("#include") != std::string::npos)
+		Header header;
+		header.SourceHash = Hash::Fnv1a64(source);
+		header.SourceSize = (uint32_t)source.size();
+		header.DriverHash = GetDriverHash();
+		return header;
+	}
+
+	// One file per shader file, the program of an edited shader overwrites the previous one instead of adding a file
+	// Embedded shaders have no path and are keyed by their source
+	static std::string GetCachePath(const std::string& shaderPath, const Header& header)
+	{
+		uint64_t key = header.SourceHash;
+		if (!shaderPath.empty())
 		{
-			// TODO: Rework finding file name in path
-			std::string fileName = line;
-			ReplaceAll(fileName, "#include", "");
-			ReplaceAll(fileName, " ", "");
-			ReplaceAll(fileName, "\"", "");
-
-			if (!ReadShaderFile(outputCode, includeRoot, fileName))
-				return false;
+			std::error_code error;
+			const std::filesystem::path canonicalPath = std::filesystem::weakly_canonical(shaderPath, error);
+			key = Hash::Fnv1a64(error ? shaderPath : canonicalPath.generic_string());
 		}
-		else if (line.find("#version") != std::string::npos) // TODO: Read version from here
+
+		std::stringstream ss;
+		ss << GetCacheDirectory() << "/" << std::hex << std::setfill('0') << std::setw(16) << key << ".bin";
+		return ss.str();
+	}
+
+	// Returns linked program or 0 if cache is missing, stale or rejected by the driver
+	static unsigned Load(const std::string& shaderPath, const Header& expectedHeader)
+	{
+		std::ifstream file{ GetCachePath(shaderPath, expectedHeader), std::ios::binary };
+		if (!file.is_open()) return 0;
+
+		Header header;
+		file.read((char*)&header, sizeof(Header));
+		if (!file ||
+			header.Magic != expectedHeader.Magic ||
+			header.Version != expectedHeader.Version ||
+			header.SourceHash != expectedHeader.SourceHash ||
+			header.SourceSize != expectedHeader.SourceSize ||
+			header.DriverHash != expectedHeader.DriverHash)
 		{
-			continue;
+			return 0;
 		}
-		else
+
+		std::vector<char> binary(header.BinarySize);
+		file.read(binary.data(), binary.size());
+		if (!file) return 0;
+
+		GL_CALL(unsigned program = glCreateProgram());
+		// Not wrapped in GL_CALL, driver is allowed to reject the binary format
+		glProgramBinary(program, header.BinaryFormat, binary.data(), (GLsizei)binary.size());
+
+		GLint validLinking;
+		GL_CALL(glGetProgramiv(program, GL_LINK_STATUS, &validLinking));
+		if (!validLinking)
 		{
-			outputCode.append(line + "\n");
+			GL_CALL(glDeleteProgram(program));
+			return 0;
 		}
+		return program;
+	}
+
+	static void Store(const std::string& shaderPath, Header header, unsigned program)
+	{
+		GLint binarySize = 0;
+		GL_CALL(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binarySize));
+		if (binarySize <= 0) return;
+
+		std::vector<char> binary(binarySize);
+		GLenum binaryFormat = 0;
+		GL_CALL(glGetProgramBinary(program, binarySize, &binarySize, &binaryFormat, binary.data()));
+
+		header.BinaryFormat = binaryFormat;
+		header.BinarySize = (uint32_t)binarySize;
+
+		std::error_code error;
+		std::filesystem::create_directories(GetCacheDirectory(), error);
+
+		std::ofstream file{ GetCachePath(shaderPath, header), std::ios::binary };
+		if (!file.is_open()) return;
+
+		file.write((const char*)&header, sizeof(Header));
+		file.write(binary.data(), header.BinarySize);
 	}
-	return true;
 }
 
-Ptr<Shader> Shader::Compile(const std::string& path)
+static std::string GetStageDefine(GLenum type)
 {
-	std::string includeRoot, shaderFile;
-	DecomposePath(path, includeRoot, shaderFile);
-
-	std::string shaderCode;
-	if (!ReadShaderFile(shaderCode, includeRoot, shaderFile))
+	switch (type)
 	{
-		LogError("Failed to compile shader!");
-		return nullptr;
+	case GL_VERTEX_SHADER: return "VERTEX";
+	case GL_FRAGMENT_SHADER: return "FRAGMENT";
+	case GL_COMPUTE_SHADER: return "COMPUTE";
+	default: NOT_IMPLEMENTED;
 	}
+	return "";
+}
 
-	const std::string vertexCode = "#version 430\n#define VERTEX\n" + shaderCode;
-	unsigned vsModule = CompileShader(GL_VERTEX_SHADER, vertexCode.c_str());
+// Takes the code of every stage, its stage macro is defined on top
+// Path is only used to key the program cache, empty for embedded shaders
+static Ptr<Shader> CreateProgram(const std::string& path, std::vector<std::pair<GLenum, std::string>> stages, const ShaderPreprocessor& preprocessor)
+{
+	for (auto& stage : stages) stage.second = "#version 430\n#define " + GetStageDefine(stage.first) + "\n" + stage.second;
+	const bool isCompute = stages[0].first == GL_COMPUTE_SHADER;
 
-	const std::string fragmentCode = "#version 430\n#define FRAGMENT\n" + shaderCode;
-	unsigned fsModule = CompileShader(GL_FRAGMENT_SHADER, fragmentCode.c_str());
+	// Program binaries are only valid for the same source on the same driver
+	std::string stagesCode;
+	for (const auto& stage : stages) stagesCode += stage.second;
 
-	if (!vsModule || !fsModule)
+	const bool useProgramCache = ProgramCache::IsSupported();
+	const ProgramCache::Header cacheHeader = ProgramCache::CreateHeader(stagesCode);
+	if (useProgramCache)
 	{
-		LogError("Failed to compile shader!");
-		return nullptr;
+		if (const unsigned program = ProgramCache::Load(path, cacheHeader))
+		{
+			Shader* shader = new Shader{};
+			shader->Handle = program;
+			shader->IsCompute = isCompute;
+			return Ptr<Shader>{shader};
+		}
+	}
+
+	std::vector<unsigned> modules;
+	for (const auto& stage : stages)
+	{
+		const unsigned module = CompileShader(stage.first, stage.second.c_str(), preprocessor);
+		if (!module)
+		{
+			for (const unsigned compiledModule : modules)
+			{
+				GL_CALL(glDeleteShader(compiledModule));
+			}
+			LogError("Failed to compile shader!");
+			return nullptr;
+		}
+		modules.push_back(module);
 	}
 
 	Shader* shader = new Shader{};
+	shader->IsCompute = isCompute;
 	GL_CALL(shader->Handle = glCreateProgram());
-	GL_CALL(glAttachShader(shader->Handle, vsModule));
-	GL_CALL(glAttachShader(shader->Handle, fsModule));
+	for (const unsigned module : modules)
+	{
+		GL_CALL(glAttachShader(shader->Handle, module));
+	}
+	if (useProgramCache)
+	{
+		GL_CALL(glProgramParameteri(shader->Handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+	}
 	GL_CALL(glLinkProgram(shader->Handle));
 
 	GLint validLinking;
@@ -179,17 +280,73 @@ Ptr<Shader> Shader::Compile(const std::string& path)
 		return nullptr;
 	}
 
+	for (const unsigned module : modules)
+	{
 #ifdef _DEBUG
-	GL_CALL(glDetachShader(shader->Handle, vsModule));
-	GL_CALL(glDetachShader(shader->Handle, fsModule));
+		GL_CALL(glDetachShader(shader->Handle, module));
 #else
-	GL_CALL(glDeleteShader(vsModule));
-	GL_CALL(glDeleteShader(fsModule));
+		GL_CALL(glDeleteShader(module));
 #endif
+	}
+
+	if (useProgramCache) ProgramCache::Store(path, cacheHeader, shader->Handle);
 
 	return Ptr<Shader>{shader};
 }
 
+Ptr<Shader> Shader::Compile(const std::string& path)
+{
+	ShaderPreprocessor preprocessor{};
+	return Compile(path, preprocessor);
+}
+
+Ptr<Shader> Shader::Compile(const std::string& path, ShaderPreprocessor& preprocessor)
+{
+	// Stage is known from the "#start" marker of the vertex output, compute shaders are processed again
+	std::vector<std::pair<GLenum, std::string>> stages{ { GL_VERTEX_SHADER, "" }, { GL_FRAGMENT_SHADER, "" } };
+	std::vector<std::string> outputs;
+	std::vector<std::string> dependencies;
+	bool processed = preprocessor.Process(path, { "VERTEX", "FRAGMENT" }, outputs, dependencies);
+	if (processed && MacroToShaderType(outputs[0]) == GL_COMPUTE_SHADER)
+	{
+		stages = { { GL_COMPUTE_SHADER, "" } };
+		processed = preprocessor.Process(path, { "COMPUTE" }, outputs, dependencies);
+	}
+
+	if (!processed)
+	{
+		LogError(preprocessor.GetErrorMessage());
+		LogError("Failed to compile shader!");
+		return nullptr;
+	}
+
+	for (size_t i = 0; i < stages.size(); i++) stages[i].second = std::move(outputs[i]);
+	Ptr<Shader> shader = CreateProgram(path, std::move(stages), preprocessor);
+	if (!shader) return nullptr;
+
+	shader->Path = path;
+	shader->Dependencies = std::move(dependencies);
+	return shader;
+}
+
+Ptr<Shader> Shader::CompileSource(const std::string& source)
+{
+	const ShaderPreprocessor preprocessor{};
+	if (MacroToShaderType(source) == GL_COMPUTE_SHADER) return CreateProgram("", { { GL_COMPUTE_SHADER, source } }, preprocessor);
+	return CreateProgram("", { { GL_VERTEX_SHADER, source }, { GL_FRAGMENT_SHADER, source } }, preprocessor);
+}
+
+bool Shader::Reload()
+{
+	Ptr<Shader> reloadedShader = Compile(Path);
+	if (!reloadedShader) return false;
+
+	std::swap(Handle, reloadedShader->Handle);
+	IsCompute = reloadedShader->IsCompute;
+	Dependencies = std::move(reloadedShader->Dependencies);
+	return true;
+}
+
 Shader::~Shader()
 {
 	GL_CALL(glDeleteProgram(Handle));
@@ -1,12 +1,33 @@
 #pragma once
 
+#include <vector>
+
 #include "../Common.h"
 
+class ShaderPreprocessor;
+
 struct Shader
 {
 	static Ptr<Shader> Compile(const std::string& path);
 
+	// Shares loaded include files with other shaders compiled with the same preprocessor
+	static Ptr<Shader> Compile(const std::string& path, ShaderPreprocessor& preprocessor);
+
+	// For shaders embedded in code, source isn't preprocessed and the shader can't be reloaded
+	static Ptr<Shader> CompileSource(const std::string& source);
+
+	// Recompiles the shader in place, previous program is kept if compilation fails
+	bool Reload();
+
 	~Shader();
 
 	unsigned Handle;
+
+	// Shaders marked with "#start COMPUTE" are compiled as a single compute stage instead of VS+FS
+	bool IsCompute = false;
+
+	std::string Path;
+
+	// Shader file and all files it includes
+	std::vector<std::string> Dependencies;
 };
\ No newline at end of file
@@ -0,0 +1,423 @@
+#include "ShaderPreprocessor.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+	static constexpr unsigned MaxIncludeDepth = 32;
+
+	bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	std::string_view Trim(std::string_view str)
+	{
+		while (!str.empty() && IsSpace(str.front())) str.remove_prefix(1);
+		while (!str.empty() && IsSpace(str.back())) str.remove_suffix(1);
+		return str;
+	}
+
+	// Consumes the token if the string starts with it, rest of the string is returned trimmed
+	bool ConsumeToken(std::string_view& str, std::string_view token)
+	{
+		if (str.substr(0, token.size()) != token) return false;
+		if (str.size() > token.size() && !IsSpace(str[token.size()]) && str[token.size()] != '"' && str[token.size()] != '<') return false;
+		str = Trim(str.substr(token.size()));
+		return true;
+	}
+
+	std::string_view ReadIdentifier(std::string_view str)
+	{
+		size_t length = 0;
+		while (length < str.size() && (std::isalnum((unsigned char)str[length]) || str[length] == '_')) length++;
+		return str.substr(0, length);
+	}
+
+	// Returns directive without '#' or empty view if line isn't a directive
+	std::string_view GetDirective(std::string_view line)
+	{
+		line = Trim(line);
+		if (line.empty() || line.front() != '#') return {};
+		return Trim(line.substr(1));
+	}
+
+	void AppendLineDirective(std::string& output, unsigned line, unsigned fileIndex)
+	{
+		output.append("#line ");
+		output.append(std::to_string(line));
+		output.push_back(' ');
+		output.append(std::to_string(fileIndex));
+		output.push_back('\n');
+	}
+
+	std::string NormalizePath(const std::string& path)
+	{
+		return std::filesystem::path{ path }.lexically_normal().string();
+	}
+}
+
+bool ShaderPreprocessor::Process(const std::string& path, const std::vector<std::string>& stageDefines, std::vector<std::string>& outputs, std::vector<std::string>& dependencies)
+{
+	m_ErrorMessage.clear();
+	m_FileNames.clear();
+	m_IncludeRoot = path.substr(0, 1 + path.find_last_of("\\/"));
+
+	outputs.resize(stageDefines.size());
+	for (size_t i = 0; i < stageDefines.size(); i++)
+	{
+		m_Defines.clear();
+		m_UncertainDefines.clear();
+		m_OnceFiles.clear();
+		m_Conditions.clear();
+
+		m_Defines[stageDefines[i]] = "";
+		outputs[i].clear();
+		if (!ProcessFile(NormalizePath(path), outputs[i], dependencies, 0)) return false;
+	}
+	return true;
+}
+
+bool ShaderPreprocessor::ProcessFile(const std::string& filePath, std::string& output, std::vector<std::string>& dependencies, unsigned depth)
+{
+	if (depth > MaxIncludeDepth)
+	{
+		m_ErrorMessage = "Include depth exceeded while including " + filePath + ", check for circular includes";
+		return false;
+	}
+
+	const SourceFile& file = LoadFile(filePath);
+
+	if (std::find(dependencies.begin(), dependencies.end(), filePath) == dependencies.end())
+		dependencies.push_back(filePath);
+
+	if (!file.Loaded)
+	{
+		m_ErrorMessage = "Failed to load shader file: " + filePath;
+		return false;
+	}
+
+	if (m_OnceFiles.count(filePath)) return true;
+	if (!file.IncludeGuard.empty() && IsDefined(file.IncludeGuard) == ConditionState::Active) return true;
+
+	// Included under an #if expression it may be expanded again, the compiler skips the copies
+	const unsigned fileIndex = GetFileIndex(filePath);
+	const std::string onceGuard = "RN_PRAGMA_ONCE_" + std::to_string(fileIndex);
+	if (file.PragmaOnce)
+	{
+		if (GetConditionState() == ConditionState::Active) m_OnceFiles.insert(filePath);
+		output.append("#ifndef " + onceGuard + "\n#define " + onceGuard + "\n");
+	}
+
+	AppendLineDirective(output, 1, fileIndex);
+
+	const std::string_view source = file.Content;
+	unsigned lineNumber = 0;
+	size_t lineStart = 0;
+	while (lineStart < source.size())
+	{
+		size_t lineEnd = source.find('\n', lineStart);
+		if (lineEnd == std::string_view::npos) lineEnd = source.size();
+
+		const std::string_view line = source.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+		lineNumber++;
+
+		std::string_view directive = GetDirective(line);
+		if (!directive.empty() && ProcessCondition(directive))
+		{
+			// Compiler sees the same blocks, inactive ones are just empty
+			output.append(line);
+			output.push_back('\n');
+			continue;
+		}
+
+		if (GetConditionState() == ConditionState::Inactive)
+		{
+			output.push_back('\n');
+			continue;
+		}
+
+		if (directive.empty())
+		{
+			output.append(line);
+			output.push_back('\n');
+			continue;
+		}
+
+		if (ConsumeToken(directive, "include"))
+		{
+			if (directive.size() < 2 || (directive.front() != '"' && directive.front() != '<'))
+			{
+				m_ErrorMessage = filePath + "(" + std::to_string(lineNumber) + "): Invalid include directive";
+				return false;
+			}
+
+			const char closing = directive.front() == '"' ? '"' : '>';
+			const size_t nameEnd = directive.find(closing, 1);
+			if (nameEnd == std::string_view::npos)
+			{
+				m_ErrorMessage = filePath + "(" + std::to_string(lineNumber) + "): Invalid include directive";
+				return false;
+			}
+
+			const std::string includePath = NormalizePath(m_IncludeRoot + std::string{ directive.substr(1, nameEnd - 1) });
+			if (!ProcessFile(includePath, output, dependencies, depth + 1))
+				return false;
+
+			AppendLineDirective(output, lineNumber + 1, fileIndex);
+		}
+		else if (ConsumeToken(directive, "version"))
+		{
+			// Version is set by the compiler, keep empty line so line numbers stay the same
+			output.push_back('\n');
+		}
+		else if (ConsumeToken(directive, "pragma") && directive == "once")
+		{
+			output.push_back('\n');
+		}
+		else if (ConsumeToken(directive, "start"))
+		{
+			// Stage marker isn't valid GLSL, keep it as a comment so Shader can still see it
+			output.append("// #start ");
+			output.append(directive);
+			output.push_back('\n');
+		}
+		else
+		{
+			if (ConsumeToken(directive, "define")) ProcessDefine(directive);
+			else if (ConsumeToken(directive, "undef")) ProcessUndef(directive);
+
+			output.append(line);
+			output.push_back('\n');
+		}
+	}
+
+	if (file.PragmaOnce) output.append("#endif // " + onceGuard + "\n");
+	return true;
+}
+
+const ShaderPreprocessor::SourceFile& ShaderPreprocessor::LoadFile(const std::string& filePath)
+{
+	const auto it = m_FileCache.find(filePath);
+	if (it != m_FileCache.end()) return it->second;
+
+	SourceFile& file = m_FileCache[filePath];
+
+	std::ifstream fileStream(filePath, std::ios::in | std::ios::binary);
+	if (!fileStream.is_open()) return file;
+
+	std::stringstream buffer;
+	buffer << fileStream.rdbuf();
+	file.Content = buffer.str();
+	file.Loaded = true;
+
+	// Look for #pragma once and classic #ifndef X / #define X include guard at the top of the file
+	std::string_view source = file.Content;
+	std::string_view guardCandidate{};
+	size_t lineStart = 0;
+	while (lineStart < source.size())
+	{
+		size_t lineEnd = source.find('\n', lineStart);
+		if (lineEnd == std::string_view::npos) lineEnd = source.size();
+
+		const std::string_view line = Trim(source.substr(lineStart, lineEnd - lineStart));
+		lineStart = lineEnd + 1;
+
+		if (line.empty() || line.substr(0, 2) == "//") continue;
+
+		std::string_view directive = GetDirective(line);
+		if (directive.empty()) break;
+
+		if (ConsumeToken(directive, "pragma") && directive == "once")
+		{
+			file.PragmaOnce = true;
+			break;
+		}
+		else if (guardCandidate.empty() && ConsumeToken(directive, "ifndef"))
+		{
+			guardCandidate = ReadIdentifier(directive);
+			if (guardCandidate.empty()) break;
+		}
+		else if (!guardCandidate.empty() && ConsumeToken(directive, "define"))
+		{
+			if (ReadIdentifier(directive) == guardCandidate) file.IncludeGuard = std::string{ guardCandidate };
+			break;
+		}
+		else if (!ConsumeToken(directive, "version"))
+		{
+			break;
+		}
+	}
+
+	return file;
+}
+
+unsigned ShaderPreprocessor::GetFileIndex(const std::string& filePath)
+{
+	const auto it = std::find(m_FileNames.begin(), m_FileNames.end(), filePath);
+	if (it != m_FileNames.end()) return (unsigned)(it - m_FileNames.begin());
+
+	m_FileNames.push_back(filePath);
+	return (unsigned)m_FileNames.size() - 1;
+}
+
+void ShaderPreprocessor::ProcessDefine(std::string_view directive)
+{
+	const std::string name{ ReadIdentifier(directive) };
+	if (name.empty()) return;
+
+	if (GetConditionState() == ConditionState::Unknown)
+	{
+		m_UncertainDefines.insert(name);
+		return;
+	}
+	m_UncertainDefines.erase(name);
+	m_Defines[name] = std::string{ Trim(directive.substr(name.size())) };
+}
+
+void ShaderPreprocessor::ProcessUndef(std::string_view directive)
+{
+	const std::string name{ ReadIdentifier(directive) };
+	if (GetConditionState() == ConditionState::Unknown)
+	{
+		m_UncertainDefines.insert(name);
+		return;
+	}
+	m_UncertainDefines.erase(name);
+	m_Defines.erase(name);
+}
+
+bool ShaderPreprocessor::ProcessCondition(std::string_view directive)
+{
+	const bool isIfdef = ConsumeToken(directive, "ifdef");
+	const bool isIfndef = !isIfdef && ConsumeToken(directive, "ifndef");
+	if (isIfdef || isIfndef || ConsumeToken(directive, "if"))
+	{
+		Condition condition{};
+		condition.Parent = GetConditionState();
+		if (condition.Parent == ConditionState::Inactive)
+		{
+			condition.State = ConditionState::Inactive;
+		}
+		else if (isIfdef || isIfndef)
+		{
+			condition.State = IsDefined(ReadIdentifier(directive));
+			if (isIfndef && condition.State != ConditionState::Unknown)
+				condition.State = condition.State == ConditionState::Active ? ConditionState::Inactive : ConditionState::Active;
+		}
+		else
+		{
+			condition.State = directive == "0" ? ConditionState::Inactive : directive == "1" ? ConditionState::Active : ConditionState::Unknown;
+		}
+		condition.BranchTaken = condition.State == ConditionState::Active;
+		m_Conditions.push_back(condition);
+		return true;
+	}
+
+	const bool isElif = ConsumeToken(directive, "elif");
+	if (isElif || ConsumeToken(directive, "else"))
+	{
+		if (m_Conditions.empty()) return true;
+
+		// Once a branch was surely taken the rest are inactive, #elif expressions are left to the compiler
+		Condition& condition = m_Conditions.back();
+		if (condition.Parent == ConditionState::Inactive || condition.BranchTaken) condition.State = ConditionState::Inactive;
+		else if (isElif || condition.State == ConditionState::Unknown) condition.State = ConditionState::Unknown;
+		else condition.State = ConditionState::Active;
+		condition.BranchTaken |= condition.State == ConditionState::Active;
+		return true;
+	}
+
+	if (ConsumeToken(directive, "endif"))
+	{
+		if (!m_Conditions.empty()) m_Conditions.pop_back();
+		return true;
+	}
+
+	return false;
+}
+
+ShaderPreprocessor::ConditionState ShaderPreprocessor::GetConditionState() const
+{
+	if (m_Conditions.empty()) return ConditionState::Active;
+
+	const Condition& condition = m_Conditions.back();
+	if (condition.Parent == ConditionState::Inactive || condition.State == ConditionState::Inactive) return ConditionState::Inactive;
+	if (condition.Parent == ConditionState::Unknown || condition.State == ConditionState::Unknown) return ConditionState::Unknown;
+	return ConditionState::Active;
+}
+
+ShaderPreprocessor::ConditionState ShaderPreprocessor::IsDefined(std::string_view name) const
+{
+	const std::string nameString{ name };
+	if (m_UncertainDefines.count(nameString)) return ConditionState::Unknown;
+	return m_Defines.count(nameString) ? ConditionState::Active : ConditionState::Inactive;
+}
+
+std::string ShaderPreprocessor::MapErrorLocations(const std::string& log) const
+{
+	const auto readNumber = [](std::string_view str, size_t& position, unsigned& number)
+	{
+		const size_t start = position;
+		number = 0;
+		while (position < str.size() && std::isdigit((unsigned char)str[position]))
+			number = number * 10 + (str[position++] - '0');
+		return position > start;
+	};
+
+	const auto getFileName = [this](unsigned fileIndex)
+	{
+		return fileIndex < m_FileNames.size() ? m_FileNames[fileIndex] : std::to_string(fileIndex);
+	};
+
+	std::string mappedLog;
+	const std::string_view logView = log;
+	size_t lineStart = 0;
+	while (lineStart < logView.size())
+	{
+		size_t lineEnd = logView.find('\n', lineStart);
+		if (lineEnd == std::string_view::npos) lineEnd = logView.size();
+
+		std::string_view line = logView.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+
+		// "ERROR: 0:12: message" style
+		std::string prefix = "";
+		for (const char* severity : { "ERROR: ", "WARNING: " })
+		{
+			if (line.substr(0, strlen(severity)) == severity)
+			{
+				prefix = severity;
+				line.remove_prefix(prefix.size());
+				break;
+			}
+		}
+
+		unsigned fileIndex, lineNumber;
+		size_t position = 0;
+		if (readNumber(line, position, fileIndex) && position < line.size())
+		{
+			// "0(12) : message" style
+			const char separator = line[position++];
+			if (separator == '(' && readNumber(line, position, lineNumber) && position < line.size() && line[position] == ')')
+			{
+				mappedLog += prefix + getFileName(fileIndex) + "(" + std::to_string(lineNumber) + std::string{ line.substr(position) } + "\n";
+				continue;
+			}
+			if (separator == ':' && readNumber(line, position, lineNumber))
+			{
+				mappedLog += prefix + getFileName(fileIndex) + ":" + std::to_string(lineNumber) + std::string{ line.substr(position) } + "\n";
+				continue;
+			}
+		}
+
+		mappedLog += prefix + std::string{ line } + "\n";
+	}
+	return mappedLog;
+}
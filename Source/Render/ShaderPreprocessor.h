@@ -0,0 +1,75 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+// Expands #include directives of the shader in a single pass per stage
+// Loaded files are cached for the lifetime of the preprocessor, so keep one instance while compiling a batch of shaders
+// Output contains #line directives with file index as source string number, use MapErrorLocations to get file names back
+// Every stage is processed with its macro defined and #ifdef blocks followed, so include guards and #pragma once
+// apply per stage. Blocks under #if expressions are left to the compiler, includes in them are always expanded
+class ShaderPreprocessor
+{
+	struct SourceFile
+	{
+		bool Loaded = false;
+		bool PragmaOnce = false;
+		std::string IncludeGuard = "";
+		std::string Content = "";
+	};
+
+	enum class ConditionState
+	{
+		Active,
+		Inactive,
+		Unknown,
+	};
+
+	struct Condition
+	{
+		ConditionState Parent = ConditionState::Active;
+		ConditionState State = ConditionState::Active;
+		bool BranchTaken = false;
+	};
+
+public:
+	// Outputs one source per stage macro, in the same order
+	bool Process(const std::string& path, const std::vector<std::string>& stageDefines, std::vector<std::string>& outputs, std::vector<std::string>& dependencies);
+
+	// Replaces file indices in driver error messages with file names
+	std::string MapErrorLocations(const std::string& log) const;
+
+	const std::string& GetErrorMessage() const { return m_ErrorMessage; }
+
+private:
+	bool ProcessFile(const std::string& filePath, std::string& output, std::vector<std::string>& dependencies, unsigned depth);
+	const SourceFile& LoadFile(const std::string& filePath);
+	unsigned GetFileIndex(const std::string& filePath);
+
+	void ProcessDefine(std::string_view directive);
+	void ProcessUndef(std::string_view directive);
+
+	// Returns false if the directive isn't a conditional one
+	bool ProcessCondition(std::string_view directive);
+	ConditionState GetConditionState() const;
+	ConditionState IsDefined(std::string_view name) const;
+
+private:
+	std::string m_IncludeRoot = "";
+	std::string m_ErrorMessage = "";
+
+	// Per run
+	std::unordered_map<std::string, SourceFile> m_FileCache;
+
+	// Per processed shader
+	std::vector<std::string> m_FileNames;
+
+	// Per stage, defines made under #if expressions may or may not exist
+	std::unordered_map<std::string, std::string> m_Defines;
+	std::unordered_set<std::string> m_UncertainDefines;
+	std::unordered_set<std::string> m_OnceFiles;
+	std::vector<Condition> m_Conditions;
+};
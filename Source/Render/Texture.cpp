@@ -1,10 +1,17 @@
 #include "Texture.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "../Common.h"
 
 Ptr<Texture> Texture::Create(unsigned width, unsigned height, unsigned flags, const void* textureData)
 {
 	unsigned numMips = 1;
+	if (flags & TF_GenerateMips)
+	{
+		numMips = 1 + (unsigned)std::floor(std::log2((float)std::max(width, height)));
+	}
 
 	Texture* texture = new Texture{};
 	texture->Width = width;
@@ -18,13 +25,18 @@ Ptr<Texture> Texture::Create(unsigned width, unsigned height, unsigned flags, co
 	if (textureData)
 	{
 		GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, textureData));
+		if (numMips > 1)
+		{
+			GL_CALL(glGenerateMipmap(GL_TEXTURE_2D));
+		}
 	}
 
 	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, 0));
 	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_LOD, 0));
 	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LOD, numMips-1));
 	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numMips-1));
-	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+	// Default sampling state, overridden by sampler objects bound through bind tables
+	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, numMips > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
 	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
 	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
 	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
@@ -51,6 +63,63 @@ Ptr<Texture> Texture::Create(unsigned width, unsigned height, unsigned flags, co
 	return Ptr<Texture>(texture);
 }
 
+// S3TC formats are only exposed through EXT_texture_compression_s3tc
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+static GLenum GetGLCompressedFormat(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	case TextureFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+	case TextureFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	default:
+		NOT_IMPLEMENTED;
+		break;
+	}
+	return GL_INVALID_ENUM;
+}
+
+Ptr<Texture> Texture::CreateCompressed(TextureFormat format, const std::vector<TextureMipData>& mips)
+{
+	ASSERT(IsCompressedFormat(format));
+	ASSERT(!mips.empty());
+
+	const GLenum glFormat = GetGLCompressedFormat(format);
+	const unsigned numMips = (unsigned)mips.size();
+
+	Texture* texture = new Texture{};
+	texture->Format = format;
+	texture->Width = mips[0].Width;
+	texture->Height = mips[0].Height;
+	texture->NumMips = numMips;
+	texture->Flags = TF_None;
+
+	GL_CALL(glGenTextures(1, &texture->TextureHandle));
+	GL_CALL(glBindTexture(GL_TEXTURE_2D, texture->TextureHandle));
+	GL_CALL(glTexStorage2D(GL_TEXTURE_2D, numMips, glFormat, texture->Width, texture->Height));
+	for (unsigned mip = 0; mip < numMips; mip++)
+	{
+		const TextureMipData& mipData = mips[mip];
+		GL_CALL(glCompressedTexSubImage2D(GL_TEXTURE_2D, mip, 0, 0, mipData.Width, mipData.Height, glFormat, mipData.ByteSize, mipData.Data));
+	}
+
+	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numMips - 1));
+	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, numMips > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
+	GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+	GL_CALL(glBindTexture(GL_TEXTURE_2D, 0));
+
+	return Ptr<Texture>(texture);
+}
+
 Texture::~Texture()
 {
 	GL_CALL(glDeleteTextures(1, &TextureHandle));
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "../Common.h"
 
 enum TextureFlags : unsigned
@@ -8,14 +10,74 @@ enum TextureFlags : unsigned
 
 	TF_Framebuffer = 1,
 	TF_DepthStencil = TF_Framebuffer << 1,
+	TF_GenerateMips = TF_DepthStencil << 1,
+};
+
+// DO NOT CHANGE ORDER OF VALUES
+// IT WILL AFFECT HOW WE LOAD OLD SAVE FILES
+// ALWAYS APPEND ON END
+enum class TextureFormat
+{
+	RGBA8,
+	BC1,
+	BC3,
+	BC5,
+	BC7,
+
+	Count,
+};
+
+inline const char* ToString(TextureFormat format)
+{
+	switch (format)
+	{
+		ENUM_STR_CASE(TextureFormat, RGBA8);
+		ENUM_STR_CASE(TextureFormat, BC1);
+		ENUM_STR_CASE(TextureFormat, BC3);
+		ENUM_STR_CASE(TextureFormat, BC5);
+		ENUM_STR_CASE(TextureFormat, BC7);
+	default:
+		NOT_IMPLEMENTED;
+	}
+	return "Invalid";
+}
+
+inline bool IsCompressedFormat(TextureFormat format)
+{
+	return format != TextureFormat::RGBA8;
+}
+
+// Size of 4x4 block in bytes for compressed formats
+inline unsigned GetBlockByteSize(TextureFormat format)
+{
+	switch (format)
+	{
+	case TextureFormat::BC1: return 8;
+	case TextureFormat::BC3:
+	case TextureFormat::BC5:
+	case TextureFormat::BC7: return 16;
+	default:
+		NOT_IMPLEMENTED;
+	}
+	return 0;
+}
+
+struct TextureMipData
+{
+	unsigned Width = 0;
+	unsigned Height = 0;
+	unsigned ByteSize = 0;
+	const void* Data = nullptr;
 };
 
 struct Texture
 {
 	static Ptr<Texture> Create(unsigned width, unsigned height, unsigned flags = TF_None, const void* textureData = nullptr);
+	static Ptr<Texture> CreateCompressed(TextureFormat format, const std::vector<TextureMipData>& mips);
 
 	~Texture();
 
+	TextureFormat Format = TextureFormat::RGBA8;
 	unsigned Flags = TF_None;
 	unsigned Width = 0;
 	unsigned Height = 0;
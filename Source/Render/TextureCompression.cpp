@@ -0,0 +1,462 @@
+#include "TextureCompression.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+#include <stb_image.h>
+
+#include "TextureFile.h"
+
+namespace TextureCompression
+{
+	namespace
+	{
+		struct Block
+		{
+			Float4 Pixels[16];
+		};
+
+		void FetchBlock(const uint8_t* rgba, unsigned width, unsigned height, unsigned blockX, unsigned blockY, Block& block)
+		{
+			for (unsigned y = 0; y < 4; y++)
+			{
+				// Clamp to the edge for images that aren't multiple of 4
+				const unsigned py = std::min(blockY * 4 + y, height - 1);
+				for (unsigned x = 0; x < 4; x++)
+				{
+					const unsigned px = std::min(blockX * 4 + x, width - 1);
+					const uint8_t* pixel = rgba + 4 * (py * width + px);
+					block.Pixels[4 * y + x] = Float4{ pixel[0], pixel[1], pixel[2], pixel[3] };
+				}
+			}
+		}
+
+		float SquaredDistance(const Float4& a, const Float4& b, unsigned numChannels)
+		{
+			float distance = 0.0f;
+			for (unsigned i = 0; i < numChannels; i++)
+			{
+				const float d = a[i] - b[i];
+				distance += d * d;
+			}
+			return distance;
+		}
+
+		// Fits endpoints along the principal axis of the block colors
+		void FindEndpoints(const Block& block, unsigned numChannels, Float4& minColor, Float4& maxColor)
+		{
+			Float4 mean{ 0.0f };
+			for (const Float4& pixel : block.Pixels) mean += pixel;
+			mean /= 16.0f;
+
+			Float4x4 covariance{ 0.0f };
+			for (const Float4& pixel : block.Pixels)
+			{
+				Float4 d{ 0.0f };
+				for (unsigned i = 0; i < numChannels; i++) d[i] = pixel[i] - mean[i];
+				covariance += glm::outerProduct(d, d);
+			}
+
+			Float4 axis{ 0.0f };
+			for (unsigned i = 0; i < numChannels; i++) axis[i] = 1.0f;
+			for (unsigned iteration = 0; iteration < 8; iteration++)
+			{
+				axis = covariance * axis;
+				const float length = glm::length(axis);
+				if (length < 1e-6f) break;
+				axis /= length;
+			}
+
+			if (glm::length(axis) < 1e-6f)
+			{
+				minColor = mean;
+				maxColor = mean;
+				return;
+			}
+
+			float minT = FLT_MAX;
+			float maxT = -FLT_MAX;
+			for (const Float4& pixel : block.Pixels)
+			{
+				const float t = glm::dot(pixel - mean, axis);
+				minT = std::min(minT, t);
+				maxT = std::max(maxT, t);
+			}
+
+			minColor = glm::clamp(mean + axis * minT, Float4{ 0.0f }, Float4{ 255.0f });
+			maxColor = glm::clamp(mean + axis * maxT, Float4{ 0.0f }, Float4{ 255.0f });
+		}
+
+		uint16_t To565(const Float4& color)
+		{
+			const uint16_t r = (uint16_t)std::round(color.r * 31.0f / 255.0f);
+			const uint16_t g = (uint16_t)std::round(color.g * 63.0f / 255.0f);
+			const uint16_t b = (uint16_t)std::round(color.b * 31.0f / 255.0f);
+			return (r << 11) | (g << 5) | b;
+		}
+
+		Float4 From565(uint16_t color)
+		{
+			const unsigned r = (color >> 11) & 31;
+			const unsigned g = (color >> 5) & 63;
+			const unsigned b = color & 31;
+			return Float4{ (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255.0f };
+		}
+
+		void EncodeBC1Block(const Block& block, uint8_t* output)
+		{
+			Float4 minColor, maxColor;
+			FindEndpoints(block, 3, minColor, maxColor);
+
+			uint16_t color0 = To565(maxColor);
+			uint16_t color1 = To565(minColor);
+
+			// color0 > color1 selects 4 color mode
+			if (color0 < color1) std::swap(color0, color1);
+
+			uint32_t indices = 0;
+			if (color0 != color1)
+			{
+				Float4 palette[4];
+				palette[0] = From565(color0);
+				palette[1] = From565(color1);
+				palette[2] = (2.0f * palette[0] + palette[1]) / 3.0f;
+				palette[3] = (palette[0] + 2.0f * palette[1]) / 3.0f;
+
+				for (unsigned i = 0; i < 16; i++)
+				{
+					unsigned bestIndex = 0;
+					float bestDistance = FLT_MAX;
+					for (unsigned j = 0; j < 4; j++)
+					{
+						const float distance = SquaredDistance(block.Pixels[i], palette[j], 3);
+						if (distance < bestDistance)
+						{
+							bestDistance = distance;
+							bestIndex = j;
+						}
+					}
+					indices |= bestIndex << (2 * i);
+				}
+			}
+
+			memcpy(output, &color0, 2);
+			memcpy(output + 2, &color1, 2);
+			memcpy(output + 4, &indices, 4);
+		}
+
+		void EncodeBC4Block(const Block& block, unsigned channel, uint8_t* output)
+		{
+			float minValue = 255.0f;
+			float maxValue = 0.0f;
+			for (const Float4& pixel : block.Pixels)
+			{
+				minValue = std::min(minValue, pixel[channel]);
+				maxValue = std::max(maxValue, pixel[channel]);
+			}
+
+			const uint8_t value0 = (uint8_t)std::round(maxValue);
+			const uint8_t value1 = (uint8_t)std::round(minValue);
+
+			// value0 > value1 selects 8 value mode
+			uint64_t indices = 0;
+			if (value0 > value1)
+			{
+				float palette[8];
+				palette[0] = value0;
+				palette[1] = value1;
+				for (unsigned i = 1; i < 7; i++) palette[i + 1] = ((7 - i) * value0 + i * value1) / 7.0f;
+
+				for (unsigned i = 0; i < 16; i++)
+				{
+					uint64_t bestIndex = 0;
+					float bestDistance = FLT_MAX;
+					for (unsigned j = 0; j < 8; j++)
+					{
+						const float distance = std::abs(block.Pixels[i][channel] - palette[j]);
+						if (distance < bestDistance)
+						{
+							bestDistance = distance;
+							bestIndex = j;
+						}
+					}
+					indices |= bestIndex << (3 * i);
+				}
+			}
+
+			output[0] = value0;
+			output[1] = value1;
+			memcpy(output + 2, &indices, 6);
+		}
+
+		class BitWriter
+		{
+		public:
+			BitWriter(uint8_t* output) :
+				m_Output(output)
+			{
+				memset(m_Output, 0, 16);
+			}
+
+			void Write(uint32_t value, unsigned numBits)
+			{
+				for (unsigned i = 0; i < numBits; i++, m_Position++)
+				{
+					if ((value >> i) & 1) m_Output[m_Position >> 3] |= 1 << (m_Position & 7);
+				}
+			}
+
+		private:
+			uint8_t* m_Output;
+			unsigned m_Position = 0;
+		};
+
+		// Only mode 6 is used: single subset, RGBA 7 bit endpoints with unique p-bits and 4 bit indices
+		void EncodeBC7Block(const Block& block, uint8_t* output)
+		{
+			static constexpr unsigned Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+			Float4 minColor, maxColor;
+			FindEndpoints(block, 4, minColor, maxColor);
+
+			const auto quantize = [](const Float4& color, unsigned endpoint[4], unsigned& pBit)
+			{
+				float bestError = FLT_MAX;
+				for (unsigned p = 0; p < 2; p++)
+				{
+					unsigned quantized[4];
+					float error = 0.0f;
+					for (unsigned i = 0; i < 4; i++)
+					{
+						quantized[i] = (unsigned)std::clamp((int)std::round((color[i] - p) / 2.0f), 0, 127);
+						const float d = (float)((quantized[i] << 1) | p) - color[i];
+						error += d * d;
+					}
+
+					if (error < bestError)
+					{
+						bestError = error;
+						pBit = p;
+						std::copy(quantized, quantized + 4, endpoint);
+					}
+				}
+			};
+
+			unsigned endpoints[2][4];
+			unsigned pBits[2];
+			quantize(maxColor, endpoints[0], pBits[0]);
+			quantize(minColor, endpoints[1], pBits[1]);
+
+			Float4 palette[16];
+			for (unsigned i = 0; i < 16; i++)
+			{
+				for (unsigned c = 0; c < 4; c++)
+				{
+					const unsigned e0 = (endpoints[0][c] << 1) | pBits[0];
+					const unsigned e1 = (endpoints[1][c] << 1) | pBits[1];
+					palette[i][c] = (float)(((64 - Weights[i]) * e0 + Weights[i] * e1 + 32) >> 6);
+				}
+			}
+
+			unsigned indices[16];
+			for (unsigned i = 0; i < 16; i++)
+			{
+				float bestDistance = FLT_MAX;
+				for (unsigned j = 0; j < 16; j++)
+				{
+					const float distance = SquaredDistance(block.Pixels[i], palette[j], 4);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						indices[i] = j;
+					}
+				}
+			}
+
+			// Anchor index is stored with implicit zero MSB
+			if (indices[0] & 8)
+			{
+				for (unsigned c = 0; c < 4; c++) std::swap(endpoints[0][c], endpoints[1][c]);
+				std::swap(pBits[0], pBits[1]);
+				for (unsigned i = 0; i < 16; i++) indices[i] = 15 - indices[i];
+			}
+
+			BitWriter writer{ output };
+			writer.Write(1 << 6, 7);
+			for (unsigned c = 0; c < 4; c++)
+			{
+				writer.Write(endpoints[0][c], 7);
+				writer.Write(endpoints[1][c], 7);
+			}
+			writer.Write(pBits[0], 1);
+			writer.Write(pBits[1], 1);
+			writer.Write(indices[0], 3);
+			for (unsigned i = 1; i < 16; i++) writer.Write(indices[i], 4);
+		}
+
+		void EncodeBlock(const Block& block, TextureFormat format, uint8_t* output)
+		{
+			switch (format)
+			{
+			case TextureFormat::BC1:
+				EncodeBC1Block(block, output);
+				break;
+			case TextureFormat::BC3:
+				EncodeBC4Block(block, 3, output);
+				EncodeBC1Block(block, output + 8);
+				break;
+			case TextureFormat::BC5:
+				EncodeBC4Block(block, 0, output);
+				EncodeBC4Block(block, 1, output + 8);
+				break;
+			case TextureFormat::BC7:
+				EncodeBC7Block(block, output);
+				break;
+			default:
+				NOT_IMPLEMENTED;
+			}
+		}
+
+		std::vector<uint8_t> Downsample(const uint8_t* rgba, unsigned width, unsigned height)
+		{
+			const unsigned mipWidth = std::max(1u, width / 2);
+			const unsigned mipHeight = std::max(1u, height / 2);
+
+			std::vector<uint8_t> mip(4 * mipWidth * mipHeight);
+			for (unsigned y = 0; y < mipHeight; y++)
+			{
+				const unsigned y0 = std::min(2 * y, height - 1);
+				const unsigned y1 = std::min(2 * y + 1, height - 1);
+				for (unsigned x = 0; x < mipWidth; x++)
+				{
+					const unsigned x0 = std::min(2 * x, width - 1);
+					const unsigned x1 = std::min(2 * x + 1, width - 1);
+					for (unsigned c = 0; c < 4; c++)
+					{
+						const unsigned sum = rgba[4 * (y0 * width + x0) + c] + rgba[4 * (y0 * width + x1) + c] + rgba[4 * (y1 * width + x0) + c] + rgba[4 * (y1 * width + x1) + c];
+						mip[4 * (y * mipWidth + x) + c] = (uint8_t)((sum + 2) / 4);
+					}
+				}
+			}
+			return mip;
+		}
+	}
+
+	std::vector<uint8_t> Compress(const uint8_t* rgba, unsigned width, unsigned height, TextureFormat format)
+	{
+		ASSERT(IsCompressedFormat(format));
+
+		const unsigned blocksX = (width + 3) / 4;
+		const unsigned blocksY = (height + 3) / 4;
+		const unsigned blockByteSize = GetBlockByteSize(format);
+
+		std::vector<uint8_t> compressed(blocksX * blocksY * blockByteSize);
+
+		const auto compressRows = [&](unsigned firstRow, unsigned lastRow)
+		{
+			Block block;
+			for (unsigned blockY = firstRow; blockY < lastRow; blockY++)
+			{
+				for (unsigned blockX = 0; blockX < blocksX; blockX++)
+				{
+					FetchBlock(rgba, width, height, blockX, blockY, block);
+					EncodeBlock(block, format, compressed.data() + (blockY * blocksX + blockX) * blockByteSize);
+				}
+			}
+		};
+
+		const unsigned numThreads = std::max(1u, std::min(std::thread::hardware_concurrency(), blocksY / 16));
+		if (numThreads == 1)
+		{
+			compressRows(0, blocksY);
+			return compressed;
+		}
+
+		std::vector<std::thread> workers;
+		const unsigned rowsPerThread = (blocksY + numThreads - 1) / numThreads;
+		for (unsigned i = 0; i < numThreads; i++)
+		{
+			const unsigned firstRow = i * rowsPerThread;
+			const unsigned lastRow = std::min(blocksY, firstRow + rowsPerThread);
+			if (firstRow < lastRow) workers.emplace_back(compressRows, firstRow, lastRow);
+		}
+		for (std::thread& worker : workers) worker.join();
+
+		return compressed;
+	}
+
+	std::string GetCookedPath(const std::string& sourcePath, TextureFormat format)
+	{
+		const std::filesystem::path path{ sourcePath };
+		return (path.parent_path() / (path.stem().string() + "." + ToString(format) + ".dds")).string();
+	}
+
+	bool IsCookUpToDate(const std::string& sourcePath, const std::string& cookedPath)
+	{
+		std::error_code error;
+		const auto cookedTime = std::filesystem::last_write_time(cookedPath, error);
+		if (error) return false;
+
+		const auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+		if (error) return true; // Only cooked file is shipped
+
+		// Files cooked before row order was marked would be flipped twice
+		return cookedTime >= sourceTime && TextureFile::IsCookedDDS(cookedPath);
+	}
+
+	bool CookTexture(const std::string& sourcePath, const std::string& cookedPath, TextureFormat format, std::string& errorMessage)
+	{
+		if (!IsCompressedFormat(format))
+		{
+			errorMessage = "Trying to cook " + sourcePath + " to uncompressed format";
+			return false;
+		}
+
+		int width, height, bpp;
+		stbi_set_flip_vertically_on_load(true);
+		stbi_uc* data = stbi_load(sourcePath.c_str(), &width, &height, &bpp, 4);
+		if (!data)
+		{
+			errorMessage = "Failed to load " + sourcePath;
+			return false;
+		}
+
+		std::vector<std::vector<uint8_t>> compressedMips;
+		std::vector<TextureMipData> mips;
+
+		std::vector<uint8_t> mipPixels{ data, data + 4 * width * height };
+		stbi_image_free(data);
+
+		unsigned mipWidth = width;
+		unsigned mipHeight = height;
+		while (true)
+		{
+			compressedMips.push_back(Compress(mipPixels.data(), mipWidth, mipHeight, format));
+
+			TextureMipData mip;
+			mip.Width = mipWidth;
+			mip.Height = mipHeight;
+			mip.ByteSize = (unsigned)compressedMips.back().size();
+			mips.push_back(mip);
+
+			if (mipWidth == 1 && mipHeight == 1) break;
+
+			mipPixels = Downsample(mipPixels.data(), mipWidth, mipHeight);
+			mipWidth = std::max(1u, mipWidth / 2);
+			mipHeight = std::max(1u, mipHeight / 2);
+		}
+
+		for (size_t i = 0; i < mips.size(); i++) mips[i].Data = compressedMips[i].data();
+
+		if (!TextureFile::SaveDDS(cookedPath, format, mips))
+		{
+			errorMessage = "Failed to write " + cookedPath;
+			return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../Common.h"
+#include "Texture.h"
+
+namespace TextureCompression
+{
+	// Compresses RGBA8 image into BC blocks, rows of blocks are split across worker threads
+	std::vector<uint8_t> Compress(const uint8_t* rgba, unsigned width, unsigned height, TextureFormat format);
+
+	// Path of the cooked .dds that is stored next to the source image
+	std::string GetCookedPath(const std::string& sourcePath, TextureFormat format);
+	bool IsCookUpToDate(const std::string& sourcePath, const std::string& cookedPath);
+
+	// Loads source image, builds mip chain on the CPU, compresses every mip and writes it as .dds
+	bool CookTexture(const std::string& sourcePath, const std::string& cookedPath, TextureFormat format, std::string& errorMessage);
+}
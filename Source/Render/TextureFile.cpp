@@ -0,0 +1,523 @@
+#include "TextureFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace TextureFile
+{
+	namespace DDS
+	{
+		static constexpr uint32_t Magic = 0x20534444; // "DDS "
+
+		static constexpr uint32_t DDSD_CAPS = 0x1;
+		static constexpr uint32_t DDSD_HEIGHT = 0x2;
+		static constexpr uint32_t DDSD_WIDTH = 0x4;
+		static constexpr uint32_t DDSD_PIXELFORMAT = 0x1000;
+		static constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+		static constexpr uint32_t DDSD_LINEARSIZE = 0x80000;
+
+		static constexpr uint32_t DDPF_FOURCC = 0x4;
+
+		static constexpr uint32_t DDSCAPS_COMPLEX = 0x8;
+		static constexpr uint32_t DDSCAPS_TEXTURE = 0x1000;
+		static constexpr uint32_t DDSCAPS_MIPMAP = 0x400000;
+
+		static constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+		static constexpr uint32_t DDSCAPS2_VOLUME = 0x200000;
+
+		static constexpr uint32_t DIMENSION_TEXTURE2D = 3;
+		static constexpr uint32_t MISC_TEXTURECUBE = 0x4;
+
+		static constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+		{
+			return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24);
+		}
+
+		enum DXGIFormat : uint32_t
+		{
+			DXGI_FORMAT_BC1_TYPELESS = 70,
+			DXGI_FORMAT_BC1_UNORM = 71,
+			DXGI_FORMAT_BC1_UNORM_SRGB = 72,
+			DXGI_FORMAT_BC3_TYPELESS = 76,
+			DXGI_FORMAT_BC3_UNORM = 77,
+			DXGI_FORMAT_BC3_UNORM_SRGB = 78,
+			DXGI_FORMAT_BC5_TYPELESS = 82,
+			DXGI_FORMAT_BC5_UNORM = 83,
+			DXGI_FORMAT_BC7_TYPELESS = 97,
+			DXGI_FORMAT_BC7_UNORM = 98,
+			DXGI_FORMAT_BC7_UNORM_SRGB = 99,
+		};
+
+		struct PixelFormatHeader
+		{
+			uint32_t Size;
+			uint32_t Flags;
+			uint32_t FourCC;
+			uint32_t RGBBitCount;
+			uint32_t RBitMask;
+			uint32_t GBitMask;
+			uint32_t BBitMask;
+			uint32_t ABitMask;
+		};
+
+		struct Header
+		{
+			uint32_t Size;
+			uint32_t Flags;
+			uint32_t Height;
+			uint32_t Width;
+			uint32_t PitchOrLinearSize;
+			uint32_t Depth;
+			uint32_t MipMapCount;
+			uint32_t Reserved1[11];
+			PixelFormatHeader PixelFormat;
+			uint32_t Caps;
+			uint32_t Caps2;
+			uint32_t Caps3;
+			uint32_t Caps4;
+			uint32_t Reserved2;
+		};
+		static_assert(sizeof(Header) == 124, "Invalid DDS header size");
+
+		// DDS rows go top to bottom, cooked textures are written bottom to top like every other texture we upload
+		// and are marked with this in Reserved1[8]
+		static constexpr uint32_t BottomUpMarker = MakeFourCC('R', 'N', 'B', 'U');
+
+		struct HeaderDX10
+		{
+			uint32_t DXGIFormat;
+			uint32_t ResourceDimension;
+			uint32_t MiscFlag;
+			uint32_t ArraySize;
+			uint32_t MiscFlags2;
+		};
+		static_assert(sizeof(HeaderDX10) == 20, "Invalid DDS DX10 header size");
+
+		static TextureFormat FromFourCC(uint32_t fourCC)
+		{
+			if (fourCC == MakeFourCC('D', 'X', 'T', '1')) return TextureFormat::BC1;
+			if (fourCC == MakeFourCC('D', 'X', 'T', '5')) return TextureFormat::BC3;
+			if (fourCC == MakeFourCC('A', 'T', 'I', '2')) return TextureFormat::BC5;
+			if (fourCC == MakeFourCC('B', 'C', '5', 'U')) return TextureFormat::BC5;
+			return TextureFormat::Count;
+		}
+
+		static TextureFormat FromDXGIFormat(uint32_t format)
+		{
+			switch (format)
+			{
+			case DXGI_FORMAT_BC1_TYPELESS:
+			case DXGI_FORMAT_BC1_UNORM:
+			case DXGI_FORMAT_BC1_UNORM_SRGB: return TextureFormat::BC1;
+			case DXGI_FORMAT_BC3_TYPELESS:
+			case DXGI_FORMAT_BC3_UNORM:
+			case DXGI_FORMAT_BC3_UNORM_SRGB: return TextureFormat::BC3;
+			case DXGI_FORMAT_BC5_TYPELESS:
+			case DXGI_FORMAT_BC5_UNORM: return TextureFormat::BC5;
+			case DXGI_FORMAT_BC7_TYPELESS:
+			case DXGI_FORMAT_BC7_UNORM:
+			case DXGI_FORMAT_BC7_UNORM_SRGB: return TextureFormat::BC7;
+			}
+			return TextureFormat::Count;
+		}
+
+		static uint32_t ToDXGIFormat(TextureFormat format)
+		{
+			switch (format)
+			{
+			case TextureFormat::BC1: return DXGI_FORMAT_BC1_UNORM;
+			case TextureFormat::BC3: return DXGI_FORMAT_BC3_UNORM;
+			case TextureFormat::BC5: return DXGI_FORMAT_BC5_UNORM;
+			case TextureFormat::BC7: return DXGI_FORMAT_BC7_UNORM;
+			default:
+				NOT_IMPLEMENTED;
+			}
+			return 0;
+		}
+	}
+
+	namespace KTX2
+	{
+		static constexpr uint8_t Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+		enum VkFormat : uint32_t
+		{
+			VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131,
+			VK_FORMAT_BC1_RGB_SRGB_BLOCK = 132,
+			VK_FORMAT_BC1_RGBA_UNORM_BLOCK = 133,
+			VK_FORMAT_BC1_RGBA_SRGB_BLOCK = 134,
+			VK_FORMAT_BC3_UNORM_BLOCK = 137,
+			VK_FORMAT_BC3_SRGB_BLOCK = 138,
+			VK_FORMAT_BC5_UNORM_BLOCK = 141,
+			VK_FORMAT_BC7_UNORM_BLOCK = 145,
+			VK_FORMAT_BC7_SRGB_BLOCK = 146,
+		};
+
+		struct Header
+		{
+			uint8_t Identifier[12];
+			uint32_t VkFormat;
+			uint32_t TypeSize;
+			uint32_t PixelWidth;
+			uint32_t PixelHeight;
+			uint32_t PixelDepth;
+			uint32_t LayerCount;
+			uint32_t FaceCount;
+			uint32_t LevelCount;
+			uint32_t SupercompressionScheme;
+
+			uint32_t DfdByteOffset;
+			uint32_t DfdByteLength;
+			uint32_t KvdByteOffset;
+			uint32_t KvdByteLength;
+			uint64_t SgdByteOffset;
+			uint64_t SgdByteLength;
+		};
+		static_assert(sizeof(Header) == 80, "Invalid KTX2 header size");
+
+		// Key that tells the direction of rows, value "rd" (default) is top to bottom and "ru" is bottom to top
+		static constexpr char OrientationKey[] = "KTXorientation";
+
+		struct LevelIndex
+		{
+			uint64_t ByteOffset;
+			uint64_t ByteLength;
+			uint64_t UncompressedByteLength;
+		};
+
+		static TextureFormat FromVkFormat(uint32_t format)
+		{
+			switch (format)
+			{
+			case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+			case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+			case VK_FORMAT_BC1_RGBA_SRGB_BLOCK: return TextureFormat::BC1;
+			case VK_FORMAT_BC3_UNORM_BLOCK:
+			case VK_FORMAT_BC3_SRGB_BLOCK: return TextureFormat::BC3;
+			case VK_FORMAT_BC5_UNORM_BLOCK: return TextureFormat::BC5;
+			case VK_FORMAT_BC7_UNORM_BLOCK:
+			case VK_FORMAT_BC7_SRGB_BLOCK: return TextureFormat::BC7;
+			}
+			return TextureFormat::Count;
+		}
+	}
+
+	static bool ReadFileBytes(const std::string& path, std::vector<uint8_t>& bytes)
+	{
+		std::ifstream file{ path, std::ios::binary | std::ios::ate };
+		if (!file.is_open()) return false;
+
+		const std::streamsize size = file.tellg();
+		file.seekg(0, std::ios::beg);
+		bytes.resize((size_t)size);
+		return (bool)file.read((char*)bytes.data(), size);
+	}
+
+	static unsigned GetMipByteSize(TextureFormat format, unsigned width, unsigned height)
+	{
+		return ((width + 3) / 4) * ((height + 3) / 4) * GetBlockByteSize(format);
+	}
+
+	// BC1 color block has one byte of 2 bit indices per row after the two endpoints
+	static void FlipColorBlock(uint8_t* block, unsigned numRows)
+	{
+		std::reverse(block + 4, block + 4 + numRows);
+	}
+
+	// BC3 alpha and BC5 channel blocks have 12 bits of 3 bit indices per row after the two endpoints
+	static void FlipChannelBlock(uint8_t* block, unsigned numRows)
+	{
+		uint64_t indices = 0;
+		for (unsigned i = 0; i < 6; i++) indices |= (uint64_t)block[2 + i] << (8 * i);
+
+		uint64_t flippedIndices = indices;
+		for (unsigned row = 0; row < numRows; row++)
+		{
+			const uint64_t rowIndices = (indices >> (12 * row)) & 0xFFF;
+			const unsigned flippedRow = numRows - 1 - row;
+			flippedIndices &= ~(0xFFFull << (12 * flippedRow));
+			flippedIndices |= rowIndices << (12 * flippedRow);
+		}
+
+		for (unsigned i = 0; i < 6; i++) block[2 + i] = (uint8_t)(flippedIndices >> (8 * i));
+	}
+
+	// Reverses block rows and rows inside every block
+	static void FlipMipVertically(TextureFormat format, uint8_t* data, unsigned width, unsigned height)
+	{
+		const unsigned blockByteSize = GetBlockByteSize(format);
+		const unsigned blocksX = (width + 3) / 4;
+		const unsigned blocksY = (height + 3) / 4;
+		const unsigned rowByteSize = blocksX * blockByteSize;
+
+		for (unsigned y = 0; y < blocksY / 2; y++)
+			std::swap_ranges(data + y * rowByteSize, data + (y + 1) * rowByteSize, data + (blocksY - 1 - y) * rowByteSize);
+
+		// Mips smaller than a block only use their first rows
+		const unsigned numRows = std::min(4u, height);
+		for (unsigned i = 0; i < blocksX * blocksY; i++)
+		{
+			uint8_t* block = data + i * blockByteSize;
+			switch (format)
+			{
+			case TextureFormat::BC1: FlipColorBlock(block, numRows); break;
+			case TextureFormat::BC3: FlipChannelBlock(block, numRows); FlipColorBlock(block + 8, numRows); break;
+			case TextureFormat::BC5: FlipChannelBlock(block, numRows); FlipChannelBlock(block + 8, numRows); break;
+			default: NOT_IMPLEMENTED;
+			}
+		}
+	}
+
+	// BC7 partitions don't survive a flip, and rows of a mip whose height isn't a multiple of 4 would have to move
+	// into neighbouring blocks that have other endpoints, both need re-encoding
+	static bool FlipVertically(CompressedTextureData& textureData, const std::string& path, std::string& errorMessage)
+	{
+		if (textureData.Format == TextureFormat::BC7)
+		{
+			errorMessage = path + " is BC7 stored top to bottom, it can't be flipped without re-encoding. Cook it from the source image instead";
+			return false;
+		}
+
+		for (const TextureMipData& mip : textureData.Mips)
+		{
+			if (mip.Height > 4 && mip.Height % 4 != 0)
+			{
+				errorMessage = path + " is stored top to bottom and has a mip " + std::to_string(mip.Height) + " pixels high, it can't be flipped without re-encoding. Cook it from the source image instead";
+				return false;
+			}
+		}
+
+		for (const TextureMipData& mip : textureData.Mips)
+			FlipMipVertically(textureData.Format, (uint8_t*)mip.Data, mip.Width, mip.Height);
+		return true;
+	}
+
+	static bool IsKTX2BottomUp(const std::vector<uint8_t>& bytes, const KTX2::Header& header)
+	{
+		if ((uint64_t)header.KvdByteOffset + header.KvdByteLength > bytes.size()) return false;
+
+		const uint8_t* kvd = bytes.data() + header.KvdByteOffset;
+		uint32_t offset = 0;
+		while (offset + sizeof(uint32_t) <= header.KvdByteLength)
+		{
+			uint32_t entryLength;
+			memcpy(&entryLength, kvd + offset, sizeof(uint32_t));
+			offset += sizeof(uint32_t);
+			if (entryLength > header.KvdByteLength - offset) return false;
+
+			const char* entry = (const char*)(kvd + offset);
+			const size_t keyLength = strnlen(entry, entryLength);
+			if (keyLength + 1 < entryLength && strcmp(entry, KTX2::OrientationKey) == 0)
+			{
+				const std::string value{ entry + keyLength + 1, strnlen(entry + keyLength + 1, entryLength - keyLength - 1) };
+				return value.size() > 1 && value[1] == 'u';
+			}
+
+			offset += (entryLength + 3) & ~3u;
+		}
+		return false;
+	}
+
+	bool LoadDDS(const std::string& path, CompressedTextureData& textureData, std::string& errorMessage)
+	{
+		std::vector<uint8_t>& bytes = textureData.Bytes;
+		if (!ReadFileBytes(path, bytes))
+		{
+			errorMessage = "Failed to open " + path;
+			return false;
+		}
+
+		if (bytes.size() < sizeof(uint32_t) + sizeof(DDS::Header) || *(uint32_t*)bytes.data() != DDS::Magic)
+		{
+			errorMessage = path + " is not a DDS file";
+			return false;
+		}
+
+		const DDS::Header& header = *(const DDS::Header*)(bytes.data() + sizeof(uint32_t));
+		size_t dataOffset = sizeof(uint32_t) + sizeof(DDS::Header);
+
+		if ((header.PixelFormat.Flags & DDS::DDPF_FOURCC) == 0)
+		{
+			errorMessage = path + " isn't block compressed";
+			return false;
+		}
+
+		if ((header.Caps2 & (DDS::DDSCAPS2_CUBEMAP | DDS::DDSCAPS2_VOLUME)) || header.Depth > 1)
+		{
+			errorMessage = path + " isn't a 2D texture";
+			return false;
+		}
+
+		if (header.PixelFormat.FourCC == DDS::MakeFourCC('D', 'X', '1', '0'))
+		{
+			if (bytes.size() < dataOffset + sizeof(DDS::HeaderDX10))
+			{
+				errorMessage = path + " is truncated";
+				return false;
+			}
+			const DDS::HeaderDX10& headerDX10 = *(const DDS::HeaderDX10*)(bytes.data() + dataOffset);
+			dataOffset += sizeof(DDS::HeaderDX10);
+
+			if (headerDX10.ResourceDimension != DDS::DIMENSION_TEXTURE2D || headerDX10.ArraySize > 1 || (headerDX10.MiscFlag & DDS::MISC_TEXTURECUBE))
+			{
+				errorMessage = path + " isn't a 2D texture";
+				return false;
+			}
+			textureData.Format = DDS::FromDXGIFormat(headerDX10.DXGIFormat);
+		}
+		else
+		{
+			textureData.Format = DDS::FromFourCC(header.PixelFormat.FourCC);
+		}
+
+		if (textureData.Format == TextureFormat::Count)
+		{
+			errorMessage = path + " uses unsupported format. Supported formats are BC1, BC3, BC5 and BC7";
+			return false;
+		}
+
+		const unsigned numMips = (header.Flags & DDS::DDSD_MIPMAPCOUNT) && header.MipMapCount > 0 ? header.MipMapCount : 1;
+		unsigned width = header.Width;
+		unsigned height = header.Height;
+
+		textureData.Mips.clear();
+		for (unsigned mip = 0; mip < numMips; mip++)
+		{
+			const unsigned mipByteSize = GetMipByteSize(textureData.Format, width, height);
+			if (dataOffset + mipByteSize > bytes.size())
+			{
+				errorMessage = path + " is truncated";
+				return false;
+			}
+
+			TextureMipData mipData;
+			mipData.Width = width;
+			mipData.Height = height;
+			mipData.ByteSize = mipByteSize;
+			mipData.Data = bytes.data() + dataOffset;
+			textureData.Mips.push_back(mipData);
+
+			dataOffset += mipByteSize;
+			width = std::max(1u, width / 2);
+			height = std::max(1u, height / 2);
+		}
+
+		if (header.Reserved1[8] == DDS::BottomUpMarker) return true;
+		return FlipVertically(textureData, path, errorMessage);
+	}
+
+	bool LoadKTX2(const std::string& path, CompressedTextureData& textureData, std::string& errorMessage)
+	{
+		std::vector<uint8_t>& bytes = textureData.Bytes;
+		if (!ReadFileBytes(path, bytes))
+		{
+			errorMessage = "Failed to open " + path;
+			return false;
+		}
+
+		if (bytes.size() < sizeof(KTX2::Header) || memcmp(bytes.data(), KTX2::Identifier, sizeof(KTX2::Identifier)) != 0)
+		{
+			errorMessage = path + " is not a KTX2 file";
+			return false;
+		}
+
+		const KTX2::Header& header = *(const KTX2::Header*)bytes.data();
+		if (header.SupercompressionScheme != 0)
+		{
+			errorMessage = path + " is supercompressed, only raw block compressed KTX2 files are supported";
+			return false;
+		}
+
+		if (header.PixelDepth > 1 || header.LayerCount > 1 || header.FaceCount > 1)
+		{
+			errorMessage = path + " isn't a 2D texture";
+			return false;
+		}
+
+		textureData.Format = KTX2::FromVkFormat(header.VkFormat);
+		if (textureData.Format == TextureFormat::Count)
+		{
+			errorMessage = path + " uses unsupported format. Supported formats are BC1, BC3, BC5 and BC7";
+			return false;
+		}
+
+		const unsigned numMips = std::max(1u, header.LevelCount);
+		if (bytes.size() < sizeof(KTX2::Header) + numMips * sizeof(KTX2::LevelIndex))
+		{
+			errorMessage = path + " is truncated";
+			return false;
+		}
+
+		const KTX2::LevelIndex* levels = (const KTX2::LevelIndex*)(bytes.data() + sizeof(KTX2::Header));
+		textureData.Mips.clear();
+		for (unsigned mip = 0; mip < numMips; mip++)
+		{
+			const unsigned width = std::max(1u, header.PixelWidth >> mip);
+			const unsigned height = std::max(1u, header.PixelHeight >> mip);
+			const KTX2::LevelIndex& level = levels[mip];
+			if (level.ByteOffset + level.ByteLength > bytes.size() || level.ByteLength < GetMipByteSize(textureData.Format, width, height))
+			{
+				errorMessage = path + " is truncated";
+				return false;
+			}
+
+			TextureMipData mipData;
+			mipData.Width = width;
+			mipData.Height = height;
+			mipData.ByteSize = GetMipByteSize(textureData.Format, width, height);
+			mipData.Data = bytes.data() + level.ByteOffset;
+			textureData.Mips.push_back(mipData);
+		}
+
+		if (IsKTX2BottomUp(bytes, header)) return true;
+		return FlipVertically(textureData, path, errorMessage);
+	}
+
+	bool IsCookedDDS(const std::string& path)
+	{
+		std::ifstream file{ path, std::ios::binary };
+		uint32_t magic = 0;
+		DDS::Header header{};
+		if (!file.read((char*)&magic, sizeof(magic)) || !file.read((char*)&header, sizeof(header))) return false;
+		return magic == DDS::Magic && header.Reserved1[8] == DDS::BottomUpMarker;
+	}
+
+	bool SaveDDS(const std::string& path, TextureFormat format, const std::vector<TextureMipData>& mips)
+	{
+		ASSERT(IsCompressedFormat(format));
+		ASSERT(!mips.empty());
+
+		std::ofstream file{ path, std::ios::binary };
+		if (!file.is_open()) return false;
+
+		DDS::Header header{};
+		header.Size = sizeof(DDS::Header);
+		header.Flags = DDS::DDSD_CAPS | DDS::DDSD_HEIGHT | DDS::DDSD_WIDTH | DDS::DDSD_PIXELFORMAT | DDS::DDSD_MIPMAPCOUNT | DDS::DDSD_LINEARSIZE;
+		header.Height = mips[0].Height;
+		header.Width = mips[0].Width;
+		header.PitchOrLinearSize = mips[0].ByteSize;
+		header.MipMapCount = (uint32_t)mips.size();
+		header.Reserved1[8] = DDS::BottomUpMarker;
+		header.PixelFormat.Size = sizeof(DDS::PixelFormatHeader);
+		header.PixelFormat.Flags = DDS::DDPF_FOURCC;
+		header.PixelFormat.FourCC = DDS::MakeFourCC('D', 'X', '1', '0');
+		header.Caps = DDS::DDSCAPS_TEXTURE | (mips.size() > 1 ? DDS::DDSCAPS_MIPMAP | DDS::DDSCAPS_COMPLEX : 0);
+
+		DDS::HeaderDX10 headerDX10{};
+		headerDX10.DXGIFormat = DDS::ToDXGIFormat(format);
+		headerDX10.ResourceDimension = DDS::DIMENSION_TEXTURE2D;
+		headerDX10.ArraySize = 1;
+
+		const uint32_t magic = DDS::Magic;
+		file.write((const char*)&magic, sizeof(magic));
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)&headerDX10, sizeof(headerDX10));
+		for (const TextureMipData& mip : mips)
+		{
+			file.write((const char*)mip.Data, mip.ByteSize);
+		}
+		return (bool)file;
+	}
+}
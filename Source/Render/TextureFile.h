@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../Common.h"
+#include "Texture.h"
+
+namespace TextureFile
+{
+	struct CompressedTextureData
+	{
+		TextureFormat Format = TextureFormat::RGBA8;
+
+		// Mip data points into Bytes
+		std::vector<uint8_t> Bytes;
+		std::vector<TextureMipData> Mips;
+	};
+
+	// Files are flipped to bottom to top row order on load, like images loaded with stb_image, unless they are marked as already flipped
+	bool LoadDDS(const std::string& path, CompressedTextureData& textureData, std::string& errorMessage);
+	bool LoadKTX2(const std::string& path, CompressedTextureData& textureData, std::string& errorMessage);
+
+	// Cooked files are stored bottom to top and marked so they aren't flipped again
+	bool IsCookedDDS(const std::string& path);
+	bool SaveDDS(const std::string& path, TextureFormat format, const std::vector<TextureMipData>& mips);
+}
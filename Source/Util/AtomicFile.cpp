@@ -0,0 +1,53 @@
+#include "AtomicFile.h"
+
+#include <windows.h>
+
+namespace AtomicFile
+{
+	namespace
+	{
+		bool WriteAndFlush(HANDLE file, const void* data, size_t size)
+		{
+			// WriteFile takes 32 bit sizes
+			static constexpr size_t MaxWriteSize = 1 << 30;
+			const char* bytes = static_cast<const char*>(data);
+			bool success = true;
+			while (success && size > 0)
+			{
+				const DWORD writeSize = (DWORD)(size < MaxWriteSize ? size : MaxWriteSize);
+				DWORD writtenSize = 0;
+				success = WriteFile(file, bytes, writeSize, &writtenSize, NULL) && writtenSize == writeSize;
+				bytes += writeSize;
+				size -= writeSize;
+			}
+
+			return success && FlushFileBuffers(file);
+		}
+	}
+
+	bool Write(const std::string& path, const void* data, size_t size)
+	{
+		const std::string tempPath = path + ".tmp";
+
+		HANDLE file = CreateFileA(tempPath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		bool success = WriteAndFlush(file, data, size);
+		CloseHandle(file);
+
+		success = success && MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+		if (!success) DeleteFileA(tempPath.c_str());
+		return success;
+	}
+
+	bool Append(const std::string& path, const void* data, size_t size)
+	{
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER distance{};
+		const bool success = SetFilePointerEx(file, distance, NULL, FILE_END) && WriteAndFlush(file, data, size);
+		CloseHandle(file);
+		return success;
+	}
+}
\ No newline at end of file
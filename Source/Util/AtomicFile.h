@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+namespace AtomicFile
+{
+	// Writes to a temporary file next to the destination, flushes it to disk and renames it over the destination
+	// Readers see either the old or the new contents, never a partially written file
+	bool Write(const std::string& path, const void* data, size_t size);
+
+	// Appends to the end of an existing file and flushes it, this one is not atomic
+	// A crash can leave part of the data written, so formats appended to have to detect a torn tail
+	bool Append(const std::string& path, const void* data, size_t size);
+}
@@ -0,0 +1,72 @@
+#include "BackgroundFileWriter.h"
+
+#include "AtomicFile.h"
+
+BackgroundFileWriter::BackgroundFileWriter() :
+	m_Worker([this] { WorkerLoop(); })
+{
+}
+
+BackgroundFileWriter::~BackgroundFileWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		m_Quit = true;
+	}
+	m_Condition.notify_all();
+
+	// Worker finishes the pending batch before it quits
+	m_Worker.join();
+}
+
+void BackgroundFileWriter::Write(std::vector<File>&& files)
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		m_PendingFiles = std::move(files);
+		m_HasPendingFiles = true;
+	}
+	m_Condition.notify_all();
+}
+
+void BackgroundFileWriter::Wait()
+{
+	std::unique_lock<std::mutex> lock{ m_Mutex };
+	m_Condition.wait(lock, [this] { return !m_HasPendingFiles && !m_Writing; });
+}
+
+std::vector<std::string> BackgroundFileWriter::TakeFailedPaths()
+{
+	std::vector<std::string> failedPaths;
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+	failedPaths.swap(m_FailedPaths);
+	return failedPaths;
+}
+
+void BackgroundFileWriter::WorkerLoop()
+{
+	std::unique_lock<std::mutex> lock{ m_Mutex };
+	while (true)
+	{
+		m_Condition.wait(lock, [this] { return m_HasPendingFiles || m_Quit; });
+		if (!m_HasPendingFiles) return;
+
+		std::vector<File> files = std::move(m_PendingFiles);
+		m_PendingFiles.clear();
+		m_HasPendingFiles = false;
+		m_Writing = true;
+		lock.unlock();
+
+		std::vector<std::string> failedPaths;
+		for (const File& file : files)
+		{
+			if (!AtomicFile::Write(file.Path, file.Data.data(), file.Data.size()))
+				failedPaths.push_back(file.Path);
+		}
+
+		lock.lock();
+		m_Writing = false;
+		m_FailedPaths.insert(m_FailedPaths.end(), failedPaths.begin(), failedPaths.end());
+		m_Condition.notify_all();
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Writes files atomically on a worker thread so the caller never waits on the disk
+// Only the latest batch is kept, a batch that the worker hasn't picked up yet is replaced by the next one
+class BackgroundFileWriter
+{
+public:
+	struct File
+	{
+		std::string Path;
+		std::string Data;
+	};
+
+	BackgroundFileWriter();
+	~BackgroundFileWriter();
+
+	BackgroundFileWriter(const BackgroundFileWriter&) = delete;
+	BackgroundFileWriter& operator=(const BackgroundFileWriter&) = delete;
+
+	void Write(std::vector<File>&& files);
+
+	// Blocks until every queued batch is on disk
+	void Wait();
+
+	// Returns paths that failed to write since the last call
+	std::vector<std::string> TakeFailedPaths();
+
+private:
+	void WorkerLoop();
+
+private:
+	std::mutex m_Mutex;
+	std::condition_variable m_Condition;
+
+	std::vector<File> m_PendingFiles;
+	bool m_HasPendingFiles = false;
+	bool m_Writing = false;
+	bool m_Quit = false;
+
+	std::vector<std::string> m_FailedPaths;
+
+	std::thread m_Worker;
+};
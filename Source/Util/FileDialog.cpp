@@ -70,17 +70,17 @@ namespace FileDialog
 
 	bool OpenRenderNodeFile(std::string& path)
 	{
-		return OpenFile(path, { {{ "Render node file", "rn" }} });
+		return OpenFile(path, { {{ "Render node file", "rn,rnb,rnj" }} });
 	}
 
 	bool SaveRenderNodeFile(std::string& path)
 	{
-		return SaveFile(path, { { "Render node file", "rn" } });
+		return SaveFile(path, { { "Render node file", "rn" }, { "Render node binary file", "rnb" }, { "Render node journal file", "rnj" } });
 	}
 
 	bool OpenTextureFile(std::string& path)
 	{
-		return OpenFile(path, { { "Texture file", "jpg,jpeg,png,hdr,bmp,gif,psd,pic,pnm,tga" } });
+		return OpenFile(path, { { "Texture file", "jpg,jpeg,png,hdr,bmp,gif,psd,pic,pnm,tga,dds,ktx2" } });
 	}
 
 	bool OpenShaderFile(std::string& path)
@@ -90,7 +90,7 @@ namespace FileDialog
 
 	bool OpenSceneFile(std::string& path)
 	{
-		return OpenFile(path, { { "GLTF scene", "gltf"} });
+		return OpenFile(path, { { "GLTF scene", "gltf,glb"} });
 	}
 
 }
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "FileWatcher.h"
+
+static std::filesystem::file_time_type GetWriteTime(const std::string& path)
+{
+	std::error_code error;
+	const auto writeTime = std::filesystem::last_write_time(path, error);
+	return error ? std::filesystem::file_time_type{} : writeTime;
+}
+
+void FileWatcher::Watch(const std::string& path)
+{
+	if (m_Files.find(path) != m_Files.end()) return;
+	m_Files[path] = GetWriteTime(path);
+}
+
+std::vector<std::string> FileWatcher::PollChanges()
+{
+	std::vector<std::string> changedFiles;
+	for (auto& it : m_Files)
+	{
+		const auto writeTime = GetWriteTime(it.first);
+		if (writeTime != it.second)
+		{
+			it.second = writeTime;
+			changedFiles.push_back(it.first);
+		}
+	}
+	return changedFiles;
+}
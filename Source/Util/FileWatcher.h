@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <filesystem>
+
+// Polls modification time of watched files
+// Portable replacement for native change notifications, meant to be polled few times per second
+class FileWatcher
+{
+public:
+	void Watch(const std::string& path);
+	void Clear() { m_Files.clear(); }
+
+	// Returns watched files that were modified since the last poll
+	std::vector<std::string> PollChanges();
+
+private:
+	std::unordered_map<std::string, std::filesystem::file_time_type> m_Files;
+};
@@ -2,6 +2,7 @@
 
 #include <inttypes.h>
 #include <string>
+#include <string_view>
 
 namespace Hash
 {
@@ -95,4 +96,21 @@ namespace Hash
 		static_assert(sizeof(uint8_t) == sizeof(char));
 		return Crc32(crc32, reinterpret_cast<const uint8_t*>(data.c_str()), data.size());
 	}
+
+	// 64 bit FNV-1a, used for content hashes where crc32 would collide on large documents
+	inline uint64_t Fnv1a64(const uint8_t* bytes, size_t byteSize)
+	{
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (size_t i = 0; i < byteSize; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 0x100000001b3ull;
+		}
+		return hash;
+	}
+
+	inline uint64_t Fnv1a64(std::string_view data)
+	{
+		return Fnv1a64(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+	}
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "../IDGen.h"
+
+// Flat map keyed by unique IDs, entries are kept sorted in one contiguous vector
+// IDs are only ever handed out in increasing order so inserting new objects is an append,
+// lookups are binary searches and iteration goes in ID (creation) order
+// Unlike unordered_map references to values are invalidated by insert and erase
+template<typename T>
+class IDMap
+{
+public:
+	using Entry = std::pair<UniqueID, T>;
+	using iterator = typename std::vector<Entry>::iterator;
+	using const_iterator = typename std::vector<Entry>::const_iterator;
+
+public:
+	T& operator[](UniqueID id)
+	{
+		if (m_Entries.empty() || m_Entries.back().first < id)
+		{
+			m_Entries.emplace_back(id, T{});
+			return m_Entries.back().second;
+		}
+
+		const size_t index = LowerBound(id);
+		if (index < m_Entries.size() && m_Entries[index].first == id) return m_Entries[index].second;
+		return m_Entries.emplace(m_Entries.begin() + index, id, T{})->second;
+	}
+
+	// Replaces whole content, entries don't have to be sorted and the last one wins on duplicate IDs
+	void Assign(std::vector<Entry>&& entries)
+	{
+		m_Entries = std::move(entries);
+		const auto byID = [](const Entry& a, const Entry& b) { return a.first < b.first; };
+		if (std::is_sorted(m_Entries.begin(), m_Entries.end(), byID)) return;
+
+		std::stable_sort(m_Entries.begin(), m_Entries.end(), byID);
+		size_t count = 0;
+		for (size_t i = 0; i < m_Entries.size(); i++)
+		{
+			if (count > 0 && m_Entries[count - 1].first == m_Entries[i].first) count--;
+			if (count != i) m_Entries[count] = std::move(m_Entries[i]);
+			count++;
+		}
+		m_Entries.resize(count);
+	}
+
+	iterator find(UniqueID id)
+	{
+		const size_t index = LowerBound(id);
+		return index < m_Entries.size() && m_Entries[index].first == id ? m_Entries.begin() + index : m_Entries.end();
+	}
+
+	const_iterator find(UniqueID id) const
+	{
+		const size_t index = LowerBound(id);
+		return index < m_Entries.size() && m_Entries[index].first == id ? m_Entries.begin() + index : m_Entries.end();
+	}
+
+	T& at(UniqueID id)
+	{
+		const iterator it = find(id);
+		ASSERT_M(it != m_Entries.end(), "ID not found!");
+		return it->second;
+	}
+
+	const T& at(UniqueID id) const
+	{
+		const const_iterator it = find(id);
+		ASSERT_M(it != m_Entries.end(), "ID not found!");
+		return it->second;
+	}
+
+	size_t count(UniqueID id) const { return find(id) != m_Entries.end() ? 1 : 0; }
+
+	void erase(UniqueID id)
+	{
+		const iterator it = find(id);
+		if (it != m_Entries.end()) m_Entries.erase(it);
+	}
+
+	void reserve(size_t size) { m_Entries.reserve(size); }
+	void clear() { m_Entries.clear(); }
+	size_t size() const { return m_Entries.size(); }
+	bool empty() const { return m_Entries.empty(); }
+
+	iterator begin() { return m_Entries.begin(); }
+	iterator end() { return m_Entries.end(); }
+	const_iterator begin() const { return m_Entries.begin(); }
+	const_iterator end() const { return m_Entries.end(); }
+
+private:
+	// IDs in one map are spread close to evenly, so the position is guessed from the key range first
+	// and binary search only runs on what is left after a few guesses
+	size_t LowerBound(UniqueID id) const
+	{
+		static constexpr unsigned MaxGuesses = 4;
+
+		size_t low = 0;
+		size_t high = m_Entries.size();
+		for (unsigned i = 0; i < MaxGuesses && high - low > 8; i++)
+		{
+			const UniqueID lowID = m_Entries[low].first;
+			const UniqueID highID = m_Entries[high - 1].first;
+			if (id <= lowID) return low;
+			if (id > highID) return high;
+
+			const size_t guess = low + (size_t)((uint64_t)(id - lowID) * (high - 1 - low) / (highID - lowID));
+			const UniqueID guessID = m_Entries[guess].first;
+			if (guessID == id) return guess;
+			if (guessID < id) low = guess + 1;
+			else high = guess;
+		}
+
+		const auto it = std::lower_bound(m_Entries.begin() + low, m_Entries.begin() + high, id, [](const Entry& entry, UniqueID id) { return entry.first < id; });
+		return it - m_Entries.begin();
+	}
+
+private:
+	std::vector<Entry> m_Entries;
+};
@@ -0,0 +1,49 @@
+#include "MappedFile.h"
+
+#include <windows.h>
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	// Empty files can't be mapped
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	// The view keeps the mapping alive so both handles can be closed right away
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (!mapping) return false;
+
+	m_Data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!m_Data) return false;
+
+	m_Size = (size_t)fileSize.QuadPart;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	Unmap(Release());
+}
+
+const void* MappedFile::Release()
+{
+	const void* data = m_Data;
+	m_Data = nullptr;
+	m_Size = 0;
+	return data;
+}
+
+void MappedFile::Unmap(const void* data)
+{
+	if (data) UnmapViewOfFile(data);
+}
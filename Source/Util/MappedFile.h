@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+// Read only memory mapped view of a whole file, pages are read from disk on first access
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile() { Close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const std::string& path);
+	void Close();
+
+	const void* GetData() const { return m_Data; }
+	size_t GetSize() const { return m_Size; }
+
+	// Gives up ownership of the view, it stays valid until it is passed to Unmap
+	const void* Release();
+	static void Unmap(const void* data);
+
+private:
+	const void* m_Data = nullptr;
+	size_t m_Size = 0;
+};
@@ -0,0 +1,49 @@
+#version 430
+
+// Lighting.glsl is included by both stages, each stage gets its own copy
+
+#ifdef VERTEX
+
+#include "Lighting.glsl"
+
+layout (location = 0) in vec3 in_Pos;
+layout (location = 1) in vec2 in_UV;
+layout (location = 2) in vec3 in_Normal;
+
+out vec2 out_UV;
+out vec3 out_Normal;
+out float out_VertexLight;
+
+uniform mat4 Model;
+uniform mat4 View;
+uniform mat4 Projection;
+
+void main()
+{
+    gl_Position = vec4(in_Pos * 0.1, 1.0f) * Model * View * Projection;
+    out_UV = in_UV;
+    out_Normal = in_Normal;
+    out_VertexLight = GetDiffuseLight(normalize(in_Normal));
+}
+
+#endif // VERTEX
+
+#ifdef FRAGMENT
+
+#include "Lighting.glsl"
+
+out vec4 FragColor;
+
+in vec2 out_UV;
+in vec3 out_Normal;
+in float out_VertexLight;
+
+layout(binding=0) uniform sampler2D Albedo;
+
+void main()
+{
+    float light = 0.5 * (out_VertexLight + GetDiffuseLight(normalize(out_Normal)));
+    FragColor = vec4(texture(Albedo, out_UV).rgb * light, 1.0);
+} 
+
+#endif // FRAGMENT
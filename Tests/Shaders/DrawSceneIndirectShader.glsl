@@ -0,0 +1,45 @@
+#version 430
+
+struct ObjectData
+{
+    mat4 ModelTransform;
+    vec4 BoundingSphere;
+};
+
+layout(std430, binding = 0) readonly buffer Objects { ObjectData objects[]; };
+
+#ifdef VERTEX
+
+layout (location = 0) in vec3 in_Pos;
+layout (location = 1) in vec2 in_UV;
+layout (location = 2) in vec3 in_Normal;
+layout (location = 4) in uint in_ObjectIndex;
+
+out vec2 out_UV;
+out vec3 out_Normal;
+
+uniform mat4 View;
+uniform mat4 Projection;
+
+void main()
+{
+    gl_Position = vec4(in_Pos, 1.0f) * objects[in_ObjectIndex].ModelTransform * View * Projection;
+    out_UV = in_UV;
+    out_Normal = in_Normal;
+}
+
+#endif // VERTEX
+
+#ifdef FRAGMENT
+
+out vec4 FragColor;
+
+in vec2 out_UV;
+in vec3 out_Normal;
+
+void main()
+{
+    FragColor = vec4(normalize(out_Normal) * 0.5 + 0.5, 1.0);
+}
+
+#endif // FRAGMENT
@@ -0,0 +1,44 @@
+#version 430
+
+// Bind skin palette from "Get skin palette" node to buffer slot 0
+layout(std430, binding = 0) readonly buffer Palette { mat4 joints[]; };
+
+#ifdef VERTEX
+
+// Get mesh node with positions, normals and joints and weights enabled
+layout (location = 0) in vec3 in_Pos;
+layout (location = 1) in vec3 in_Normal;
+layout (location = 2) in uvec4 in_Joints;
+layout (location = 3) in vec4 in_Weights;
+
+out vec3 out_Normal;
+
+uniform mat4 View;
+uniform mat4 Projection;
+
+void main()
+{
+    // Palette is in world space so no model transform is applied
+    mat4 skin = in_Weights.x * joints[in_Joints.x] +
+                in_Weights.y * joints[in_Joints.y] +
+                in_Weights.z * joints[in_Joints.z] +
+                in_Weights.w * joints[in_Joints.w];
+
+    gl_Position = vec4(in_Pos, 1.0f) * skin * View * Projection;
+    out_Normal = (vec4(in_Normal, 0.0f) * skin).xyz;
+}
+
+#endif // VERTEX
+
+#ifdef FRAGMENT
+
+out vec4 FragColor;
+
+in vec3 out_Normal;
+
+void main()
+{
+    FragColor = vec4(normalize(out_Normal) * 0.5 + 0.5, 1.0);
+}
+
+#endif // FRAGMENT
@@ -0,0 +1,12 @@
+#ifndef LIGHTING_GLSL
+#define LIGHTING_GLSL
+
+const vec3 LightDirection = normalize(vec3(0.3, 1.0, 0.5));
+const float AmbientLight = 0.2;
+
+float GetDiffuseLight(vec3 normal)
+{
+    return AmbientLight + (1.0 - AmbientLight) * max(dot(normal, LightDirection), 0.0);
+}
+
+#endif // LIGHTING_GLSL